@@ -26,10 +26,11 @@
 #include <csearch.h>
 #include <heuristics.h>
 #include <collections/vector.h>
-#include <collections/hash-functions.h>
 
 #define BOARD_WIDTH   4
 #define BOARD_HEIGHT  4
+#define BOARD_SIZE    (BOARD_WIDTH * BOARD_HEIGHT)
+#define MAX_DEPTH     80 /* no 15-puzzle needs more than 80 moves */
 
 
 
@@ -42,13 +43,25 @@ const int GOAL_STATE[] = {
 };
 
 /*
- * A collection of all of the game board
- * states that was a possibility.
+ * A 6-6-3 partition of the tiles into disjoint patterns. The
+ * pattern database lookups of the three are added together to
+ * get the heuristic.
  */
-int** states = NULL;
+const int PATTERN_A[] = { 1, 5, 6, 9, 10, 13 };
+const int PATTERN_B[] = { 7, 8, 11, 12, 14, 15 };
+const int PATTERN_C[] = { 2, 3, 4 };
+
+/*
+ * IDA* only holds the states along the current path, so the
+ * successors of a board at depth d can be written over the
+ * next time a board at depth d is expanded. Each board keeps
+ * its depth in the slot after its last tile.
+ */
+int states[ MAX_DEPTH + 1 ][ 4 ][ BOARD_SIZE + 1 ];
+pdb_t* pattern_databases[ 3 ];
 
 static void randomize_board    ( int board[], size_t width, size_t height, bool only_solvable );
-static int* create_state       ( int *board, size_t size, size_t index, size_t move_index );
+static int* create_state       ( const int *board, size_t depth, size_t move, size_t index, size_t move_index );
 static void get_possible_moves ( const void* restrict state, successors_t* restrict p_successors );
 static void draw_board         ( int step, const int *board );
 static int  heuristic          ( const void* restrict state1, const void* restrict state2 );
@@ -59,31 +72,52 @@ static int  board_compare      ( const void* restrict state1, const void* restri
 int main( int argc, char *argv[] )
 {
 	srand( time(NULL) );
-	lc_vector_create( states, 100 );
-	astar_t* p_astar = astar_create( board_compare, lc_pointer_hash, heuristic, cost, get_possible_moves, malloc, free );
+
+	printf( "Building pattern databases...\n" );
+	pattern_databases[ 0 ] = pdb_create( BOARD_WIDTH, BOARD_HEIGHT, GOAL_STATE, PATTERN_A, sizeof(PATTERN_A) / sizeof(PATTERN_A[0]), malloc, free );
+	pattern_databases[ 1 ] = pdb_create( BOARD_WIDTH, BOARD_HEIGHT, GOAL_STATE, PATTERN_B, sizeof(PATTERN_B) / sizeof(PATTERN_B[0]), malloc, free );
+	pattern_databases[ 2 ] = pdb_create( BOARD_WIDTH, BOARD_HEIGHT, GOAL_STATE, PATTERN_C, sizeof(PATTERN_C) / sizeof(PATTERN_C[0]), malloc, free );
+
+	if( !pattern_databases[ 0 ] || !pattern_databases[ 1 ] || !pattern_databases[ 2 ] )
+	{
+		printf( "Not enough memory for the pattern databases.\n" );
+		return 1;
+	}
+
+	idastar_t* p_idastar = idastar_create( board_compare, heuristic, cost, get_possible_moves, malloc, free );
 
 	/* Produce a solvable random board */
-	int* initial_state = (int*) malloc( sizeof(int) * BOARD_WIDTH * BOARD_HEIGHT );
+	int initial_state[ BOARD_SIZE + 1 ];
 	randomize_board( initial_state, BOARD_WIDTH, BOARD_HEIGHT, true );
-	lc_vector_push( states, initial_state );
+	initial_state[ BOARD_SIZE ] = 0;
 
 
-	if( astar_find( p_astar, GOAL_STATE, initial_state ) )
+	/* The pattern databases measure the distance to GOAL_STATE, so
+	 * search towards it and print the path backwards.
+	 */
+	if( idastar_find( p_idastar, initial_state, GOAL_STATE ) )
 	{
-		int step = 0;
-		for( astar_node_t* p_node = astar_first_node( p_astar );
+		const int** path = NULL;
+		lc_vector_create( path, 64 );
+
+		for( idastar_node_t* p_node = idastar_first_node( p_idastar );
 			 p_node != NULL;
-			 p_node = astar_next_node( p_node ) )
+			 p_node = idastar_next_node( p_node ) )
 		{
-			const int* board = astar_state( p_node );
+			lc_vector_push( path, idastar_state( p_node ) );
+		}
 
-			draw_board( step, board );
+		for( int step = 0; lc_vector_size( path ) > 0; step++ )
+		{
+			draw_board( step, lc_vector_last( path ) );
 			printf("\n");
 
-			step++;
+			lc_vector_pop( path );
 		}
 
-		astar_cleanup( p_astar );
+		lc_vector_destroy( path );
+
+		idastar_cleanup( p_idastar );
 	}
 	else
 	{
@@ -92,17 +126,10 @@ int main( int argc, char *argv[] )
 		/* No solution found. */
 	}
 
-	astar_destroy( &p_astar );
-
-	/* Release memory of all the possible states. */
-	while( lc_vector_size( states ) > 0 )
-	{
-		int* state = lc_vector_last( states );
-		free( state );
-		lc_vector_pop( states );
-	}
-
-	lc_vector_destroy( states );
+	idastar_destroy( &p_idastar );
+	pdb_destroy( &pattern_databases[ 0 ] );
+	pdb_destroy( &pattern_databases[ 1 ] );
+	pdb_destroy( &pattern_databases[ 2 ] );
 	return 0;
 }
 
@@ -193,29 +220,20 @@ void randomize_board( int board[], size_t width, size_t height, bool only_solvab
 }
 
 /*
- * Create a new game board state.
+ * Create a new game board state in the slot for the
+ * given depth and move.
  */
-int* create_state( int *board, size_t size, size_t index, size_t move_index )
+int* create_state( const int *board, size_t depth, size_t move, size_t index, size_t move_index )
 {
-	static size_t number_of_states = 0;
-	int* new_board = (int*) malloc( sizeof(int) * size );
-
-	if( new_board )
-	{
-		memcpy( new_board, board, sizeof(int) * size );
-
-		int tmp = new_board[ index ];
-		new_board[ index ] = new_board[ move_index ];
-		new_board[ move_index ] = tmp;
+	int* new_board = states[ depth ][ move ];
 
-		lc_vector_push( states, new_board );
-	}
+	memcpy( new_board, board, sizeof(int) * BOARD_SIZE );
 
-	number_of_states++;
+	int tmp = new_board[ index ];
+	new_board[ index ] = new_board[ move_index ];
+	new_board[ move_index ] = tmp;
 
-	#ifdef DEBUG
-	printf( "Created New State (%ld)\n", number_of_states );
-	#endif
+	new_board[ BOARD_SIZE ] = depth;
 
 	return new_board;
 }
@@ -227,7 +245,8 @@ int* create_state( int *board, size_t size, size_t index, size_t move_index )
  */
 void get_possible_moves( const void* restrict state, successors_t* restrict p_successors )
 {
-	int* current_board = (int*) state;
+	const int* current_board = (const int*) state;
+	size_t depth = current_board[ BOARD_SIZE ] + 1;
 
 	int potential_moves[ 4 ][ 2 ] = {
 		{ -1,  0 },
@@ -236,6 +255,11 @@ void get_possible_moves( const void* restrict state, successors_t* restrict p_su
 		{  0,  1 },
 	};
 
+	if( depth > MAX_DEPTH )
+	{
+		return;
+	}
+
 	int emptyX;
 	int emptyY;
 	size_t index;
@@ -269,7 +293,7 @@ void get_possible_moves( const void* restrict state, successors_t* restrict p_su
 				/* make the move */
 				size_t move_index = BOARD_WIDTH * move_y + move_x;
 
-				int* new_state = create_state( current_board, BOARD_WIDTH * BOARD_HEIGHT, index, move_index );
+				int* new_state = create_state( current_board, depth, m, index, move_index );
 
 				successors_push( p_successors, new_state );
 			}
@@ -321,37 +345,12 @@ void draw_board( int step, const int *board )
 }
 
 /*
- * The sum of the manhattan distance of each number between
- * game boards.
+ * The sum of the 6-6-3 pattern database lookups. The databases
+ * were built for GOAL_STATE, which is always state2.
  */
 int heuristic( const void* restrict state1, const void* restrict state2 )
 {
-	int* restrict board1 = (int* restrict) state1;
-	int* restrict board2 = (int* restrict) state2;
-	int sum = 0;
-
-	for( int y1 = 0; y1 < BOARD_HEIGHT; y1++ )
-	{
-		for( int x1 = 0; x1 < BOARD_WIDTH; x1++ )
-		{
-			size_t index1 = BOARD_WIDTH * y1 + x1;
-
-			for( int y2 = 0; y2 < BOARD_HEIGHT; y2++ )
-			{
-				for( int x2 = 0; x2 < BOARD_WIDTH; x2++ )
-				{
-					size_t index2 = BOARD_WIDTH * y2 + x2;
-
-					if( board1[ index1 ] == board2[ index2 ] )
-					{
-						sum += abs( x2 - x1 ) + abs( y2 - y1 );
-					}
-				}
-			}
-		}
-	}
-
-	return sum;
+	return pdb_additive_lookup( (const pdb_t* const*) pattern_databases, 3, (const int*) state1 );
 }
 
 /*
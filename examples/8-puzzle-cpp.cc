@@ -23,7 +23,6 @@
 #include <cstdio>
 #include <ctime>
 #include <cstring>
-#include <vector>
 #include <heuristics.h>
 #include <csearch.h>
 
@@ -41,12 +40,14 @@ namespace eight_puzzle
 
 	/*
 	 * A collection of all of the game board
-	 * states that was a possibility.
+	 * states that was a possibility. Each board
+	 * is interned once, so equal boards are the
+	 * same pointer.
 	 */
-	std::vector<int *> states;
+	csearch::state_pool_t* states = NULL;
 
 	static void randomize_board    ( int board[], size_t width, size_t height, bool only_solvable );
-	static int* create_state       ( const int *board, size_t size, size_t index, size_t move_index );
+	static const int* create_state ( const int *board, size_t size, size_t index, size_t move_index );
 	static void get_possible_moves ( const void* state, csearch::successors_t* p_successors );
 	static void draw_board         ( int step, const int *board );
 	static int  heuristic          ( const void* state1, const void* state2 );
@@ -146,24 +147,20 @@ namespace eight_puzzle
 	}
 
 	/*
-	 * Create a new game board state.
+	 * Create a new game board state, or find the
+	 * one that was created before.
 	 */
-	int* create_state( const int *board, size_t size, size_t index, size_t move_index )
+	const int* create_state( const int *board, size_t size, size_t index, size_t move_index )
 	{
-		int* new_board = new int[ size ];
+		int new_board[ BOARD_WIDTH * BOARD_HEIGHT ];
 
-		if( new_board )
-		{
-			std::memcpy( new_board, board, sizeof(int) * size );
-
-			int tmp = new_board[ index ];
-			new_board[ index ] = new_board[ move_index ];
-			new_board[ move_index ] = tmp;
+		std::memcpy( new_board, board, sizeof(int) * size );
 
-			states.push_back( new_board );
-		}
+		int tmp = new_board[ index ];
+		new_board[ index ] = new_board[ move_index ];
+		new_board[ move_index ] = tmp;
 
-		return new_board;
+		return static_cast<const int*>( csearch::state_pool_intern( states, new_board ) );
 	}
 
 	/*
@@ -215,9 +212,12 @@ namespace eight_puzzle
 					/* make the move */
 					size_t move_index = BOARD_WIDTH * move_y + move_x;
 
-					int* new_state = create_state( current_board, BOARD_WIDTH * BOARD_HEIGHT, index, move_index );
+					const int* new_state = create_state( current_board, BOARD_WIDTH * BOARD_HEIGHT, index, move_index );
 
-					successors_push( p_successors, new_state );
+					if( new_state )
+					{
+						successors_push( p_successors, new_state );
+					}
 				}
 			}
 		}
@@ -332,14 +332,17 @@ namespace eight_puzzle
 int main( int argc, char *argv[] )
 {
 	std::srand( time(NULL) );
+	eight_puzzle::states = csearch::state_pool_create( sizeof(int) * eight_puzzle::BOARD_WIDTH * eight_puzzle::BOARD_HEIGHT, malloc, free );
 	csearch::astar_t* p_astar = csearch::astar_create( eight_puzzle::board_compare, eight_puzzle::pointer_hash, eight_puzzle::heuristic, eight_puzzle::cost, eight_puzzle::get_possible_moves, malloc, free );
 
 	/* Produce a solvable random board */
-	int* initial_state = new int[ eight_puzzle::BOARD_WIDTH * eight_puzzle::BOARD_HEIGHT ];
-	eight_puzzle::randomize_board( initial_state, eight_puzzle::BOARD_WIDTH, eight_puzzle::BOARD_HEIGHT, true );
-	eight_puzzle::states.push_back( initial_state );
+	int board[ eight_puzzle::BOARD_WIDTH * eight_puzzle::BOARD_HEIGHT ];
+	eight_puzzle::randomize_board( board, eight_puzzle::BOARD_WIDTH, eight_puzzle::BOARD_HEIGHT, true );
+
+	const int* goal_state    = static_cast<const int*>( csearch::state_pool_intern( eight_puzzle::states, eight_puzzle::GOAL_STATE ) );
+	const int* initial_state = static_cast<const int*>( csearch::state_pool_intern( eight_puzzle::states, board ) );
 
-	if( csearch::astar_find( p_astar, eight_puzzle::GOAL_STATE, initial_state ) )
+	if( csearch::astar_find( p_astar, goal_state, initial_state ) )
 	{
 		int step = 0;
 		for( csearch::astar_node_t* p_node = csearch::astar_first_node( p_astar );
@@ -366,12 +369,7 @@ int main( int argc, char *argv[] )
 	csearch::astar_destroy( &p_astar );
 
 	/* Release memory of all the possible states. */
-	while( eight_puzzle::states.size() > 0 )
-	{
-		int* board = eight_puzzle::states[ eight_puzzle::states.size() - 1 ];
-		delete [] board;
-		eight_puzzle::states.pop_back( );
-	}
+	csearch::state_pool_destroy( &eight_puzzle::states );
 
 	return 0;
 }
@@ -25,7 +25,6 @@
 #include <string.h>
 #include <csearch.h>
 #include <heuristics.h>
-#include <collections/vector.h>
 #include <collections/hash-functions.h>
 
 #define BOARD_WIDTH   3
@@ -40,12 +39,14 @@ const int GOAL_STATE[] = {
 
 /*
  * A collection of all of the game board
- * states that was a possibility.
+ * states that was a possibility. Each board
+ * is interned once, so equal boards are the
+ * same pointer.
  */
-int** states = NULL;
+state_pool_t* states = NULL;
 
 static void randomize_board    ( int board[], size_t width, size_t height, bool only_solvable );
-static int* create_state       ( int *board, size_t size, size_t index, size_t move_index );
+static const int* create_state ( const int *board, size_t size, size_t index, size_t move_index );
 static void get_possible_moves ( const void* restrict state, successors_t* restrict p_successors );
 static void draw_board         ( int step, const int *board );
 static int  heuristic          ( const void* restrict state1, const void* restrict state2 );
@@ -56,16 +57,18 @@ static int  board_compare      ( const void* restrict state1, const void* restri
 int main( int argc, char *argv[] )
 {
 	srand( time(NULL) );
-	lc_vector_create( states, 100 );
+	states = state_pool_create( sizeof(int) * BOARD_WIDTH * BOARD_HEIGHT, malloc, free );
 	astar_t* p_astar = astar_create( board_compare, lc_pointer_hash, heuristic, cost, get_possible_moves, malloc, free );
 
 	/* Produce a solvable random board */
-	int* initial_state = (int*) malloc( sizeof(int) * BOARD_WIDTH * BOARD_HEIGHT );
-	randomize_board( initial_state, BOARD_WIDTH, BOARD_HEIGHT, true );
-	lc_vector_push( states, initial_state );
+	int board[ BOARD_WIDTH * BOARD_HEIGHT ];
+	randomize_board( board, BOARD_WIDTH, BOARD_HEIGHT, true );
 
+	const int* goal_state    = state_pool_intern( states, GOAL_STATE );
+	const int* initial_state = state_pool_intern( states, board );
 
-	if( csearch_find( p_astar, GOAL_STATE, initial_state ) )
+
+	if( csearch_find( p_astar, goal_state, initial_state ) )
 	{
 		int step = 0;
 		for( astar_node_t* p_node = csearch_first_node( p_astar );
@@ -92,14 +95,7 @@ int main( int argc, char *argv[] )
 	csearch_destroy( &p_astar );
 
 	/* Release memory of all the possible states. */
-	while( lc_vector_size( states ) > 0 )
-	{
-		int* state = lc_vector_last( states );
-		free( state );
-		lc_vector_pop( states );
-	}
-
-	lc_vector_destroy( states );
+	state_pool_destroy( &states );
 	return 0;
 }
 
@@ -194,24 +190,20 @@ void randomize_board( int board[], size_t width, size_t height, bool only_solvab
 }
 
 /*
- * Create a new game board state.
+ * Create a new game board state, or find the
+ * one that was created before.
  */
-int* create_state( int *board, size_t size, size_t index, size_t move_index )
+const int* create_state( const int *board, size_t size, size_t index, size_t move_index )
 {
-	int* new_board = (int*) malloc( sizeof(int) * size );
+	int new_board[ BOARD_WIDTH * BOARD_HEIGHT ];
 
-	if( new_board )
-	{
-		memcpy( new_board, board, sizeof(int) * size );
+	memcpy( new_board, board, sizeof(int) * size );
 
-		int tmp = new_board[ index ];
-		new_board[ index ] = new_board[ move_index ];
-		new_board[ move_index ] = tmp;
+	int tmp = new_board[ index ];
+	new_board[ index ] = new_board[ move_index ];
+	new_board[ move_index ] = tmp;
 
-		lc_vector_push( states, new_board );
-	}
-
-	return new_board;
+	return state_pool_intern( states, new_board );
 }
 
 /*
@@ -263,9 +255,12 @@ void get_possible_moves( const void* restrict state, successors_t* restrict p_su
 				/* make the move */
 				size_t move_index = BOARD_WIDTH * move_y + move_x;
 
-				int* new_state = create_state( current_board, BOARD_WIDTH * BOARD_HEIGHT, index, move_index );
+				const int* new_state = create_state( current_board, BOARD_WIDTH * BOARD_HEIGHT, index, move_index );
 
-				successors_push( p_successors, new_state );
+				if( new_state )
+				{
+					successors_push( p_successors, new_state );
+				}
 			}
 		}
 	}
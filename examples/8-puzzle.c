@@ -25,8 +25,6 @@
 #include <string.h>
 #include <csearch.h>
 #include <heuristics.h>
-#include <collections/vector.h>
-#include <collections/hash-functions.h>
 
 #define BOARD_WIDTH   3
 #define BOARD_HEIGHT  3
@@ -38,31 +36,23 @@ const int GOAL_STATE[] = {
 	7, 8, 0
 };
 
-/*
- * A collection of all of the game board
- * states that was a possibility.
- */
-int** states;
-
 static void randomize_board    ( int board[], size_t width, size_t height, bool only_solvable );
-static int* create_state       ( int *board, size_t size, size_t index, size_t move_index );
 static void get_possible_moves ( const void* restrict state, successors_t* restrict p_successors );
 static void draw_board         ( int step, const int *board );
 static int  heuristic          ( const void* restrict state1, const void* restrict state2 );
 static int  cost               ( const void* restrict state1, const void* restrict state2 );
 static int  board_compare      ( const void* restrict state1, const void* restrict state2 );
+static size_t board_hash       ( const void* restrict state );
 
 
 int main( int argc, char *argv[] )
 {
 	srand( time(NULL) );
-	lc_vector_create( states, 100 );
-	astar_t* p_astar = astar_create( board_compare, lc_pointer_hash, heuristic, cost, get_possible_moves, malloc, free );
+	astar_t* p_astar = astar_create( board_compare, board_hash, heuristic, cost, get_possible_moves, malloc, free );
 
 	/* Produce a solvable random board */
-	int* initial_state = (int*) malloc( sizeof(int) * BOARD_WIDTH * BOARD_HEIGHT );
+	int initial_state[ BOARD_WIDTH * BOARD_HEIGHT ];
 	randomize_board( initial_state, BOARD_WIDTH, BOARD_HEIGHT, true );
-	lc_vector_push( states, initial_state );
 
 
 	if( astar_find( p_astar, GOAL_STATE, initial_state ) )
@@ -90,17 +80,6 @@ int main( int argc, char *argv[] )
 	}
 
 	astar_destroy( &p_astar );
-
-	/* Release memory of all the possible states. */
-	while( lc_vector_size( states ) > 0 )
-	{
-		int* state = lc_vector_last( states );
-
-		free( state );
-		lc_vector_pop( states );
-	}
-
-	lc_vector_destroy( states );
 	return 0;
 }
 
@@ -194,31 +173,11 @@ void randomize_board( int board[], size_t width, size_t height, bool only_solvab
 	}
 }
 
-/*
- * Create a new game board state.
- */
-int* create_state( int *board, size_t size, size_t index, size_t move_index )
-{
-	int* new_board = (int*) malloc( sizeof(int) * size );
-
-	if( new_board )
-	{
-		memcpy( new_board, board, sizeof(int) * size );
-
-		int tmp = new_board[ index ];
-		new_board[ index ] = new_board[ move_index ];
-		new_board[ move_index ] = tmp;
-
-		lc_vector_push( states, new_board );
-	}
-
-	return new_board;
-}
-
 /*
  * Given a game board state, what are all of the possible
  * game boards that can result from all of the potential
- * moves.
+ * moves. The new boards are emplaced, so the search owns
+ * them and reuses the ones it has already seen.
  */
 void get_possible_moves( const void* restrict state, successors_t* restrict p_successors )
 {
@@ -264,9 +223,14 @@ void get_possible_moves( const void* restrict state, successors_t* restrict p_su
 				/* make the move */
 				size_t move_index = BOARD_WIDTH * move_y + move_x;
 
-				int* new_state = create_state( current_board, BOARD_WIDTH * BOARD_HEIGHT, index, move_index );
+				int* new_state = successors_emplace( p_successors, sizeof(int) * BOARD_WIDTH * BOARD_HEIGHT );
 
-				successors_push( p_successors, new_state );
+				if( new_state )
+				{
+					memcpy( new_state, current_board, sizeof(int) * BOARD_WIDTH * BOARD_HEIGHT );
+					new_state[ index ]      = current_board[ move_index ];
+					new_state[ move_index ] = 0;
+				}
 			}
 		}
 	}
@@ -370,3 +334,20 @@ int board_compare( const void* restrict state1, const void* restrict state2 )
 {
 	return memcmp( state1, state2, sizeof(int) * BOARD_WIDTH * BOARD_HEIGHT );
 }
+
+/*
+ * Boards are hashed by their contents, so that a board that
+ * was reached before is found again.
+ */
+size_t board_hash( const void* restrict state )
+{
+	const int* board = state;
+	size_t hash      = 0;
+
+	for( int i = 0; i < BOARD_WIDTH * BOARD_HEIGHT; i++ )
+	{
+		hash = hash * 9 + board[ i ];
+	}
+
+	return hash;
+}
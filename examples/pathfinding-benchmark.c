@@ -0,0 +1,335 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <csearch.h>
+#include <heuristics.h>
+
+/*
+ * A headless version of the path finding demo that times
+ * A* queries on large random grids. The grid is 8-connected
+ * with a cost of 10 for straight moves and 14 for diagonal
+ * moves. Pass "-m indexed" to use the dense state ID mode
+ * instead of the hash maps, or "-m jps" to use jump point
+ * search. JPS does not cut corners and reports jump points
+ * instead of every tile, so its paths are not directly
+ * comparable with the A* ones. Pass "-o bucket" to give A*
+ * a bucket queue as its open list instead of a binary heap.
+ * Pass "-t N" to run all the A* queries as one batch on N
+ * threads; the time per query is then wall time divided by
+ * the number of queries. "-m hda" runs each query with hash
+ * distributed A* instead, on "-t" threads (4 by default).
+ */
+#define DEFAULT_GRIDWIDTH   1000
+#define DEFAULT_GRIDHEIGHT  1000
+#define DEFAULT_QUERIES     20
+#define DEFAULT_BLOCKED     20 /* percent */
+#define STRAIGHT_COST       10
+#define DIAGONAL_COST       14
+
+typedef struct tile {
+	coordinate_t position;
+	bool         is_walkable;
+} tile_t;
+
+static tile_t* tiles      = NULL;
+static int     gridWidth  = DEFAULT_GRIDWIDTH;
+static int     gridHeight = DEFAULT_GRIDHEIGHT;
+
+static void   randomize_tiles    ( unsigned int seed, int blocked );
+static tile_t* random_tile       ( void );
+static double elapsed_ms         ( const struct timespec* start, const struct timespec* end );
+static void   tile_successors8   ( const void* restrict state, successors_t* restrict p_successors );
+static int    tile_octile        ( const void* restrict t1, const void* restrict t2 );
+static int    tile_cost          ( const void* restrict t1, const void* restrict t2 );
+static int    pointer_compare    ( const void* restrict left, const void* restrict right );
+static size_t pointer_hash       ( const void* restrict state );
+static size_t tile_index         ( const void* restrict state );
+
+
+int main( int argc, char *argv[] )
+{
+	unsigned int seed = 1;
+	int queries       = DEFAULT_QUERIES;
+	int blocked       = DEFAULT_BLOCKED;
+	const char* mode  = "hashed";
+	open_list_t open_list = OPEN_LIST_BINARY_HEAP;
+	int threads       = 0;
+
+	for( int c = 1; c + 1 < argc; c += 2 )
+	{
+		if( strcmp( argv[ c ], "-gw" ) == 0 )
+			gridWidth = strtol( argv[ c + 1 ], NULL, 0 );
+		else if( strcmp( argv[ c ], "-gh" ) == 0 )
+			gridHeight = strtol( argv[ c + 1 ], NULL, 0 );
+		else if( strcmp( argv[ c ], "-q" ) == 0 )
+			queries = strtol( argv[ c + 1 ], NULL, 0 );
+		else if( strcmp( argv[ c ], "-s" ) == 0 )
+			seed = strtoul( argv[ c + 1 ], NULL, 0 );
+		else if( strcmp( argv[ c ], "-b" ) == 0 )
+			blocked = strtol( argv[ c + 1 ], NULL, 0 );
+		else if( strcmp( argv[ c ], "-m" ) == 0 )
+			mode = argv[ c + 1 ];
+		else if( strcmp( argv[ c ], "-t" ) == 0 )
+			threads = strtol( argv[ c + 1 ], NULL, 0 );
+		else if( strcmp( argv[ c ], "-o" ) == 0 )
+			open_list = strcmp( argv[ c + 1 ], "bucket" ) == 0 ? OPEN_LIST_BUCKET_QUEUE : OPEN_LIST_BINARY_HEAP;
+	}
+
+	tiles = (tile_t*) malloc( sizeof(tile_t) * gridWidth * gridHeight );
+	randomize_tiles( seed, blocked );
+
+	astar_t* p_astar        = NULL;
+	hdastar_t* p_hda        = NULL;
+	jps_t* p_jps            = NULL;
+	unsigned char* walkable = NULL;
+	const char* name;
+
+	if( strcmp( mode, "jps" ) == 0 )
+	{
+		walkable = (unsigned char*) calloc( jps_bitmap_size( (size_t) gridWidth, (size_t) gridHeight ), 1 );
+
+		for( int i = 0; i < gridWidth * gridHeight; i++ )
+		{
+			if( tiles[ i ].is_walkable ) walkable[ i >> 3 ] |= 1 << (i & 7);
+		}
+
+		jps_grid_t grid = { gridWidth, gridHeight, walkable };
+		p_jps = jps_create( &grid, malloc, free );
+		name  = "JPS";
+	}
+	else if( strcmp( mode, "hda" ) == 0 )
+	{
+		p_hda = hdastar_create( threads > 0 ? threads : 4, pointer_compare, pointer_hash, tile_octile, tile_cost, tile_successors8, malloc, free );
+		name  = "HDA*";
+	}
+	else if( strcmp( mode, "indexed" ) == 0 )
+	{
+		p_astar = astar_create_indexed_ex( open_list, gridWidth * gridHeight, tile_index, pointer_compare, tile_octile, tile_cost, tile_successors8, malloc, free );
+		name    = open_list == OPEN_LIST_BUCKET_QUEUE ? "A* (indexed, bucket queue)" : "A* (indexed)";
+	}
+	else
+	{
+		name    = open_list == OPEN_LIST_BUCKET_QUEUE ? "A* (hashed, bucket queue)" : "A* (hashed)";
+		p_astar = astar_create_ex( open_list, pointer_compare, pointer_hash, tile_octile, tile_cost, tile_successors8, malloc, free );
+	}
+
+	double total_ms = 0.0;
+	int found       = 0;
+	size_t steps    = 0;
+	int batched     = p_astar && threads > 0 ? queries : 0;
+
+	if( batched > 0 )
+	{
+		astar_query_t* batch = (astar_query_t*) calloc( queries, sizeof(astar_query_t) );
+		struct timespec start_time;
+		struct timespec end_time;
+
+		for( int q = 0; q < queries; q++ )
+		{
+			batch[ q ].start = random_tile( );
+			batch[ q ].end   = random_tile( );
+		}
+
+		clock_gettime( CLOCK_MONOTONIC, &start_time );
+		astar_find_batch( p_astar, batch, queries, threads );
+		clock_gettime( CLOCK_MONOTONIC, &end_time );
+
+		total_ms = elapsed_ms( &start_time, &end_time );
+
+		for( int q = 0; q < queries; q++ )
+		{
+			if( batch[ q ].found )
+			{
+				found++;
+				steps += batch[ q ].path_length;
+			}
+		}
+
+		free( batch );
+	}
+
+	for( int q = batched; q < queries; q++ )
+	{
+		struct timespec start_time;
+		struct timespec end_time;
+		tile_t* start = random_tile( );
+		tile_t* end   = random_tile( );
+
+		clock_gettime( CLOCK_MONOTONIC, &start_time );
+		bool is_found = p_jps ? jps_find( p_jps, start - tiles, end - tiles ) :
+		                p_hda ? hdastar_find( p_hda, start, end ) : astar_find( p_astar, start, end );
+		clock_gettime( CLOCK_MONOTONIC, &end_time );
+
+		total_ms += elapsed_ms( &start_time, &end_time );
+
+		if( is_found )
+		{
+			found++;
+			if( p_jps )
+			{
+				for( jps_node_t* p_node = jps_first_node( p_jps ); p_node; p_node = jps_next_node( p_node ) )
+				{
+					steps++;
+				}
+			}
+			else if( p_hda )
+			{
+				for( hdastar_node_t* p_node = hdastar_first_node( p_hda ); p_node; p_node = hdastar_next_node( p_node ) )
+				{
+					steps++;
+				}
+			}
+			else
+			{
+				for( astar_node_t* p_node = astar_first_node( p_astar ); p_node; p_node = astar_next_node( p_node ) )
+				{
+					steps++;
+				}
+			}
+		}
+	}
+
+	printf( "%s on %d x %d grid: %d queries, %d found, %zu path nodes, %.3f ms/query\n",
+	        name, gridWidth, gridHeight, queries, found, steps, queries > 0 ? total_ms / queries : 0.0 );
+
+	if( p_jps )
+	{
+		jps_destroy( &p_jps );
+		free( walkable );
+	}
+	else if( p_hda )
+	{
+		hdastar_destroy( &p_hda );
+	}
+	else
+	{
+		astar_destroy( &p_astar );
+	}
+	free( tiles );
+	return 0;
+}
+
+/*
+ * By default roughly 20% of the tiles are blocked, just like
+ * the interactive demo.
+ */
+void randomize_tiles( unsigned int seed, int blocked )
+{
+	srand( seed );
+
+	for( int y = 0; y < gridHeight; y++ )
+	{
+		for( int x = 0; x < gridWidth; x++ )
+		{
+			tile_t* p_tile = &tiles[ y * gridWidth + x ];
+
+			p_tile->position.x  = x;
+			p_tile->position.y  = y;
+			p_tile->is_walkable = (rand() % 1000) >= blocked * 10;
+		}
+	}
+}
+
+tile_t* random_tile( void )
+{
+	tile_t* p_tile;
+
+	do {
+		p_tile = &tiles[ rand() % (gridWidth * gridHeight) ];
+	} while( !p_tile->is_walkable );
+
+	return p_tile;
+}
+
+double elapsed_ms( const struct timespec* start, const struct timespec* end )
+{
+	return (end->tv_sec - start->tv_sec) * 1000.0 + (end->tv_nsec - start->tv_nsec) / 1000000.0;
+}
+
+void tile_successors8( const void* restrict state, successors_t* restrict p_successors )
+{
+	const tile_t* p_tile = state;
+
+	for( int j = -1; j <= 1; j++ )
+	{
+		for( int i = -1; i <= 1; i++ )
+		{
+			int successorX = p_tile->position.x + i;
+			int successorY = p_tile->position.y + j;
+
+			if( (i || j) &&
+			    successorX >= 0 && successorX < gridWidth &&
+			    successorY >= 0 && successorY < gridHeight )
+			{
+				tile_t* p_successor = &tiles[ successorY * gridWidth + successorX ];
+
+				if( p_successor->is_walkable )
+				{
+					successors_push( p_successors, p_successor );
+				}
+			}
+		}
+	}
+}
+
+int tile_octile( const void* restrict t1, const void* restrict t2 )
+{
+	const tile_t* p_tile1 = t1;
+	const tile_t* p_tile2 = t2;
+	int dx = abs( p_tile1->position.x - p_tile2->position.x );
+	int dy = abs( p_tile1->position.y - p_tile2->position.y );
+
+	return dx < dy ? DIAGONAL_COST * dx + STRAIGHT_COST * (dy - dx)
+	               : DIAGONAL_COST * dy + STRAIGHT_COST * (dx - dy);
+}
+
+int tile_cost( const void* restrict t1, const void* restrict t2 )
+{
+	const tile_t* p_tile1 = t1;
+	const tile_t* p_tile2 = t2;
+
+	return (p_tile1->position.x != p_tile2->position.x &&
+	        p_tile1->position.y != p_tile2->position.y) ? DIAGONAL_COST : STRAIGHT_COST;
+}
+
+int pointer_compare( const void* restrict left, const void* restrict right )
+{
+	return left == right ? 0 : (left < right ? -1 : 1);
+}
+
+size_t pointer_hash( const void* restrict state )
+{
+	return ((size_t) state) / sizeof(tile_t);
+}
+
+/*
+ * Tiles are stored in one array, so a tile's offset in
+ * that array is a dense state ID.
+ */
+size_t tile_index( const void* restrict state )
+{
+	return (const tile_t*) state - tiles;
+}
@@ -0,0 +1,458 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <csearch.h>
+#include <heuristics.h>
+
+/*
+ * Times Dijkstra queries on a synthetic road network. Intersections
+ * sit on a jittered grid about 100 meters apart and a few streets
+ * are missing. Every 8th street is an arterial road and every 64th
+ * is a highway, so edge costs (travel times in tenths of a second)
+ * vary a lot, like they do on real road networks.
+ *
+ * Pass "-o bucket" or "-o radix" to change the open list from the
+ * binary heap, and "-m indexed" to use the dense state ID mode
+ * instead of the hash maps. "-m bidir" runs a bidirectional
+ * Dijkstra's algorithm instead; roads go both ways, so the
+ * successors function doubles as the predecessors function.
+ * "-m alt" runs A* with a landmark heuristic built from
+ * LANDMARKS landmarks; the time to build it is printed apart.
+ * With "-f file", the landmark table is loaded from the file, or
+ * built and saved to it if the file does not match the network.
+ * "-m ch" answers the queries with a contraction hierarchy; the
+ * time to build it is printed apart too. "-m cpd" follows the first
+ * moves of a compressed path database, which runs a search from
+ * every intersection, so keep the network small; "-f file" loads or
+ * saves it like the landmark table.
+ */
+#define DEFAULT_WIDTH        700
+#define DEFAULT_HEIGHT       700
+#define DEFAULT_QUERIES      20
+#define BLOCK_LENGTH         100 /* meters */
+#define MISSING_STREETS      15  /* percent */
+#define STREET_SPEED         30  /* km/h */
+#define ARTERIAL_SPEED       60  /* km/h */
+#define HIGHWAY_SPEED        100 /* km/h */
+#define LANDMARKS            8
+
+typedef struct road {
+	unsigned int to;
+	unsigned int cost;
+} road_t;
+
+typedef struct intersection {
+	int x; /* meters */
+	int y; /* meters */
+	int degree;
+	road_t roads[ 4 ];
+} intersection_t;
+
+static intersection_t* intersections = NULL;
+static alt_t* landmarks               = NULL;
+static int width  = DEFAULT_WIDTH;
+static int height = DEFAULT_HEIGHT;
+
+static void         build_network         ( unsigned int seed );
+static double       elapsed_ms            ( const struct timespec* start, const struct timespec* end );
+static void         road_successors       ( const void* restrict state, successors_t* restrict p_successors );
+static unsigned int road_cost             ( const void* restrict i1, const void* restrict i2 );
+static int          road_signed_cost      ( const void* restrict i1, const void* restrict i2 );
+static int          landmark_heuristic    ( const void* restrict i1, const void* restrict i2 );
+static int          pointer_compare       ( const void* restrict left, const void* restrict right );
+static size_t       pointer_hash          ( const void* restrict state );
+static size_t       intersection_index    ( const void* restrict state );
+
+
+int main( int argc, char *argv[] )
+{
+	unsigned int seed     = 1;
+	int queries           = DEFAULT_QUERIES;
+	const char* mode      = "hashed";
+	const char* list_name = "binary heap";
+	const char* filename  = NULL;
+	open_list_t open_list = OPEN_LIST_BINARY_HEAP;
+
+	for( int c = 1; c + 1 < argc; c += 2 )
+	{
+		if( strcmp( argv[ c ], "-w" ) == 0 )
+			width = strtol( argv[ c + 1 ], NULL, 0 );
+		else if( strcmp( argv[ c ], "-h" ) == 0 )
+			height = strtol( argv[ c + 1 ], NULL, 0 );
+		else if( strcmp( argv[ c ], "-q" ) == 0 )
+			queries = strtol( argv[ c + 1 ], NULL, 0 );
+		else if( strcmp( argv[ c ], "-s" ) == 0 )
+			seed = strtoul( argv[ c + 1 ], NULL, 0 );
+		else if( strcmp( argv[ c ], "-m" ) == 0 )
+			mode = argv[ c + 1 ];
+		else if( strcmp( argv[ c ], "-f" ) == 0 )
+			filename = argv[ c + 1 ];
+		else if( strcmp( argv[ c ], "-o" ) == 0 )
+		{
+			if( strcmp( argv[ c + 1 ], "bucket" ) == 0 )
+			{
+				open_list = OPEN_LIST_BUCKET_QUEUE;
+				list_name = "bucket queue";
+			}
+			else if( strcmp( argv[ c + 1 ], "radix" ) == 0 )
+			{
+				open_list = OPEN_LIST_RADIX_HEAP;
+				list_name = "radix heap";
+			}
+		}
+	}
+
+	size_t count   = (size_t) width * height;
+	intersections  = (intersection_t*) malloc( sizeof(intersection_t) * count );
+	build_network( seed );
+
+	dijkstra_t* p_dijkstra = NULL;
+	bidir_t* p_bidir       = NULL;
+	astar_t* p_astar       = NULL;
+	ch_t* p_ch             = NULL;
+	cpd_t* p_cpd           = NULL;
+
+	if( strcmp( mode, "cpd" ) == 0 )
+	{
+		struct timespec start_time;
+		struct timespec end_time;
+		const void** states = (const void**) malloc( sizeof(const void*) * count );
+
+		for( size_t i = 0; i < count; i++ )
+		{
+			states[ i ] = &intersections[ i ];
+		}
+
+		clock_gettime( CLOCK_MONOTONIC, &start_time );
+		p_cpd = filename ? cpd_load( filename, count, states, intersection_index, malloc, free ) : NULL;
+
+		if( p_cpd )
+		{
+			clock_gettime( CLOCK_MONOTONIC, &end_time );
+			printf( "Loaded a compressed path database with %zu runs in %.3f ms\n", cpd_runs( p_cpd ), elapsed_ms( &start_time, &end_time ) );
+		}
+		else
+		{
+			p_cpd = cpd_create( count, states, intersection_index, pointer_compare, road_cost, road_successors, malloc, free );
+			clock_gettime( CLOCK_MONOTONIC, &end_time );
+			printf( "Built a compressed path database with %zu runs in %.3f ms\n", cpd_runs( p_cpd ), elapsed_ms( &start_time, &end_time ) );
+
+			if( filename && !cpd_save( p_cpd, filename ) )
+			{
+				printf( "Unable to save the compressed path database to %s\n", filename );
+			}
+		}
+
+		free( states );
+		list_name = "no open list";
+	}
+	else if( strcmp( mode, "ch" ) == 0 )
+	{
+		struct timespec start_time;
+		struct timespec end_time;
+		const void** states = (const void**) malloc( sizeof(const void*) * count );
+
+		for( size_t i = 0; i < count; i++ )
+		{
+			states[ i ] = &intersections[ i ];
+		}
+
+		clock_gettime( CLOCK_MONOTONIC, &start_time );
+		p_ch = ch_create( count, states, intersection_index, road_cost, road_successors, malloc, free );
+		clock_gettime( CLOCK_MONOTONIC, &end_time );
+		free( states );
+
+		printf( "Built a contraction hierarchy with %zu shortcuts in %.3f ms\n", ch_shortcuts( p_ch ), elapsed_ms( &start_time, &end_time ) );
+		list_name = "binary heaps";
+	}
+	else if( strcmp( mode, "alt" ) == 0 )
+	{
+		struct timespec start_time;
+		struct timespec end_time;
+
+		clock_gettime( CLOCK_MONOTONIC, &start_time );
+		landmarks = filename ? alt_load( filename, count, intersection_index, malloc, free ) : NULL;
+
+		if( landmarks )
+		{
+			clock_gettime( CLOCK_MONOTONIC, &end_time );
+			printf( "Loaded %zu landmarks in %.3f ms\n", alt_count( landmarks ), elapsed_ms( &start_time, &end_time ) );
+		}
+		else
+		{
+			landmarks = alt_create( LANDMARKS, &intersections[ 0 ], count, intersection_index, pointer_compare, road_cost, road_successors, malloc, free );
+			clock_gettime( CLOCK_MONOTONIC, &end_time );
+			printf( "Built %zu landmarks in %.3f ms\n", alt_count( landmarks ), elapsed_ms( &start_time, &end_time ) );
+
+			if( filename && !alt_save( landmarks, filename ) )
+			{
+				printf( "Unable to save the landmarks to %s\n", filename );
+			}
+		}
+
+		list_name = "binary heap";
+		p_astar   = astar_create_indexed( count, intersection_index, pointer_compare, landmark_heuristic, road_signed_cost, road_successors, malloc, free );
+	}
+	else if( strcmp( mode, "bidir" ) == 0 )
+	{
+		list_name = "binary heaps";
+		p_bidir   = bidir_create( pointer_compare, pointer_hash, NULL, road_signed_cost, road_successors, road_successors, malloc, free );
+	}
+	else if( strcmp( mode, "indexed" ) == 0 )
+	{
+		p_dijkstra = dijkstra_create_indexed_ex( open_list, count, intersection_index, pointer_compare, road_cost, road_successors, malloc, free );
+	}
+	else
+	{
+		mode       = "hashed";
+		p_dijkstra = dijkstra_create_ex( open_list, pointer_compare, pointer_hash, road_cost, road_successors, malloc, free );
+	}
+
+	double total_ms      = 0.0;
+	int found            = 0;
+	unsigned long total  = 0; /* sum of the path costs */
+
+	for( int q = 0; q < queries; q++ )
+	{
+		struct timespec start_time;
+		struct timespec end_time;
+		const intersection_t* start = &intersections[ rand() % count ];
+		const intersection_t* end   = &intersections[ rand() % count ];
+
+		clock_gettime( CLOCK_MONOTONIC, &start_time );
+		bool is_found = p_bidir ? bidir_find( p_bidir, start, end ) :
+		                p_astar ? astar_find( p_astar, start, end ) :
+		                p_ch    ? ch_find( p_ch, start, end ) :
+		                p_cpd   ? cpd_find( p_cpd, start, end ) :
+		                          dijkstra_find( p_dijkstra, start, end );
+		clock_gettime( CLOCK_MONOTONIC, &end_time );
+
+		total_ms += elapsed_ms( &start_time, &end_time );
+
+		if( is_found )
+		{
+			const intersection_t* previous = NULL;
+			found++;
+
+			if( p_bidir )
+			{
+				for( bidir_node_t* p_node = bidir_first_node( p_bidir ); p_node; p_node = bidir_next_node( p_node ) )
+				{
+					const intersection_t* current = bidir_state( p_node );
+					if( previous ) total += road_cost( current, previous );
+					previous = current;
+				}
+			}
+			else if( p_ch )
+			{
+				for( ch_node_t* p_node = ch_first_node( p_ch ); p_node; p_node = ch_next_node( p_node ) )
+				{
+					const intersection_t* current = ch_state( p_node );
+					if( previous ) total += road_cost( current, previous );
+					previous = current;
+				}
+			}
+			else if( p_cpd )
+			{
+				for( cpd_node_t* p_node = cpd_first_node( p_cpd ); p_node; p_node = cpd_next_node( p_node ) )
+				{
+					const intersection_t* current = cpd_state( p_node );
+					if( previous ) total += road_cost( current, previous );
+					previous = current;
+				}
+			}
+			else if( p_astar )
+			{
+				for( astar_node_t* p_node = astar_first_node( p_astar ); p_node; p_node = astar_next_node( p_node ) )
+				{
+					const intersection_t* current = astar_state( p_node );
+					if( previous ) total += road_cost( current, previous );
+					previous = current;
+				}
+			}
+			else
+			{
+				for( dijkstra_node_t* p_node = dijkstra_first_node( p_dijkstra ); p_node; p_node = dijkstra_next_node( p_node ) )
+				{
+					const intersection_t* current = dijkstra_state( p_node );
+					if( previous ) total += road_cost( current, previous );
+					previous = current;
+				}
+			}
+		}
+	}
+
+	printf( "%s (%s, %s) on %zu intersections: %d queries, %d found, %lu total cost, %.3f ms/query\n",
+	        p_astar ? "A*" : p_ch ? "CH" : p_cpd ? "CPD" : "Dijkstra", mode, list_name, count, queries, found, total, queries > 0 ? total_ms / queries : 0.0 );
+
+	if( p_bidir )
+	{
+		bidir_destroy( &p_bidir );
+	}
+	else if( p_ch )
+	{
+		ch_destroy( &p_ch );
+	}
+	else if( p_cpd )
+	{
+		cpd_destroy( &p_cpd );
+	}
+	else if( p_astar )
+	{
+		astar_destroy( &p_astar );
+		alt_destroy( &landmarks );
+	}
+	else
+	{
+		dijkstra_destroy( &p_dijkstra );
+	}
+	free( intersections );
+	return 0;
+}
+
+static int street_speed( int street )
+{
+	return street % 64 == 0 ? HIGHWAY_SPEED :
+	       street % 8 == 0  ? ARTERIAL_SPEED :
+	                          STREET_SPEED;
+}
+
+static void connect( unsigned int a, unsigned int b, int speed )
+{
+	intersection_t* p_a = &intersections[ a ];
+	intersection_t* p_b = &intersections[ b ];
+	double meters       = hypot( p_a->x - p_b->x, p_a->y - p_b->y );
+	unsigned int cost   = (unsigned int) (meters * 36.0 / speed) + 1; /* tenths of a second */
+
+	p_a->roads[ p_a->degree ].to   = b;
+	p_a->roads[ p_a->degree ].cost = cost;
+	p_a->degree++;
+	p_b->roads[ p_b->degree ].to   = a;
+	p_b->roads[ p_b->degree ].cost = cost;
+	p_b->degree++;
+}
+
+/*
+ * Arterial roads and highways are never missing, so the network
+ * stays connected through them.
+ */
+void build_network( unsigned int seed )
+{
+	srand( seed );
+
+	for( int y = 0; y < height; y++ )
+	{
+		for( int x = 0; x < width; x++ )
+		{
+			intersection_t* p_intersection = &intersections[ y * width + x ];
+
+			p_intersection->x      = x * BLOCK_LENGTH + rand() % (BLOCK_LENGTH / 2);
+			p_intersection->y      = y * BLOCK_LENGTH + rand() % (BLOCK_LENGTH / 2);
+			p_intersection->degree = 0;
+		}
+	}
+
+	for( int y = 0; y < height; y++ )
+	{
+		for( int x = 0; x < width; x++ )
+		{
+			unsigned int i = y * width + x;
+
+			/* the road east runs along street y */
+			if( x + 1 < width && (street_speed( y ) != STREET_SPEED || rand() % 100 >= MISSING_STREETS) )
+			{
+				connect( i, i + 1, street_speed( y ) );
+			}
+
+			/* the road south runs along street x */
+			if( y + 1 < height && (street_speed( x ) != STREET_SPEED || rand() % 100 >= MISSING_STREETS) )
+			{
+				connect( i, i + width, street_speed( x ) );
+			}
+		}
+	}
+}
+
+double elapsed_ms( const struct timespec* start, const struct timespec* end )
+{
+	return (end->tv_sec - start->tv_sec) * 1000.0 + (end->tv_nsec - start->tv_nsec) / 1000000.0;
+}
+
+void road_successors( const void* restrict state, successors_t* restrict p_successors )
+{
+	const intersection_t* p_intersection = state;
+
+	for( int r = 0; r < p_intersection->degree; r++ )
+	{
+		successors_push( p_successors, &intersections[ p_intersection->roads[ r ].to ] );
+	}
+}
+
+unsigned int road_cost( const void* restrict i1, const void* restrict i2 )
+{
+	const intersection_t* p_from = i1;
+	unsigned int to              = (const intersection_t*) i2 - intersections;
+
+	for( int r = 0; r < p_from->degree; r++ )
+	{
+		if( p_from->roads[ r ].to == to )
+		{
+			return p_from->roads[ r ].cost;
+		}
+	}
+
+	return 0;
+}
+
+int road_signed_cost( const void* restrict i1, const void* restrict i2 )
+{
+	return (int) road_cost( i1, i2 );
+}
+
+int landmark_heuristic( const void* restrict i1, const void* restrict i2 )
+{
+	return (int) alt_lookup( landmarks, i1, i2 );
+}
+
+int pointer_compare( const void* restrict left, const void* restrict right )
+{
+	return left == right ? 0 : (left < right ? -1 : 1);
+}
+
+size_t pointer_hash( const void* restrict state )
+{
+	return ((size_t) state) / sizeof(intersection_t);
+}
+
+/*
+ * Intersections are stored in one array, so an intersection's
+ * offset in that array is a dense state ID.
+ */
+size_t intersection_index( const void* restrict state )
+{
+	return (const intersection_t*) state - intersections;
+}
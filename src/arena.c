@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <assert.h>
+#include "arena.h"
+
+static __inline void arena_use( arena_t* __restrict p_arena, arena_chunk_t* __restrict p_chunk )
+{
+	p_arena->current = p_chunk;
+	p_arena->top     = arena_chunk_data( p_chunk );
+	p_arena->limit   = p_arena->top + p_chunk->size;
+}
+
+void arena_create( arena_t* p_arena, size_t chunk_size, alloc_fxn_t alloc, free_fxn_t free )
+{
+	assert( p_arena );
+
+	p_arena->head       = NULL;
+	p_arena->current    = NULL;
+	p_arena->top        = NULL;
+	p_arena->limit      = NULL;
+	p_arena->chunk_size = arena_align( chunk_size );
+	p_arena->alloc      = alloc;
+	p_arena->free       = free;
+}
+
+void arena_destroy( arena_t* p_arena )
+{
+	assert( p_arena );
+
+	while( p_arena->head )
+	{
+		arena_chunk_t* p_next = p_arena->head->next;
+		p_arena->free( p_arena->head );
+		p_arena->head = p_next;
+	}
+
+	p_arena->current = NULL;
+	p_arena->top     = NULL;
+	p_arena->limit   = NULL;
+}
+
+/*
+ * Slow path of arena_alloc(). Move on to the next chunk that was
+ * kept from a previous search, or allocate a new one if there is
+ * none (or it is too small for this request).
+ */
+void* arena_grow( arena_t* p_arena, size_t size )
+{
+	arena_chunk_t* p_next = p_arena->current ? p_arena->current->next : p_arena->head;
+	void* result;
+
+	size = arena_align( size );
+
+	if( !p_next || p_next->size < size )
+	{
+		size_t chunk_size      = size > p_arena->chunk_size ? size : p_arena->chunk_size;
+		arena_chunk_t* p_chunk = p_arena->alloc( arena_align(sizeof(arena_chunk_t)) + chunk_size );
+
+		if( !p_chunk )
+		{
+			return NULL;
+		}
+
+		p_chunk->size = chunk_size;
+		p_chunk->next = p_next;
+
+		if( p_arena->current )
+		{
+			p_arena->current->next = p_chunk;
+		}
+		else
+		{
+			p_arena->head = p_chunk;
+		}
+
+		p_next = p_chunk;
+	}
+
+	arena_use( p_arena, p_next );
+
+	result = p_arena->top;
+	p_arena->top += size;
+	return result;
+}
+
+/*
+ * Release everything that was allocated from the arena. The chunks
+ * themselves are kept and reused by subsequent allocations.
+ */
+void arena_reset( arena_t* p_arena ) /* O(1) */
+{
+	assert( p_arena );
+
+	if( p_arena->head )
+	{
+		arena_use( p_arena, p_arena->head );
+	}
+}
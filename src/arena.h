@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _ARENA_H_
+#define _ARENA_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include "csearch.h"
+
+/*
+ * A chunked bump allocator. Search nodes are carved out of large
+ * chunks instead of being allocated one at a time, and resetting
+ * the arena releases every node at once in O(1). Chunks are kept
+ * across resets so that repeated searches stop allocating once
+ * the arena has grown large enough.
+ */
+#define ARENA_ALIGNMENT        (2 * sizeof(void*))
+#define arena_align( size )    (((size) + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1))
+
+typedef struct arena_chunk {
+	struct arena_chunk* next;
+	size_t size; /* usable bytes in this chunk */
+} arena_chunk_t;
+
+typedef struct arena {
+	arena_chunk_t* head;    /* first chunk */
+	arena_chunk_t* current; /* chunk being allocated from */
+	unsigned char* top;     /* next free byte in the current chunk */
+	unsigned char* limit;   /* end of the current chunk */
+	size_t chunk_size;
+
+	alloc_fxn_t alloc;
+	free_fxn_t  free;
+} arena_t;
+
+void  arena_create  ( arena_t* p_arena, size_t chunk_size, alloc_fxn_t alloc, free_fxn_t free );
+void  arena_destroy ( arena_t* p_arena );
+void* arena_grow    ( arena_t* p_arena, size_t size );
+void  arena_reset   ( arena_t* p_arena ); /* O(1) */
+
+#define arena_chunk_data( p_chunk )   ((unsigned char*) (p_chunk) + arena_align(sizeof(arena_chunk_t)))
+
+static __inline void* arena_alloc( arena_t* p_arena, size_t size ) /* O(1) */
+{
+	size = arena_align( size );
+
+	if( (size_t) (p_arena->limit - p_arena->top) >= size )
+	{
+		void* result = p_arena->top;
+		p_arena->top += size;
+		return result;
+	}
+
+	return arena_grow( p_arena, size );
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _ARENA_H_ */
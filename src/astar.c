@@ -22,41 +22,84 @@
 #include <stddef.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <stdbool.h>
 #include <assert.h>
-#include <collections/binary-heap.h>
-#include <collections/hash-map.h>
-#include <collections/tree-map.h>
+#include <pthread.h>
 #include <collections/benchmark.h>
 #include "successors-private.h"
+#include "indexed-heap.h"
+#include "state-table.h"
+#include "bucket-queue.h"
+#include "arena.h"
 #include "csearch.h"
 
+enum astar_status {
+	ASTAR_UNVISITED = 0,
+	ASTAR_OPEN,
+	ASTAR_CLOSED
+};
+
 struct astar_node {
 	struct astar_node* parent;
 	int h; /* heuristic */
 	int g; /* cost */
 	int f; /* heuristic + cost */
+	int status; /* unvisited, open or closed */
+	unsigned int generation; /* search that last reached this node */
+	size_t open_index; /* position in the open list */
 	const void* state; /* vertex */
 };
 
-struct astar_algorithm {
+/*
+ * Everything that describes the problem rather than one search.
+ * It is never changed by a search, so one configuration can be
+ * shared by contexts on different threads.
+ */
+struct astar_config {
 	alloc_fxn_t alloc;
 	free_fxn_t free;
 
-	compare_fxn_t   compare;
-	heuristic_fxn_t heuristic;
-	cost_fxn_t      cost;
+	open_list_t      open_list;
+	compare_fxn_t    compare;
+	state_hash_fxn_t state_hasher;
+	heuristic_fxn_t  heuristic;
+	cost_fxn_t       cost;
 	successors_fxn_t successors_of;
+
+	/* Dense state ID mode. When state_index is set, every state
+	 * has its node at nodes[ state_index(state) ] and the state
+	 * table is not used.
+	 */
+	state_index_fxn_t state_index;
+	size_t            num_states;
+};
+
+struct astar_algorithm {
+	astar_config_t  config; /* a copy, so contexts do not depend on the original */
 	astar_node_t*   node_path;
 
+	/* Nodes are stamped with the generation of the search that
+	 * last reached them. astar_cleanup() bumps the generation,
+	 * which marks every node reached by the previous search as
+	 * unvisited, so cleanup does not depend on how large that
+	 * search was. The array only has to be cleared when the
+	 * counter wraps around.
+	 */
+	astar_node_t*     node_array; /* dense state ID mode only */
+	unsigned int      generation;
+
 	successors_t  successors;
-	astar_node_t** open_list; /* list of astar_node_t* */
-	lc_hash_map_t open_hash_map; /* (state, astar_node_t*) */
-	#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-	lc_tree_map_t closed_list; /* (state, astar_node_t*) */
-	#else
-	lc_hash_map_t closed_list; /* (state, astar_node_t*) */
-	#endif
+	arena_t       nodes; /* storage for astar_node_t */
+	indexed_heap_t open_list; /* heap of astar_node_t* */
+	bucket_queue_t open_buckets; /* astar_node_t* keyed by f */
+	state_table_t states; /* astar_node_t* of every reached state */
+
+	/* Copies of this engine for the extra threads of
+	 * astar_find_batch(). They are kept between batches.
+	 */
+	astar_t**     workers;
+	size_t        num_workers;
 
 	#ifdef DEBUG_ASTAR
 	size_t       allocations;
@@ -65,63 +108,209 @@ struct astar_algorithm {
 };
 
 
-static bool nop_keyval_fxn( void* __restrict key, void* __restrict value )
+#define default_f_compare( f1, f2 )      ((f2) - (f1))
+
+static int best_f_compare( const void* __restrict p_n1, const void* __restrict p_n2 )
 {
-	return true;
+	return default_f_compare( ((astar_node_t* __restrict)p_n1)->f, ((astar_node_t* __restrict)p_n2)->f );
 }
 
-static int astar_pointer_compare( const void* __restrict p_n1, const void* __restrict p_n2 )
+#define astar_is_indexed( p_astar )   ((p_astar)->node_array != NULL)
+#define astar_is_bucketed( p_astar )  ((p_astar)->config.open_list == OPEN_LIST_BUCKET_QUEUE)
+
+
+static bool astar_open_list_create( astar_t* p_astar )
 {
-	ptrdiff_t diff = (size_t* __restrict) p_n1 - (size_t* __restrict) p_n2;
-	return (int) diff;
+	if( astar_is_bucketed(p_astar) )
+	{
+		return bucket_queue_create( &p_astar->open_buckets, 64, offsetof(astar_node_t, open_index), p_astar->config.alloc, p_astar->config.free );
+	}
+	else
+	{
+		return indexed_heap_create( &p_astar->open_list, 128, offsetof(astar_node_t, open_index), best_f_compare, p_astar->config.alloc, p_astar->config.free );
+	}
 }
 
-#define default_f_compare( f1, f2 )      ((f2) - (f1))
+static void astar_open_list_destroy( astar_t* p_astar )
+{
+	if( astar_is_bucketed(p_astar) )
+	{
+		bucket_queue_destroy( &p_astar->open_buckets );
+	}
+	else
+	{
+		indexed_heap_destroy( &p_astar->open_list );
+	}
+}
 
-static int best_f_compare( const void* __restrict p_n1, const void* __restrict p_n2 )
+static void astar_config_init( astar_config_t* p_config, open_list_t open_list, compare_fxn_t compare, state_hash_fxn_t state_hasher, heuristic_fxn_t heuristic, cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free )
 {
-	return default_f_compare( ((astar_node_t* __restrict)p_n1)->f, ((astar_node_t* __restrict)p_n2)->f );
+	p_config->alloc         = alloc;
+	p_config->free          = free;
+	p_config->open_list     = open_list;
+	p_config->compare       = compare;
+	p_config->state_hasher  = state_hasher;
+	p_config->heuristic     = heuristic;
+	p_config->cost          = cost;
+	p_config->successors_of = successors_of;
+	p_config->state_index   = NULL;
+	p_config->num_states    = 0;
 }
 
+/*
+ * A configuration for A* searches that hash their states. Use it
+ * with astar_context_create() to give each thread its own search
+ * state. Contexts keep their own copy, so the configuration can
+ * be destroyed as soon as they are created.
+ */
+astar_config_t* astar_config_create( open_list_t open_list, compare_fxn_t compare, state_hash_fxn_t state_hasher, heuristic_fxn_t heuristic, cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free )
+{
+	astar_config_t* p_config = (astar_config_t*) alloc( sizeof(astar_config_t) );
 
-astar_t* astar_create( compare_fxn_t compare, state_hash_fxn_t state_hasher, heuristic_fxn_t heuristic, cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free )
+	if( p_config )
+	{
+		astar_config_init( p_config, open_list, compare, state_hasher, heuristic, cost, successors_of, alloc, free );
+	}
+
+	return p_config;
+}
+
+/*
+ * A configuration for A* searches over a dense state space where
+ * every state maps to a unique ID in [0, num_states).
+ */
+astar_config_t* astar_config_create_indexed( open_list_t open_list, size_t num_states, state_index_fxn_t state_index, compare_fxn_t compare, heuristic_fxn_t heuristic, cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free )
+{
+	astar_config_t* p_config;
+	assert( num_states > 0 );
+	assert( state_index );
+
+	p_config = astar_config_create( open_list, compare, NULL, heuristic, cost, successors_of, alloc, free );
+
+	if( p_config )
+	{
+		p_config->state_index = state_index;
+		p_config->num_states  = num_states;
+	}
+
+	return p_config;
+}
+
+void astar_config_destroy( astar_config_t** p_config )
+{
+	if( p_config && *p_config )
+	{
+		free_fxn_t _free = (*p_config)->free;
+		_free( *p_config );
+		*p_config = NULL;
+	}
+}
+
+/*
+ * Create the search state for one thread. Contexts created from
+ * the same configuration share nothing that a search modifies, so
+ * each one can search on its own thread without locking. A context
+ * is an astar_t; search with astar_find() and release it with
+ * astar_destroy().
+ */
+astar_context_t* astar_context_create( const astar_config_t* p_config )
 {
-	astar_t* p_astar = (astar_t*) alloc( sizeof(astar_t) );
+	astar_t* p_astar;
+	assert( p_config );
+
+	p_astar = (astar_t*) p_config->alloc( sizeof(astar_t) );
 
 	if( p_astar )
 	{
-		p_astar->alloc         = alloc;
-		p_astar->free          = free;
-		p_astar->compare       = compare;
-		p_astar->heuristic     = heuristic;
-		p_astar->cost          = cost;
-		p_astar->successors_of = successors_of;
-		p_astar->open_list     = NULL;
+		p_astar->config        = *p_config;
 		p_astar->node_path     = NULL;
+		p_astar->node_array    = NULL;
+		p_astar->generation    = 1;
+		p_astar->workers       = NULL;
+		p_astar->num_workers   = 0;
 		#ifdef DEBUG_ASTAR
 		p_astar->allocations   = 0;
 		p_astar->bm            = bench_mark_create( "A* Search Algorithm" );
 		#endif
 
-		successors_create( &p_astar->successors, 8, alloc, free );
+		arena_create( &p_astar->nodes, sizeof(astar_node_t) * 1024, p_config->alloc, p_config->free );
+
+		if( successors_create( &p_astar->successors, 8, p_config->alloc, p_config->free ) )
+		{
+			if( astar_open_list_create( p_astar ) )
+			{
+				if( p_config->state_index )
+				{
+					p_astar->node_array = (astar_node_t*) p_config->alloc( sizeof(astar_node_t) * p_config->num_states );
 
+					if( p_astar->node_array )
+					{
+						memset( p_astar->node_array, 0, sizeof(astar_node_t) * p_config->num_states );
+						return p_astar;
+					}
+				}
+				else if( state_table_create( &p_astar->states, STATE_TABLE_DEFAULT_CAPACITY, offsetof(astar_node_t, state), p_config->state_hasher, p_config->compare, p_config->alloc, p_config->free ) )
+				{
+					return p_astar;
+				}
 
-		lc_binary_heap_create(p_astar->open_list, 128);
+				astar_open_list_destroy( p_astar );
+			}
 
-		lc_hash_map_create( &p_astar->open_hash_map, LC_HASH_MAP_SIZE_MEDIUM,
-						 state_hasher, nop_keyval_fxn, astar_pointer_compare,
-						 alloc, free );
+			successors_destroy( &p_astar->successors );
+		}
 
-		#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-		lc_tree_map_create( &p_astar->closed_list, nop_keyval_fxn, astar_pointer_compare, alloc, free );
-		#else
-		lc_hash_map_create( &p_astar->closed_list, LC_HASH_MAP_SIZE_MEDIUM,
-						 state_hasher, nop_keyval_fxn, astar_pointer_compare,
-						 alloc, free );
+		#ifdef DEBUG_ASTAR
+		bench_mark_destroy( p_astar->bm );
 		#endif
+		p_config->free( p_astar );
 	}
 
-	return p_astar;
+	return NULL;
+}
+
+astar_t* astar_create( compare_fxn_t compare, state_hash_fxn_t state_hasher, heuristic_fxn_t heuristic, cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free )
+{
+	return astar_create_ex( OPEN_LIST_BINARY_HEAP, compare, state_hasher, heuristic, cost, successors_of, alloc, free );
+}
+
+/*
+ * Same as astar_create() but with a choice of open list.
+ */
+astar_t* astar_create_ex( open_list_t open_list, compare_fxn_t compare, state_hash_fxn_t state_hasher, heuristic_fxn_t heuristic, cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free )
+{
+	astar_config_t config;
+
+	astar_config_init( &config, open_list, compare, state_hasher, heuristic, cost, successors_of, alloc, free );
+
+	return astar_context_create( &config );
+}
+
+/*
+ * Create an A* search over a dense state space where every state
+ * maps to a unique ID in [0, num_states). Nodes live in a flat
+ * array indexed by state ID, so looking up a state is a single
+ * array access instead of a hash map lookup.
+ */
+astar_t* astar_create_indexed( size_t num_states, state_index_fxn_t state_index, compare_fxn_t compare, heuristic_fxn_t heuristic, cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free )
+{
+	return astar_create_indexed_ex( OPEN_LIST_BINARY_HEAP, num_states, state_index, compare, heuristic, cost, successors_of, alloc, free );
+}
+
+/*
+ * Same as astar_create_indexed() but with a choice of open list.
+ */
+astar_t* astar_create_indexed_ex( open_list_t open_list, size_t num_states, state_index_fxn_t state_index, compare_fxn_t compare, heuristic_fxn_t heuristic, cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free )
+{
+	astar_config_t config;
+	assert( num_states > 0 );
+	assert( state_index );
+
+	astar_config_init( &config, open_list, compare, NULL, heuristic, cost, successors_of, alloc, free );
+	config.state_index = state_index;
+	config.num_states  = num_states;
+
+	return astar_context_create( &config );
 }
 
 void astar_destroy( astar_t** p_astar )
@@ -132,16 +321,30 @@ void astar_destroy( astar_t** p_astar )
 		bench_mark_destroy( (*p_astar)->bm );
 		#endif
 
+		while( (*p_astar)->num_workers > 0 )
+		{
+			astar_destroy( &(*p_astar)->workers[ --(*p_astar)->num_workers ] );
+		}
+		if( (*p_astar)->workers )
+		{
+			(*p_astar)->config.free( (*p_astar)->workers );
+		}
+
 		astar_cleanup( *p_astar );
+		arena_destroy( &(*p_astar)->nodes );
 		successors_destroy( &(*p_astar)->successors );
-		lc_binary_heap_destroy( (*p_astar)->open_list );
-		lc_hash_map_destroy( &(*p_astar)->open_hash_map );
-		#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-		lc_tree_map_destroy( &(*p_astar)->closed_list );
-		#else
-		lc_hash_map_destroy( &(*p_astar)->closed_list );
-		#endif
-		free_fxn_t _free = (*p_astar)->free;
+		astar_open_list_destroy( *p_astar );
+
+		if( astar_is_indexed(*p_astar) )
+		{
+			(*p_astar)->config.free( (*p_astar)->node_array );
+		}
+		else
+		{
+			state_table_destroy( &(*p_astar)->states );
+		}
+
+		free_fxn_t _free = (*p_astar)->config.free;
 		_free( *p_astar );
 		*p_astar = NULL;
 
@@ -153,7 +356,12 @@ void astar_set_compare_fxn( astar_t* p_astar, compare_fxn_t compare )
 	if( p_astar )
 	{
 		assert( compare );
-		p_astar->compare = compare;
+		p_astar->config.compare = compare;
+
+		if( !astar_is_indexed(p_astar) )
+		{
+			p_astar->states.compare = compare;
+		}
 	}
 }
 
@@ -162,7 +370,7 @@ void astar_set_heuristic_fxn( astar_t* p_astar, heuristic_fxn_t heuristic )
 	if( p_astar )
 	{
 		assert( heuristic );
-		p_astar->heuristic = heuristic;
+		p_astar->config.heuristic = heuristic;
 	}
 }
 
@@ -171,7 +379,7 @@ void astar_set_cost_fxn( astar_t* p_astar, cost_fxn_t cost )
 	if( p_astar )
 	{
 		assert( cost );
-		p_astar->cost = cost;
+		p_astar->config.cost = cost;
 	}
 }
 
@@ -180,10 +388,255 @@ void astar_set_successors_fxn( astar_t* p_astar, successors_fxn_t successors_of
 	if( p_astar )
 	{
 		assert( successors_of );
-		p_astar->successors_of = successors_of;
+		p_astar->config.successors_of = successors_of;
+	}
+}
+
+static __inline size_t astar_open_list_size( const astar_t* p_astar )
+{
+	return astar_is_bucketed(p_astar) ? bucket_queue_size(&p_astar->open_buckets) : indexed_heap_size(&p_astar->open_list);
+}
+
+static __inline bool astar_open_list_push( astar_t* __restrict p_astar, astar_node_t* __restrict p_node )
+{
+	if( astar_is_bucketed(p_astar) )
+	{
+		return bucket_queue_push( &p_astar->open_buckets, p_node, p_node->f );
+	}
+	else
+	{
+		return indexed_heap_push( &p_astar->open_list, p_node );
+	}
+}
+
+static __inline astar_node_t* astar_open_list_pop( astar_t* p_astar )
+{
+	if( astar_is_bucketed(p_astar) )
+	{
+		return (astar_node_t*) bucket_queue_pop( &p_astar->open_buckets );
+	}
+	else
+	{
+		return (astar_node_t*) indexed_heap_pop( &p_astar->open_list );
+	}
+}
+
+/*
+ * Move a node in the open list after its F-value improved from old_f.
+ * Returns false when out of memory; the node may then be missing from
+ * the open list.
+ */
+static __inline bool astar_open_list_promote( astar_t* __restrict p_astar, astar_node_t* __restrict p_node, int old_f )
+{
+	if( astar_is_bucketed(p_astar) )
+	{
+		return bucket_queue_update( &p_astar->open_buckets, p_node, old_f, p_node->f );
+	}
+	else
+	{
+		indexed_heap_promote( &p_astar->open_list, p_node );
+		return true;
+	}
+}
+
+static __inline void astar_open_list_clear( astar_t* p_astar )
+{
+	if( astar_is_bucketed(p_astar) )
+	{
+		bucket_queue_clear( &p_astar->open_buckets );
+	}
+	else
+	{
+		indexed_heap_clear( &p_astar->open_list );
+	}
+}
+
+/*
+ * Find the node of a state that has already been reached in this
+ * search, or NULL if the state has not been seen yet. Without
+ * state IDs, *p_entry is where astar_open() puts a new node, or
+ * NULL if the state table could not grow.
+ */
+static __inline astar_node_t* astar_lookup( astar_t* __restrict p_astar, const void* __restrict state, state_table_entry_t** p_entry )
+{
+	if( astar_is_indexed(p_astar) )
+	{
+		astar_node_t* p_node = &p_astar->node_array[ p_astar->config.state_index( state ) ];
+		*p_entry = NULL;
+		return p_node->generation == p_astar->generation ? p_node : NULL;
+	}
+
+	*p_entry = state_table_probe( &p_astar->states, state );
+	return *p_entry ? (astar_node_t*) (*p_entry)->node : NULL;
+}
+
+#define astar_lookup_failed( p_astar, p_entry )   (!astar_is_indexed(p_astar) && !(p_entry))
+
+/*
+ * Add a state to the open list. Returns NULL when out of memory.
+ */
+static __inline astar_node_t* astar_open( astar_t* __restrict p_astar, state_table_entry_t* __restrict p_entry, astar_node_t* __restrict parent, const void* __restrict state, int g, int h )
+{
+	astar_node_t* p_node;
+
+	if( astar_is_indexed(p_astar) )
+	{
+		p_node = &p_astar->node_array[ p_astar->config.state_index( state ) ];
+	}
+	else
+	{
+		p_node = (astar_node_t*) arena_alloc( &p_astar->nodes, sizeof(astar_node_t) );
+
+		if( !p_node )
+		{
+			return NULL;
+		}
+	}
+
+	p_node->parent = parent;
+	p_node->h      = h;
+	p_node->g      = g;
+	p_node->f      = g + h;
+	p_node->status = ASTAR_OPEN;
+	p_node->generation = p_astar->generation;
+	p_node->state  = state;
+
+	if( !astar_is_indexed(p_astar) )
+	{
+		state_table_fill( &p_astar->states, p_entry, p_node );
+	}
+
+	#ifdef DEBUG_ASTAR
+	p_astar->allocations++;
+	#endif
+	return astar_open_list_push( p_astar, p_node ) ? p_node : NULL;
+}
+
+static __inline void astar_close( astar_t* __restrict p_astar, astar_node_t* __restrict p_node )
+{
+	p_node->status = ASTAR_CLOSED;
+}
+
+/*
+ * Steps 1 and 2 of the algorithm below.
+ */
+static void astar_start( astar_t* __restrict p_astar, const void* __restrict start, const void* __restrict end )
+{
+	state_table_entry_t* p_entry;
+
+ 	/* 1.) Set the open list and closed list to be empty. */
+	astar_cleanup( p_astar );
+
+ 	/* 2.) Add the start node to the open list. */
+	astar_lookup( p_astar, start, &p_entry );
+
+	/* out of memory; the open list stays empty and nothing is found */
+	if( !astar_lookup_failed( p_astar, p_entry ) )
+	{
+		astar_open( p_astar, p_entry, NULL, start, 0 /* no cost */, p_astar->config.heuristic( start, end ) );
 	}
 }
 
+/*
+ * One iteration of step 3 of the algorithm below. Returns true
+ * when the goal node was found.
+ */
+static bool astar_step( astar_t* __restrict p_astar, const void* __restrict end )
+{
+	state_table_entry_t* p_entry;
+	bool found = false;
+	size_t i;
+
+	/* a.) Get a node from the open list, call it p_current_node. */
+	astar_node_t* p_current_node = astar_open_list_pop( p_astar );
+
+	/* b.) If p_current_node is the goal node, return true. */
+	if( p_astar->config.compare( p_current_node->state, end ) == 0 )
+	{
+		p_astar->node_path = p_current_node;
+		found = true;
+	}
+	else
+	{
+		/* c.) Get the successor nodes of p_current_node. */
+		p_astar->config.successors_of( p_current_node->state, &p_astar->successors );
+
+		/* d.) For each successor node S: */
+		for( i = 0; i < successors_size(&p_astar->successors); i++ )
+		{
+			const void* __restrict successor_state = successors_get( &p_astar->successors, i );
+			astar_node_t* p_found_node             = astar_lookup( p_astar, successor_state, &p_entry );
+
+			/* out of memory; emptying the open list ends the search */
+			if( astar_lookup_failed( p_astar, p_entry ) )
+			{
+				astar_open_list_clear( p_astar );
+				break;
+			}
+
+			/* i.) If S is in the closed list: */
+			if( p_found_node && p_found_node->status == ASTAR_CLOSED )
+			{
+				#if 1
+				successors_reclaim( &p_astar->successors, i );
+				continue;
+				#else
+				 /* If its F-value is better, then update its F-value with the
+				  * better value and move it from the closed list to the open
+				  * list (this case handles negative weights).
+				  */
+				#endif
+			}
+
+			/* ii.) If S is in open list: */
+			if( p_found_node )
+			{
+				/* If its F-value is better, then update its
+				 * F-value with the better value and sift it up the open list.
+				 */
+				int h = p_found_node->h;
+				int g = p_current_node->g + p_astar->config.cost( p_current_node->state, successor_state );
+				int f = g + h;
+
+				if( default_f_compare( f, p_found_node->f ) > 0 )
+				{
+					int old_f = p_found_node->f;
+
+					p_found_node->g      = g;
+					p_found_node->f      = f;
+					p_found_node->parent = p_current_node;
+
+					if( !astar_open_list_promote( p_astar, p_found_node, old_f ) )
+					{
+						astar_open_list_clear( p_astar );
+						break;
+					}
+				}
+
+				successors_reclaim( &p_astar->successors, i );
+			}
+			else /* iii.) If S is not in the open list, then add S to the open list. */
+			{
+				int h = p_astar->config.heuristic( successor_state, end );
+				int g = p_current_node->g + p_astar->config.cost( p_current_node->state, successor_state );
+
+				if( !astar_open( p_astar, p_entry, p_current_node, successor_state, g, h ) )
+				{
+					astar_open_list_clear( p_astar );
+					break;
+				}
+			}
+		} /* for */
+
+		successors_clear( &p_astar->successors );
+	}
+
+	/* e.) Add p_current_node to the closed list. */
+	astar_close( p_astar, p_current_node );
+
+	return found;
+}
+
 /*
  * A* Search Algorithm
  * ------------------------------------------------------------------------
@@ -205,7 +658,7 @@ void astar_set_successors_fxn( astar_t* p_astar, successors_fxn_t successors_of
  *                 weights).
  *         ii.) If S is in open list:
  *               - If its F-value is better, then update its
- *                 F-value with the better value and resort the open list.
+ *                 F-value with the better value and sift it up the open list.
  *               - Otherwise, continue (do not add S to the open list).
  *         iii.) If S is not in the open list, then add S to the open list.
  *    e.) Add N to the closed list.
@@ -216,143 +669,14 @@ bool astar_find( astar_t* __restrict p_astar, const void* __restrict start, cons
 	#ifdef DEBUG_ASTAR
 	bench_mark_start( p_astar->bm );
 	#endif
-	astar_node_t* p_node;
 	bool found = false;
-	int i;
-
- 	/* 1.) Set the open list and closed list to be empty. */
-	astar_cleanup( p_astar );
-
-	p_node         = (astar_node_t*) p_astar->alloc( sizeof(astar_node_t) );
-	p_node->parent = NULL;
-	p_node->h      = p_astar->heuristic( start, end );
-	p_node->g      = 0 /* no cost */;
-	p_node->f      = p_node->g + p_node->h;
-	p_node->state  = start;
 
-	#ifdef DEBUG_ASTAR
-	p_astar->allocations++;
-	#endif
-
- 	/* 2.) Add the start node to the open list. */
-	lc_binary_heap_push( p_astar->open_list, p_node, astar_node_t*, p_astar->compare );
-	lc_hash_map_insert( &p_astar->open_hash_map, p_node->state, p_node );
+	astar_start( p_astar, start, end );
 
  	/* 3.) While the open list is not empty, do the following: */
-	while( !found && lc_binary_heap_size(p_astar->open_list) > 0 )
+	while( !found && astar_open_list_size(p_astar) > 0 )
 	{
- 		/* a.) Get a node from the open list, call it p_current_node. */
-		astar_node_t* p_current_node = lc_binary_heap_peek( p_astar->open_list );
-		lc_binary_heap_pop( p_astar->open_list, astar_node_t*, p_astar->compare );
-		lc_hash_map_remove( &p_astar->open_hash_map, p_current_node->state );
-
-		/* b.) If p_current_node is the goal node, return true. */
-		if( p_astar->compare( p_current_node->state, end ) == 0 )
-		{
-			p_astar->node_path = p_current_node;
-			found = true;
-		}
-		else
-		{
-			/* c.) Get the successor nodes of p_current_node. */
-			p_astar->successors_of( p_current_node->state, &p_astar->successors );
-
-			/* d.) For each successor node S: */
-			for( i = 0; i < successors_size(&p_astar->successors); i++ )
-			{
-				const void* __restrict successor_state = successors_get( &p_astar->successors, i );
-
-				/* i.) If S is in the closed list: */
-				void* found_node;
-				#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-				if( lc_tree_map_find( &p_astar->closed_list, successor_state, &found_node ) )
-				#else
-				if( lc_hash_map_find( &p_astar->closed_list, successor_state, &found_node ) )
-				#endif
-				{
-					#if 1
-					continue;
-					#else
-					astar_node_t* p_found_node = (astar_node_t*) found_node;
-					 /* If its F-value is better, then update its F-value with the
- 					  * better value and move it from the closed list to the open
- 					  * list (this case handles negative weights).
-					  */
-					int h = p_astar->heuristic( p_found_node->state, end );
-					int g = p_current_node->g + p_astar->cost( p_current_node->state, successor_state );
-					int f = g + h;
-
-					if( default_f_compare( f, p_found_node->f ) < 0 )
-					{
-						p_found_node->h      = h;
-						p_found_node->g      = g;
-						p_found_node->f      = f;
-						p_found_node->parent = p_current_node;
-
-						#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-						lc_tree_map_remove( &p_astar->closed_list, successor_state );
-						#else
-						lc_hash_map_remove( &p_astar->closed_list, successor_state );
-						#endif
-
-						pbheap_push( &p_astar->open_list, p_found_node );
-						hash_map_insert( &p_astar->open_hash_map, p_found_node->state, p_found_node );
-					}
-					#endif
-				}
-
-				/* ii.) If S is in open list: */
-				if( lc_hash_map_find( &p_astar->open_hash_map, successor_state, &found_node ) )
-				{
-					astar_node_t* p_found_node = (astar_node_t*) found_node;
-					/* If its F-value is better, then update its
-					 * F-value with the better value and resort the open list.
-					 */
-					int h = p_astar->heuristic( p_found_node->state, end );
-					int g = p_current_node->g + p_astar->cost( p_current_node->state, successor_state );
-					int f = g + h;
-
-					if( default_f_compare( f, p_found_node->f ) < 0 )
-					{
-						p_found_node->h      = h;
-						p_found_node->g      = g;
-						p_found_node->f      = f;
-						p_found_node->parent = p_current_node;
-
-						lc_binary_heap_reheapify( p_astar->open_list, astar_node_t*, p_astar->compare );
-					}
-				}
-				else /* iii.) If S is not in the open list, then add S to the open list. */
-				{
-					int h = p_astar->heuristic( successor_state, end );
-					int g = p_current_node->g + p_astar->cost( p_current_node->state, successor_state );
-					int f = g + h;
-
-					astar_node_t* p_new_node = (astar_node_t*) p_astar->alloc( sizeof(astar_node_t) );
-					p_new_node->parent     = p_current_node;
-					p_new_node->h          = h;
-					p_new_node->g          = g;
-					p_new_node->f          = f;
-					p_new_node->state      = successor_state;
-
-					lc_binary_heap_push( p_astar->open_list, p_new_node, astar_node_t*, p_astar->compare );
-					lc_hash_map_insert( &p_astar->open_hash_map, p_new_node->state, p_new_node );
-
-					#ifdef DEBUG_ASTAR
-					p_astar->allocations++;
-					#endif
-				}
-			} /* for */
-
-			successors_clear( &p_astar->successors );
-		}
-
-		/* e.) Add p_current_node to the closed list. */
-		#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-		lc_tree_map_insert( &p_astar->closed_list, p_current_node->state, p_current_node );
-		#else
-		lc_hash_map_insert( &p_astar->closed_list, p_current_node->state, p_current_node );
-		#endif
+		found = astar_step( p_astar, end );
 	}
 
 	#ifdef DEBUG_ASTAR
@@ -365,55 +689,30 @@ bool astar_find( astar_t* __restrict p_astar, const void* __restrict start, cons
 
 void astar_cleanup( astar_t* p_astar )
 {
-	lc_hash_map_iterator_t open_itr;
-	#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-	lc_tree_map_iterator_t closed_itr;
-	#else
-	lc_hash_map_iterator_t closed_itr;
-	#endif
-
-	assert( lc_hash_map_size(&p_astar->open_hash_map) == lc_binary_heap_size(p_astar->open_list) );
-
 	p_astar->node_path = NULL;
-	successors_clear( &p_astar->successors );
-	lc_binary_heap_clear( p_astar->open_list );
-
-	lc_hash_map_iterator( &p_astar->open_hash_map, &open_itr );
-	// free everything on the open list.
-	while( lc_hash_map_iterator_next( &open_itr ) )
-	{
-		astar_node_t* p_node = lc_hash_map_iterator_value( &open_itr );
-		p_astar->free( p_node );
-		#ifdef DEBUG_ASTAR
-		p_astar->allocations--;
-		#endif
-	}
-	lc_hash_map_clear( &p_astar->open_hash_map );
+	successors_release_states( &p_astar->successors );
+	assert( astar_is_indexed(p_astar) || state_table_size(&p_astar->states) >= astar_open_list_size(p_astar) );
+	astar_open_list_clear( p_astar );
 
-	#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-	// free everything on the closed list.
-	for( closed_itr = lc_tree_map_begin( &p_astar->closed_list );
-	     closed_itr != lc_tree_map_end( );
-	     closed_itr = lc_tree_map_next( closed_itr ) )
+	if( astar_is_indexed(p_astar) )
 	{
-		p_astar->free( closed_itr->value );
-		#ifdef DEBUG_ASTAR
-		p_astar->allocations--;
-		#endif
+		/* see the generation field */
+		if( ++p_astar->generation == 0 )
+		{
+			memset( p_astar->node_array, 0, sizeof(astar_node_t) * p_astar->config.num_states );
+			p_astar->generation = 1;
+		}
 	}
-	lc_tree_map_clear( &p_astar->closed_list );
-	#else
-	lc_hash_map_iterator( &p_astar->closed_list, &closed_itr );
-	// free everything on the open list.
-	while( lc_hash_map_iterator_next( &closed_itr ) )
+	else
 	{
-		astar_node_t* p_node = lc_hash_map_iterator_value( &closed_itr );
-		p_astar->free( p_node );
-		#ifdef DEBUG_ASTAR
-		p_astar->allocations--;
-		#endif
+		state_table_clear( &p_astar->states );
+
+		/* release every node at once */
+		arena_reset( &p_astar->nodes );
 	}
-	lc_hash_map_clear( &p_astar->closed_list );
+
+	#ifdef DEBUG_ASTAR
+	p_astar->allocations = 0;
 	#endif
 }
 
@@ -437,162 +736,204 @@ astar_node_t* astar_next_node( const astar_node_t* p_node )
 
 void astar_iterative_init( astar_t* __restrict p_astar, const void* __restrict start, const void* __restrict end, bool* found )
 {
-	astar_node_t* p_node;
 	#ifdef DEBUG_ASTAR
 	bench_mark_start( p_astar->bm );
 	#endif
 	*found = false;
 
- 	/* 1.) Set the open list and closed list to be empty. */
-	astar_cleanup( p_astar );
+	astar_start( p_astar, start, end );
+}
 
-	p_node         = (astar_node_t*) p_astar->alloc( sizeof(astar_node_t) );
-	p_node->parent = NULL;
-	p_node->h      = p_astar->heuristic( start, end );
-	p_node->g      = 0 /* no cost */;
-	p_node->f      = p_node->g + p_node->h;
-	p_node->state  = start;
+void astar_iterative_find( astar_t* __restrict p_astar, const void* __restrict start, const void* __restrict end, bool* found )
+{
+ 	/* 3.) While the open list is not empty, do the following: */
+	if( !*found && astar_open_list_size(p_astar) > 0 )
+	{
+		*found = astar_step( p_astar, end );
+	}
 
 	#ifdef DEBUG_ASTAR
-	p_astar->allocations++;
+	if( *found )
+	{
+		bench_mark_end( p_astar->bm );
+		bench_mark_report( p_astar->bm );
+	}
 	#endif
+}
 
- 	/* 2.) Add the start node to the open list. */
-	lc_binary_heap_push( p_astar->open_list, p_node, astar_node_t*, p_astar->compare );
-	lc_hash_map_insert( &p_astar->open_hash_map, p_node->state, p_node );
+bool astar_iterative_is_done( astar_t* __restrict p_astar, bool* found )
+{
+	return *found || astar_open_list_size(p_astar) == 0;
 }
 
-void astar_iterative_find( astar_t* __restrict p_astar, const void* __restrict start, const void* __restrict end, bool* found )
+typedef struct astar_batch {
+	astar_query_t* queries;
+	size_t         count;
+	size_t         next; /* next query to claim */
+} astar_batch_t;
+
+typedef struct astar_batch_worker {
+	astar_t*       p_astar;
+	astar_batch_t* p_batch;
+	pthread_t      thread;
+} astar_batch_worker_t;
+
+/*
+ * Claim queries until none are left. Every thread takes the next
+ * unclaimed query, so a thread that draws short searches simply
+ * runs more of them.
+ */
+static void* astar_batch_run( void* p_arg )
 {
- 	/* 3.) While the open list is not empty, do the following: */
-	if( !*found && lc_binary_heap_size(p_astar->open_list) > 0 )
+	astar_batch_worker_t* p_worker = (astar_batch_worker_t*) p_arg;
+	astar_batch_t* p_batch         = p_worker->p_batch;
+	size_t q;
+
+	while( (q = __sync_fetch_and_add( &p_batch->next, 1 )) < p_batch->count )
 	{
- 		/* a.) Get a node from the open list, call it p_current_node. */
-		astar_node_t* p_current_node = lc_binary_heap_peek( p_astar->open_list );
-		lc_binary_heap_pop( p_astar->open_list, astar_node_t*, p_astar->compare );
-		lc_hash_map_remove( &p_astar->open_hash_map, p_current_node->state );
+		astar_query_t* p_query = &p_batch->queries[ q ];
+		astar_node_t* p_node;
+		size_t length = 0;
+
+		p_query->found       = astar_find( p_worker->p_astar, p_query->start, p_query->end );
+		p_query->path_length = 0;
 
-		/* b.) If p_current_node is the goal node, return true. */
-		if( p_astar->compare( p_current_node->state, end ) == 0 )
+		if( p_query->found )
 		{
-			p_astar->node_path = p_current_node;
-			*found = true;
+			for( p_node = p_worker->p_astar->node_path; p_node; p_node = p_node->parent )
+			{
+				length++;
+			}
+
+			/* the nodes run from the end back to the start */
+			p_query->path_length = length;
+
+			for( p_node = p_worker->p_astar->node_path; p_node; p_node = p_node->parent )
+			{
+				if( --length < p_query->path_capacity )
+				{
+					p_query->path[ length ] = p_node->state;
+				}
+			}
 		}
-		else
+	}
+
+	return NULL;
+}
+
+/*
+ * Run count independent queries on up to threads threads, the
+ * calling thread included. Each query's path is copied into its
+ * own buffer, so the engine's node path is not set afterwards.
+ * Returns false if fewer threads than asked for could be started;
+ * every query is still run.
+ */
+bool astar_find_batch( astar_t* __restrict p_astar, astar_query_t* __restrict queries, size_t count, size_t threads )
+{
+	astar_batch_worker_t* workers;
+	astar_batch_t batch;
+	size_t started = 0;
+	size_t i;
+
+	assert( p_astar );
+	assert( queries || count == 0 );
+
+	if( count == 0 )
+	{
+		return true;
+	}
+
+	if( threads < 1 )
+	{
+		threads = 1;
+	}
+
+	/* there is no point in more threads than queries */
+	if( threads > count )
+	{
+		threads = count;
+	}
+
+	/* the calling thread searches with p_astar itself */
+	if( p_astar->num_workers < threads - 1 )
+	{
+		astar_t** p_workers = (astar_t**) p_astar->config.alloc( sizeof(astar_t*) * (threads - 1) );
+
+		if( p_workers )
 		{
-			int i;
+			for( i = 0; i < p_astar->num_workers; i++ )
+			{
+				p_workers[ i ] = p_astar->workers[ i ];
+			}
 
-			/* c.) Get the successor nodes of p_current_node. */
-			p_astar->successors_of( p_current_node->state, &p_astar->successors );
+			if( p_astar->workers )
+			{
+				p_astar->config.free( p_astar->workers );
+			}
+			p_astar->workers = p_workers;
 
-			/* d.) For each successor node S: */
-			for( i = 0; i < successors_size(&p_astar->successors); i++ )
+			while( p_astar->num_workers < threads - 1 &&
+			       (p_astar->workers[ p_astar->num_workers ] = astar_context_create( &p_astar->config )) != NULL )
 			{
-				const void* __restrict successor_state = successors_get( &p_astar->successors, i );
+				p_astar->num_workers++;
+			}
+		}
+	}
 
-				/* i.) If S is in the closed list: */
-				void* found_node;
-				#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-				if( tree_map_find( &p_astar->closed_list, successor_state, &found_node ) )
-				#else
-				if( lc_hash_map_find( &p_astar->closed_list, successor_state, &found_node ) )
-				#endif
-				{
-					#if 1
-					return;
-					#else
-					astar_node_t* p_found_node = (astar_node_t*) found_node;
-					 /* If its F-value is better, then update its F-value with the
- 					  * better value and move it from the closed list to the open
- 					  * list (this case handles negative weights).
-					  */
-					int h = p_astar->heuristic( p_found_node->state, end );
-					int g = p_current_node->g + p_astar->cost( p_current_node->state, successor_state );
-					int f = g + h;
-
-					if( default_f_compare( f, p_found_node->f ) < 0 )
-					{
-						p_found_node->h      = h;
-						p_found_node->g      = g;
-						p_found_node->f      = f;
-						p_found_node->parent = p_current_node;
-
-						#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-						tree_map_remove( &p_astar->closed_list, successor_state );
-						#else
-						hash_map_remove( &p_astar->closed_list, successor_state );
-						#endif
-
-						pbheap_push( &p_astar->open_list, p_found_node );
-						hash_map_insert( &p_astar->open_hash_map, p_found_node->state, p_found_node );
-					}
-					#endif
-				}
+	batch.queries = queries;
+	batch.count   = count;
+	batch.next    = 0;
 
-				/* ii.) If S is in open list: */
-				if( lc_hash_map_find( &p_astar->open_hash_map, successor_state, &found_node ) )
-				{
-					astar_node_t* p_found_node = (astar_node_t*) found_node;
-					/* If its F-value is better, then update its
-					 * F-value with the better value and resort the open list.
-					 */
-					int h = p_astar->heuristic( p_found_node->state, end );
-					int g = p_current_node->g + p_astar->cost( p_current_node->state, successor_state );
-					int f = g + h;
-
-					if( default_f_compare( f, p_found_node->f ) < 0 )
-					{
-						p_found_node->h      = h;
-						p_found_node->g      = g;
-						p_found_node->f      = f;
-						p_found_node->parent = p_current_node;
+	workers = (astar_batch_worker_t*) p_astar->config.alloc( sizeof(astar_batch_worker_t) * threads );
 
-						lc_binary_heap_reheapify( p_astar->open_list, astar_node_t*, p_astar->compare );
-					}
-				}
-				else /* iii.) If S is not in the open list, then add S to the open list. */
-				{
-					int h = p_astar->heuristic( successor_state, end );
-					int g = p_current_node->g + p_astar->cost( p_current_node->state, successor_state );
-					int f = g + h;
-
-					astar_node_t* p_new_node = (astar_node_t*) p_astar->alloc( sizeof(astar_node_t) );
-					p_new_node->parent     = p_current_node;
-					p_new_node->h          = h;
-					p_new_node->g          = g;
-					p_new_node->f          = f;
-					p_new_node->state      = successor_state;
-
-					lc_binary_heap_push( p_astar->open_list, p_new_node, astar_node_t*, p_astar->compare );
-					lc_hash_map_insert( &p_astar->open_hash_map, p_new_node->state, p_new_node );
-
-					#ifdef DEBUG_ASTAR
-					p_astar->allocations++;
-					#endif
-				}
-			} /* for */
+	if( !workers )
+	{
+		/* run the whole batch on the calling thread */
+		astar_batch_worker_t worker;
+
+		worker.p_astar = p_astar;
+		worker.p_batch = &batch;
+		astar_batch_run( &worker );
+		return false;
+	}
 
-			successors_clear( &p_astar->successors );
+	for( i = 0; i < threads; i++ )
+	{
+		workers[ i ].p_astar = i == 0 ? p_astar : NULL;
+		workers[ i ].p_batch = &batch;
+	}
+
+	for( i = 1; i < threads && i - 1 < p_astar->num_workers; i++ )
+	{
+		astar_t* p_copy = p_astar->workers[ i - 1 ];
+
+		/* pick up any callbacks that were set after the copy was made */
+		p_copy->config = p_astar->config;
+
+		if( !astar_is_indexed(p_copy) )
+		{
+			p_copy->states.compare = p_astar->config.compare;
 		}
 
-		/* e.) Add p_current_node to the closed list. */
-		#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-		lc_tree_map_insert( &p_astar->closed_list, p_current_node->state, p_current_node );
-		#else
-		lc_hash_map_insert( &p_astar->closed_list, p_current_node->state, p_current_node );
-		#endif
+		workers[ i ].p_astar = p_copy;
+
+		if( pthread_create( &workers[ i ].thread, NULL, astar_batch_run, &workers[ i ] ) != 0 )
+		{
+			break;
+		}
+
+		started++;
 	}
 
-	#ifdef DEBUG_ASTAR
-	if( *found )
+	astar_batch_run( &workers[ 0 ] );
+
+	for( i = 1; i <= started; i++ )
 	{
-		bench_mark_end( p_astar->bm );
-		bench_mark_report( p_astar->bm );
+		pthread_join( workers[ i ].thread, NULL );
 	}
-	#endif
-}
 
-bool astar_iterative_is_done( astar_t* __restrict p_astar, bool* found )
-{
-	return *found || lc_binary_heap_size(p_astar->open_list) == 0;
+	p_astar->node_path = NULL;
+	p_astar->config.free( workers );
+
+	return started + 1 == threads;
 }
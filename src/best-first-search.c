@@ -23,16 +23,23 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <assert.h>
-#include <collections/binary-heap.h>
-#include <collections/hash-map.h>
-#include <collections/tree-map.h>
 #include <collections/benchmark.h>
 #include "successors-private.h"
+#include "indexed-heap.h"
+#include "state-table.h"
+#include "arena.h"
 #include "csearch.h"
 
+enum bestfs_status {
+	BESTFS_OPEN = 1,
+	BESTFS_CLOSED
+};
+
 struct bestfs_node {
 	struct bestfs_node* parent;
 	int h; /* heuristic */
+	int status; /* open or closed */
+	size_t open_index; /* position in the open list */
 	const void* state; /* vertex */
 };
 
@@ -46,13 +53,9 @@ struct bestfs_algorithm {
 	bestfs_node_t*  node_path;
 
 	successors_t   successors;
-	lc_pbheap_t    open_list; /* list of bestfs_node_t* */
-	lc_hash_map_t  open_hash_map; /* (state, bestfs_node_t*) */
-	#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-	lc_tree_map_t  closed_list; /* (state, bestfs_node_t*) */
-	#else
-	lc_hash_map_t  closed_list; /* (state, bestfs_node_t*) */
-	#endif
+	arena_t        nodes; /* storage for bestfs_node_t */
+	indexed_heap_t open_list; /* heap of bestfs_node_t* */
+	state_table_t  states; /* bestfs_node_t* of every reached state */
 
 	#ifdef DEBUG_BEST_FIRST_SEARCH
 	size_t       allocations;
@@ -60,17 +63,6 @@ struct bestfs_algorithm {
 	#endif
 };
 
-static boolean nop_keyval_fxn( void* __restrict key, void* __restrict value )
-{
-	return TRUE;
-}
-
-static int bestfs_pointer_compare( const void* __restrict p_n1, const void* __restrict p_n2 )
-{
-	ptrdiff_t diff = (size_t* __restrict) p_n1 - (size_t* __restrict) p_n2;
-	return (int) diff;
-}
-
 #define default_heuristic_compare( h1, h2 )  ((h2) - (h1))
 
 
@@ -98,26 +90,30 @@ bestfs_t* bestfs_create( compare_fxn_t compare, state_hash_fxn_t state_hasher, h
 		p_best->bm            = bench_mark_create( "Best First Search Algorithm" );
 		#endif
 
-		successors_create( &p_best->successors, 8, alloc, free );
+		arena_create( &p_best->nodes, sizeof(bestfs_node_t) * 1024, alloc, free );
 
-		pbheap_create( &p_best->open_list, 128,
-					   bestfs_heuristic_compare,
-					   alloc, free );
+		if( successors_create( &p_best->successors, 8, alloc, free ) )
+		{
+			if( indexed_heap_create( &p_best->open_list, 128, offsetof(bestfs_node_t, open_index), bestfs_heuristic_compare, alloc, free ) )
+			{
+				if( state_table_create( &p_best->states, STATE_TABLE_DEFAULT_CAPACITY, offsetof(bestfs_node_t, state), state_hasher, compare, alloc, free ) )
+				{
+					return p_best;
+				}
 
-		hash_map_create( &p_best->open_hash_map, HASH_MAP_SIZE_MEDIUM,
-						 state_hasher, nop_keyval_fxn, bestfs_pointer_compare,
-						 alloc, free );
+				indexed_heap_destroy( &p_best->open_list );
+			}
+
+			successors_destroy( &p_best->successors );
+		}
 
-		#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-		tree_map_create( &p_best->closed_list, nop_keyval_fxn, bestfs_pointer_compare, alloc, free );
-		#else
-		hash_map_create( &p_best->closed_list, HASH_MAP_SIZE_SMALL,
-						 state_hasher, nop_keyval_fxn, bestfs_pointer_compare,
-						 alloc, free );
+		#ifdef DEBUG_BEST_FIRST_SEARCH
+		bench_mark_destroy( p_best->bm );
 		#endif
+		free( p_best );
 	}
 
-	return p_best;
+	return NULL;
 }
 
 void bestfs_destroy( bestfs_t** p_best )
@@ -129,14 +125,10 @@ void bestfs_destroy( bestfs_t** p_best )
 		#endif
 
 		bestfs_cleanup( *p_best );
+		arena_destroy( &(*p_best)->nodes );
 		successors_destroy( &(*p_best)->successors );
-		pbheap_destroy( &(*p_best)->open_list );
-		hash_map_destroy( &(*p_best)->open_hash_map );
-		#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-		tree_map_destroy( &(*p_best)->closed_list );
-		#else
-		hash_map_destroy( &(*p_best)->closed_list );
-		#endif
+		indexed_heap_destroy( &(*p_best)->open_list );
+		state_table_destroy( &(*p_best)->states );
 
 		free_fxn_t _free = (*p_best)->free;
 		_free( *p_best );
@@ -151,6 +143,7 @@ void bestfs_set_compare_fxn( bestfs_t* p_best, compare_fxn_t compare )
 	{
 		assert( compare );
 		p_best->compare = compare;
+		p_best->states.compare = compare;
 	}
 }
 
@@ -172,6 +165,132 @@ void bestfs_set_successors_fxn( bestfs_t* p_best, successors_fxn_t successors_of
 	}
 }
 
+/*
+ * Add a state to the open list. Returns false when out of memory.
+ */
+static __inline bool bestfs_open( bestfs_t* __restrict p_best, state_table_entry_t* __restrict p_entry, bestfs_node_t* __restrict parent, const void* __restrict state, int h )
+{
+	bestfs_node_t* p_node = (bestfs_node_t*) arena_alloc( &p_best->nodes, sizeof(bestfs_node_t) );
+
+	if( !p_node )
+	{
+		return false;
+	}
+
+	p_node->parent = parent;
+	p_node->h      = h;
+	p_node->status = BESTFS_OPEN;
+	p_node->state  = state;
+
+	state_table_fill( &p_best->states, p_entry, p_node );
+
+	#ifdef DEBUG_BEST_FIRST_SEARCH
+	p_best->allocations++;
+	#endif
+	return indexed_heap_push( &p_best->open_list, p_node );
+}
+
+static void bestfs_start( bestfs_t* __restrict p_best, const void* __restrict start, const void* __restrict end )
+{
+	state_table_entry_t* p_entry;
+
+ 	/* 1.) Set the open list and closed list to be empty. */
+	bestfs_cleanup( p_best );
+
+ 	/* 2.) Add the start node to the open list. */
+	p_entry = state_table_probe( &p_best->states, start );
+
+	/* out of memory; the open list stays empty and nothing is found */
+	if( p_entry )
+	{
+		bestfs_open( p_best, p_entry, NULL, start, p_best->heuristic( start, end ) );
+	}
+}
+
+/*
+ * One iteration of step 3 of the algorithm below. Returns true
+ * when the goal node was found.
+ */
+static bool bestfs_step( bestfs_t* __restrict p_best, const void* __restrict end )
+{
+	bool found = false;
+	size_t i;
+
+	/* a.) Get a node from the open list, call it p_current_node. */
+	bestfs_node_t* p_current_node = indexed_heap_pop( &p_best->open_list );
+
+	/* b.) If p_current_node is the goal node, return true. */
+	if( p_best->compare( p_current_node->state, end ) == 0 )
+	{
+		p_best->node_path = p_current_node;
+		found = true;
+	}
+	else
+	{
+		/* c.) Get the successor nodes of p_current_node. */
+		p_best->successors_of( p_current_node->state, &p_best->successors );
+
+		/* d.) For each successor node S: */
+		for( i = 0; i < successors_size(&p_best->successors); i++ )
+		{
+			const void* __restrict successor_state = successors_get( &p_best->successors, i );
+			state_table_entry_t* p_entry           = state_table_probe( &p_best->states, successor_state );
+			bestfs_node_t* p_found_node;
+
+			/* out of memory; emptying the open list ends the search */
+			if( !p_entry )
+			{
+				indexed_heap_clear( &p_best->open_list );
+				break;
+			}
+
+			p_found_node = p_entry->node;
+
+			/* i.) If S is in the closed list, continue. */
+			if( p_found_node && p_found_node->status == BESTFS_CLOSED )
+			{
+				successors_reclaim( &p_best->successors, i );
+				continue;
+			}
+
+			/* ii.) If S is in open list: */
+			if( p_found_node )
+			{
+				/* If its heuristic is better, then update its
+				 * heuristic with the better value and sift it
+				 * up the open list.
+				 */
+				int h = p_best->heuristic( p_found_node->state, end );
+
+				if( default_heuristic_compare( h, p_found_node->h ) > 0 ) // TODO: Expose heuristic compare
+				{
+					p_found_node->h      = h;
+					p_found_node->parent = p_current_node;
+
+					indexed_heap_promote( &p_best->open_list, p_found_node );
+				}
+
+				successors_reclaim( &p_best->successors, i );
+			}
+			else /* iii.) If S is not in the open list, then add S to the open list. */
+			{
+				if( !bestfs_open( p_best, p_entry, p_current_node, successor_state, p_best->heuristic( successor_state, end ) ) )
+				{
+					indexed_heap_clear( &p_best->open_list );
+					break;
+				}
+			}
+		} /* for */
+
+		successors_clear( &p_best->successors );
+	}
+
+	/* e.) Add p_current_node to the closed list. */
+	p_current_node->status = BESTFS_CLOSED;
+
+	return found;
+}
+
 /*
  * Best First Search Algorithm
  * ------------------------------------------------------------------------
@@ -197,108 +316,18 @@ void bestfs_set_successors_fxn( bestfs_t* p_best, successors_fxn_t successors_of
  */
 bool bestfs_find( bestfs_t* __restrict p_best, const void* __restrict start, const void* __restrict end )
 {
-	bestfs_node_t* p_node;
 	bool found = false;
-	int i;
 
 	#ifdef DEBUG_BEST_FIRST_SEARCH
 	bench_mark_start( p_best->bm );
 	#endif
 
- 	/* 1.) Set the open list and closed list to be empty. */
-	bestfs_cleanup( p_best );
-
-	p_node         = (bestfs_node_t*) p_best->alloc( sizeof(bestfs_node_t) );
-	p_node->parent = NULL;
-	p_node->h      = p_best->heuristic( start, end );
-	p_node->state  = start;
-
-	#ifdef DEBUG_BEST_FIRST_SEARCH
-	p_best->allocations++;
-	#endif
-
- 	/* 2.) Add the start node to the open list. */
-	pbheap_push( &p_best->open_list, p_node );
-	hash_map_insert( &p_best->open_hash_map, p_node->state, p_node );
+	bestfs_start( p_best, start, end );
 
  	/* 3.) While the open list is not empty, do the following: */
-	while( !found && pbheap_size(&p_best->open_list) > 0 )
+	while( !found && indexed_heap_size(&p_best->open_list) > 0 )
 	{
- 		/* a.) Get a node from the open list, call it p_current_node. */
-		bestfs_node_t* p_current_node = pbheap_peek( &p_best->open_list );
-		pbheap_pop( &p_best->open_list );
-		hash_map_remove( &p_best->open_hash_map, p_current_node->state );
-
-		/* b.) If p_current_node is the goal node, return true. */
-		if( p_best->compare( p_current_node->state, end ) == 0 )
-		{
-			p_best->node_path = p_current_node;
-			found = true;
-		}
-		else
-		{
-			/* c.) Get the successor nodes of p_current_node. */
-			p_best->successors_of( p_current_node->state, &p_best->successors );
-
-			/* d.) For each successor node S: */
-			for( i = 0; i < successors_size(&p_best->successors); i++ )
-			{
-				const void* __restrict successor_state = successors_get( &p_best->successors, i );
-
-				/* i.) If S is in the closed list, continue. */
-				void* found_node;
-				#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-				if( tree_map_find( &p_best->closed_list, successor_state, &found_node ) )
-				#else
-				if( hash_map_find( &p_best->closed_list, successor_state, &found_node ) )
-				#endif
-				{
-					continue;
-				}
-
-				/* ii.) If S is in open list: */
-				if( hash_map_find( &p_best->open_hash_map, successor_state, &found_node ) )
-				{
-					bestfs_node_t* p_found_node = (bestfs_node_t*) found_node;
-					/* If its heuristic is better, then update its
-					 * heuristic with the better value and resort
-					 * the open list.
-					 */
-					int h = p_best->heuristic( p_found_node->state, end );
-
-					if( default_heuristic_compare( h, p_found_node->h ) < 0 ) // TODO: Expose heuristic compare
-					{
-						p_found_node->h      = h;
-						p_found_node->parent = p_current_node;
-
-						pbheap_reheapify( &p_best->open_list );
-					}
-				}
-				else /* iii.) If S is not in the open list, then add S to the open list. */
-				{
-					bestfs_node_t* p_new_node = (bestfs_node_t*) p_best->alloc( sizeof(bestfs_node_t) );
-					p_new_node->parent     = p_current_node;
-					p_new_node->h          = p_best->heuristic( successor_state, end );
-					p_new_node->state      = successor_state;
-
-					pbheap_push( &p_best->open_list, p_new_node );
-					hash_map_insert( &p_best->open_hash_map, p_new_node->state, p_new_node );
-
-					#ifdef DEBUG_BEST_FIRST_SEARCH
-					p_best->allocations++;
-					#endif
-				}
-			} /* for */
-
-			successors_clear( &p_best->successors );
-		}
-
-		/* e.) Add p_current_node to the closed list. */
-		#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-		tree_map_insert( &p_best->closed_list, p_current_node->state, p_current_node );
-		#else
-		hash_map_insert( &p_best->closed_list, p_current_node->state, p_current_node );
-		#endif
+		found = bestfs_step( p_best, end );
 	}
 
 	#ifdef DEBUG_BEST_FIRST_SEARCH
@@ -311,56 +340,18 @@ bool bestfs_find( bestfs_t* __restrict p_best, const void* __restrict start, con
 
 void bestfs_cleanup( bestfs_t* p_best )
 {
-	lc_hash_map_iterator_t open_itr;
-	#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-	lc_tree_map_iterator_t closed_itr;
-	#else
-	lc_hash_map_iterator_t closed_itr;
-	#endif
-	assert( hash_map_size(&p_best->open_hash_map) == pbheap_size(&p_best->open_list) );
+	assert( state_table_size(&p_best->states) >= indexed_heap_size(&p_best->open_list) );
 
-	successors_clear( &p_best->successors );
-	pbheap_clear( &p_best->open_list );
 	p_best->node_path = NULL;
+	successors_release_states( &p_best->successors );
+	indexed_heap_clear( &p_best->open_list );
+	state_table_clear( &p_best->states );
 
-	hash_map_iterator( &p_best->open_hash_map, &open_itr );
-	// free everything on the open list.
-	while( hash_map_iterator_next( &open_itr ) )
-	{
-		bestfs_node_t* p_node = hash_map_iterator_value( &open_itr );
-		p_best->free( p_node );
-		#ifdef DEBUG_BEST_FIRST_SEARCH
-		p_best->allocations--;
-		#endif
-	}
-	hash_map_clear( &p_best->open_hash_map );
-
-	#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-	// free everything on the closed list.
-	for( closed_itr = tree_map_begin( &p_best->closed_list );
-	     closed_itr != tree_map_end( );
-	     closed_itr = tree_map_next( closed_itr ) )
-	{
-		p_best->free( closed_itr->value );
-		#ifdef DEBUG_BEST_FIRST_SEARCH
-		p_best->allocations--;
-		#endif
-	}
-	tree_map_clear( &p_best->closed_list );
-	#else
-	hash_map_iterator( &p_best->closed_list, &closed_itr );
-	// free everything on the open list.
-	while( hash_map_iterator_next( &closed_itr ) )
-	{
-		bestfs_node_t* p_node = hash_map_iterator_value( &closed_itr );
-		p_best->free( p_node );
-		#ifdef DEBUG_BEST_FIRST_SEARCH
-		p_best->allocations--;
-		#endif
-	}
-	hash_map_clear( &p_best->closed_list );
+	/* release every node at once */
+	arena_reset( &p_best->nodes );
+	#ifdef DEBUG_BEST_FIRST_SEARCH
+	p_best->allocations = 0;
 	#endif
-
 }
 
 bestfs_node_t* bestfs_first_node( const bestfs_t* p_best )
@@ -383,111 +374,20 @@ bestfs_node_t* bestfs_next_node( const bestfs_node_t* p_node )
 
 void bestfs_iterative_init( bestfs_t* __restrict p_best, const void* __restrict start, const void* __restrict end, bool* __restrict found )
 {
-	bestfs_node_t* p_node;
 	#ifdef DEBUG_BEST_FIRST_SEARCH
 	bench_mark_start( p_best->bm );
 	#endif
 	*found = false;
 
- 	/* 1.) Set the open list and closed list to be empty. */
-	bestfs_cleanup( p_best );
-
-	p_node         = (bestfs_node_t*) p_best->alloc( sizeof(bestfs_node_t) );
-	p_node->parent = NULL;
-	p_node->h      = p_best->heuristic( start, end );
-	p_node->state  = start;
-
-	#ifdef DEBUG_BEST_FIRST_SEARCH
-	p_best->allocations++;
-	#endif
-
- 	/* 2.) Add the start node to the open list. */
-	pbheap_push( &p_best->open_list, p_node );
-	hash_map_insert( &p_best->open_hash_map, p_node->state, p_node );
+	bestfs_start( p_best, start, end );
 }
 
 void bestfs_iterative_find( bestfs_t* __restrict p_best, const void* __restrict start, const void* __restrict end, bool* __restrict found )
 {
  	/* 3.) While the open list is not empty, do the following: */
-	if( !*found && pbheap_size(&p_best->open_list) > 0 )
+	if( !*found && indexed_heap_size(&p_best->open_list) > 0 )
 	{
- 		/* a.) Get a node from the open list, call it p_current_node. */
-		bestfs_node_t* p_current_node = pbheap_peek( &p_best->open_list );
-		pbheap_pop( &p_best->open_list );
-		hash_map_remove( &p_best->open_hash_map, p_current_node->state );
-
-		/* b.) If p_current_node is the goal node, return true. */
-		if( p_best->compare( p_current_node->state, end ) == 0 )
-		{
-			p_best->node_path = p_current_node;
-			*found = true;
-		}
-		else
-		{
-			int i;
-
-			/* c.) Get the successor nodes of p_current_node. */
-			p_best->successors_of( p_current_node->state, &p_best->successors );
-
-			/* d.) For each successor node S: */
-			for( i = 0; i < successors_size(&p_best->successors); i++ )
-			{
-				const void* __restrict successor_state = successors_get( &p_best->successors, i );
-
-				/* i.) If S is in the closed list, continue. */
-				void* found_node;
-				#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-				if( tree_map_find( &p_best->closed_list, successor_state, &found_node ) )
-				#else
-				if( hash_map_find( &p_best->closed_list, successor_state, &found_node ) )
-				#endif
-				{
-					return;
-				}
-
-				/* ii.) If S is in open list: */
-				if( hash_map_find( &p_best->open_hash_map, successor_state, &found_node ) )
-				{
-					bestfs_node_t* p_found_node = (bestfs_node_t*) found_node;
-					/* If its heuristic is better, then update its
-					 * heuristic with the better value and resort
-					 * the open list.
-					 */
-					int h = p_best->heuristic( p_found_node->state, end );
-
-					if( default_heuristic_compare( h, p_found_node->h ) < 0 ) // TODO: Expose heuristic compare
-					{
-						p_found_node->h      = h;
-						p_found_node->parent = p_current_node;
-
-						pbheap_reheapify( &p_best->open_list );
-					}
-				}
-				else /* iii.) If S is not in the open list, then add S to the open list. */
-				{
-					bestfs_node_t* p_new_node = (bestfs_node_t*) p_best->alloc( sizeof(bestfs_node_t) );
-					p_new_node->parent     = p_current_node;
-					p_new_node->h          = p_best->heuristic( successor_state, end );
-					p_new_node->state      = successor_state;
-
-					pbheap_push( &p_best->open_list, p_new_node );
-					hash_map_insert( &p_best->open_hash_map, p_new_node->state, p_new_node );
-
-					#ifdef DEBUG_BEST_FIRST_SEARCH
-					p_best->allocations++;
-					#endif
-				}
-			} /* for */
-
-			successors_clear( &p_best->successors );
-		}
-
-		/* e.) Add p_current_node to the closed list. */
-		#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-		tree_map_insert( &p_best->closed_list, p_current_node->state, p_current_node );
-		#else
-		hash_map_insert( &p_best->closed_list, p_current_node->state, p_current_node );
-		#endif
+		*found = bestfs_step( p_best, end );
 	}
 
 	#ifdef DEBUG_BEST_FIRST_SEARCH
@@ -501,5 +401,5 @@ void bestfs_iterative_find( bestfs_t* __restrict p_best, const void* __restrict
 
 bool bestfs_iterative_is_done( bestfs_t* __restrict p_best, bool* __restrict found )
 {
-	return *found || pbheap_size(&p_best->open_list) == 0;
+	return *found || indexed_heap_size(&p_best->open_list) == 0;
 }
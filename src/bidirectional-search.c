@@ -0,0 +1,624 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <collections/benchmark.h>
+#include "successors-private.h"
+#include "indexed-heap.h"
+#include "state-table.h"
+#include "arena.h"
+#include "csearch.h"
+
+#define BIDIR_FORWARD    0
+#define BIDIR_BACKWARD   1
+
+enum bidir_status {
+	BIDIR_UNVISITED = 0,
+	BIDIR_OPEN,
+	BIDIR_CLOSED
+};
+
+/*
+ * Every state reached by either search has one node. The arrays
+ * are indexed by BIDIR_FORWARD and BIDIR_BACKWARD.
+ */
+struct bidir_node {
+	struct bidir_node* parent[ 2 ]; /* towards the start and towards the end */
+	struct bidir_node* next; /* path order, set once the searches meet */
+	int g[ 2 ]; /* cost from the start and cost to the end */
+	int k[ 2 ]; /* open list keys */
+	int status[ 2 ]; /* unvisited, open or closed */
+	size_t open_index[ 2 ]; /* positions in the open lists */
+	const void* state; /* vertex */
+};
+
+struct bidir_algorithm {
+	alloc_fxn_t alloc;
+	free_fxn_t  free;
+
+	compare_fxn_t    compare;
+	heuristic_fxn_t  heuristic;
+	cost_fxn_t       cost;
+	successors_fxn_t successors_of;
+	successors_fxn_t predecessors_of;
+	bidir_node_t*    node_path;
+
+	const void*    start;
+	const void*    end;
+	int            best; /* cost of the best path found so far */
+	bidir_node_t*  meeting_node; /* where that path crosses between the searches */
+	int            direction; /* search to expand next */
+
+	successors_t   successors;
+	arena_t        nodes; /* storage for bidir_node_t */
+	indexed_heap_t open_list[ 2 ]; /* heaps of bidir_node_t* */
+	state_table_t  states; /* bidir_node_t* of every reached state */
+
+	#ifdef DEBUG_BIDIR
+	size_t          expansions;
+	lc_bench_mark_t bm;
+	#endif
+};
+
+
+#define default_key_compare( k1, k2 )      ((k2) - (k1))
+
+static int best_forward_compare( const void* __restrict p_n1, const void* __restrict p_n2 )
+{
+	return default_key_compare( ((bidir_node_t* __restrict)p_n1)->k[ BIDIR_FORWARD ], ((bidir_node_t* __restrict)p_n2)->k[ BIDIR_FORWARD ] );
+}
+
+static int best_backward_compare( const void* __restrict p_n1, const void* __restrict p_n2 )
+{
+	return default_key_compare( ((bidir_node_t* __restrict)p_n1)->k[ BIDIR_BACKWARD ], ((bidir_node_t* __restrict)p_n2)->k[ BIDIR_BACKWARD ] );
+}
+
+
+bidir_t* bidir_create( compare_fxn_t compare, state_hash_fxn_t state_hasher, heuristic_fxn_t heuristic, cost_fxn_t cost, successors_fxn_t successors_of, successors_fxn_t predecessors_of, alloc_fxn_t alloc, free_fxn_t free )
+{
+	bidir_t* p_bidir = (bidir_t*) alloc( sizeof(bidir_t) );
+
+	if( p_bidir )
+	{
+		p_bidir->alloc           = alloc;
+		p_bidir->free            = free;
+		p_bidir->compare         = compare;
+		p_bidir->heuristic       = heuristic;
+		p_bidir->cost            = cost;
+		p_bidir->successors_of   = successors_of;
+		p_bidir->predecessors_of = predecessors_of;
+		p_bidir->node_path       = NULL;
+		p_bidir->start           = NULL;
+		p_bidir->end             = NULL;
+		p_bidir->best            = INT_MAX;
+		p_bidir->meeting_node    = NULL;
+		p_bidir->direction       = BIDIR_FORWARD;
+		#ifdef DEBUG_BIDIR
+		p_bidir->expansions      = 0;
+		p_bidir->bm              = bench_mark_create( "Bidirectional Search Algorithm" );
+		#endif
+
+		arena_create( &p_bidir->nodes, sizeof(bidir_node_t) * 1024, alloc, free );
+
+		if( successors_create( &p_bidir->successors, 8, alloc, free ) )
+		{
+			if( indexed_heap_create( &p_bidir->open_list[ BIDIR_FORWARD ], 128, offsetof(bidir_node_t, open_index[ BIDIR_FORWARD ]), best_forward_compare, alloc, free ) )
+			{
+				if( indexed_heap_create( &p_bidir->open_list[ BIDIR_BACKWARD ], 128, offsetof(bidir_node_t, open_index[ BIDIR_BACKWARD ]), best_backward_compare, alloc, free ) )
+				{
+					if( state_table_create( &p_bidir->states, STATE_TABLE_DEFAULT_CAPACITY, offsetof(bidir_node_t, state), state_hasher, compare, alloc, free ) )
+					{
+						return p_bidir;
+					}
+
+					indexed_heap_destroy( &p_bidir->open_list[ BIDIR_BACKWARD ] );
+				}
+
+				indexed_heap_destroy( &p_bidir->open_list[ BIDIR_FORWARD ] );
+			}
+
+			successors_destroy( &p_bidir->successors );
+		}
+
+		#ifdef DEBUG_BIDIR
+		bench_mark_destroy( p_bidir->bm );
+		#endif
+		free( p_bidir );
+	}
+
+	return NULL;
+}
+
+void bidir_destroy( bidir_t** p_bidir )
+{
+	if( p_bidir && *p_bidir )
+	{
+		#ifdef DEBUG_BIDIR
+		bench_mark_destroy( (*p_bidir)->bm );
+		#endif
+
+		bidir_cleanup( *p_bidir );
+		arena_destroy( &(*p_bidir)->nodes );
+		successors_destroy( &(*p_bidir)->successors );
+		indexed_heap_destroy( &(*p_bidir)->open_list[ BIDIR_FORWARD ] );
+		indexed_heap_destroy( &(*p_bidir)->open_list[ BIDIR_BACKWARD ] );
+		state_table_destroy( &(*p_bidir)->states );
+
+		free_fxn_t _free = (*p_bidir)->free;
+		_free( *p_bidir );
+		*p_bidir = NULL;
+	}
+}
+
+void bidir_set_compare_fxn( bidir_t* p_bidir, compare_fxn_t compare )
+{
+	if( p_bidir )
+	{
+		assert( compare );
+		p_bidir->compare = compare;
+		p_bidir->states.compare = compare;
+	}
+}
+
+void bidir_set_heuristic_fxn( bidir_t* p_bidir, heuristic_fxn_t heuristic )
+{
+	if( p_bidir )
+	{
+		p_bidir->heuristic = heuristic;
+	}
+}
+
+void bidir_set_cost_fxn( bidir_t* p_bidir, cost_fxn_t cost )
+{
+	if( p_bidir )
+	{
+		assert( cost );
+		p_bidir->cost = cost;
+	}
+}
+
+void bidir_set_successors_fxn( bidir_t* p_bidir, successors_fxn_t successors_of )
+{
+	if( p_bidir )
+	{
+		assert( successors_of );
+		p_bidir->successors_of = successors_of;
+	}
+}
+
+void bidir_set_predecessors_fxn( bidir_t* p_bidir, successors_fxn_t predecessors_of )
+{
+	if( p_bidir )
+	{
+		assert( predecessors_of );
+		p_bidir->predecessors_of = predecessors_of;
+	}
+}
+
+/*
+ * Both searches use the average of the two heuristics as their
+ * potential: the forward key is g + (h(state, end) - h(start, state)) / 2
+ * and the backward key is g + (h(start, state) - h(state, end)) / 2.
+ * With consistent heuristics this keeps every edge's reduced cost
+ * nonnegative in both directions, so a node is final once it is
+ * closed. Keys are doubled to stay in integers.
+ */
+static __inline int bidir_potential( const bidir_t* __restrict p_bidir, const void* __restrict state )
+{
+	if( !p_bidir->heuristic )
+	{
+		return 0;
+	}
+
+	return p_bidir->heuristic( state, p_bidir->end ) - p_bidir->heuristic( p_bidir->start, state );
+}
+
+/*
+ * The node of a state, created unvisited the first time the state
+ * is reached. Returns NULL when out of memory.
+ */
+static __inline bidir_node_t* bidir_node( bidir_t* __restrict p_bidir, const void* __restrict state )
+{
+	state_table_entry_t* p_entry = state_table_probe( &p_bidir->states, state );
+	bidir_node_t* p_node;
+
+	if( !p_entry )
+	{
+		return NULL;
+	}
+
+	if( p_entry->node )
+	{
+		return (bidir_node_t*) p_entry->node;
+	}
+
+	p_node = (bidir_node_t*) arena_alloc( &p_bidir->nodes, sizeof(bidir_node_t) );
+
+	if( !p_node )
+	{
+		return NULL;
+	}
+
+	memset( p_node, 0, sizeof(bidir_node_t) );
+	p_node->state = state;
+	state_table_fill( &p_bidir->states, p_entry, p_node );
+
+	return p_node;
+}
+
+static __inline void bidir_open( bidir_t* __restrict p_bidir, int direction, bidir_node_t* __restrict p_node, bidir_node_t* __restrict parent, int g )
+{
+	int potential = bidir_potential( p_bidir, p_node->state );
+
+	p_node->parent[ direction ] = parent;
+	p_node->g[ direction ]      = g;
+	p_node->k[ direction ]      = 2 * g + (direction == BIDIR_FORWARD ? potential : -potential);
+	p_node->status[ direction ] = BIDIR_OPEN;
+
+	indexed_heap_push( &p_bidir->open_list[ direction ], p_node );
+}
+
+/*
+ * A node reached by both searches joins a path from the start to
+ * the end. Keep the cheapest one.
+ */
+static __inline void bidir_meet( bidir_t* __restrict p_bidir, bidir_node_t* __restrict p_node )
+{
+	if( p_node->status[ BIDIR_FORWARD ] != BIDIR_UNVISITED &&
+	    p_node->status[ BIDIR_BACKWARD ] != BIDIR_UNVISITED &&
+	    p_node->g[ BIDIR_FORWARD ] + p_node->g[ BIDIR_BACKWARD ] < p_bidir->best )
+	{
+		p_bidir->best         = p_node->g[ BIDIR_FORWARD ] + p_node->g[ BIDIR_BACKWARD ];
+		p_bidir->meeting_node = p_node;
+	}
+}
+
+/*
+ * Link the nodes of the best path in order from the end to the
+ * start, through the meeting node.
+ */
+static void bidir_stitch( bidir_t* p_bidir )
+{
+	bidir_node_t* p_node = p_bidir->meeting_node;
+
+	while( p_node->parent[ BIDIR_BACKWARD ] )
+	{
+		p_node->parent[ BIDIR_BACKWARD ]->next = p_node;
+		p_node = p_node->parent[ BIDIR_BACKWARD ];
+	}
+
+	p_bidir->node_path = p_node;
+
+	for( p_node = p_bidir->meeting_node; p_node; p_node = p_node->parent[ BIDIR_FORWARD ] )
+	{
+		p_node->next = p_node->parent[ BIDIR_FORWARD ];
+	}
+}
+
+/*
+ * Out of memory. Emptying both open lists ends the search, and a
+ * path found so far may not be the cheapest, so none is returned.
+ */
+static void bidir_fail( bidir_t* p_bidir )
+{
+	indexed_heap_clear( &p_bidir->open_list[ BIDIR_FORWARD ] );
+	indexed_heap_clear( &p_bidir->open_list[ BIDIR_BACKWARD ] );
+	p_bidir->meeting_node = NULL;
+}
+
+/*
+ * Steps 1 and 2 of the algorithm below.
+ */
+static void bidir_start( bidir_t* __restrict p_bidir, const void* __restrict start, const void* __restrict end )
+{
+	bidir_node_t* p_start;
+	bidir_node_t* p_end;
+
+	/* 1.) Set both open lists to be empty. */
+	bidir_cleanup( p_bidir );
+	p_bidir->start = start;
+	p_bidir->end   = end;
+
+	/* 2.) Add the start node to the forward open list and the end
+	 *     node to the backward open list.
+	 */
+	p_start = bidir_node( p_bidir, start );
+	p_end   = p_start ? bidir_node( p_bidir, end ) : NULL;
+
+	if( !p_end )
+	{
+		bidir_fail( p_bidir );
+		return;
+	}
+
+	bidir_open( p_bidir, BIDIR_FORWARD, p_start, NULL, 0 );
+	bidir_open( p_bidir, BIDIR_BACKWARD, p_end, NULL, 0 );
+	bidir_meet( p_bidir, p_end );
+}
+
+/*
+ * Step 3a of the algorithm below. Returns true while a shorter
+ * path than the best one found so far may still exist.
+ */
+static bool bidir_should_continue( const bidir_t* p_bidir )
+{
+	const bidir_node_t* p_forward;
+	const bidir_node_t* p_backward;
+
+	if( indexed_heap_is_empty(&p_bidir->open_list[ BIDIR_FORWARD ]) ||
+	    indexed_heap_is_empty(&p_bidir->open_list[ BIDIR_BACKWARD ]) )
+	{
+		return false;
+	}
+
+	if( p_bidir->best == INT_MAX )
+	{
+		return true;
+	}
+
+	p_forward  = indexed_heap_peek( &p_bidir->open_list[ BIDIR_FORWARD ] );
+	p_backward = indexed_heap_peek( &p_bidir->open_list[ BIDIR_BACKWARD ] );
+
+	/* The potentials cancel out on any path, so no path through the
+	 * open nodes can be cheaper than half the sum of the smallest keys.
+	 */
+	return (long) p_forward->k[ BIDIR_FORWARD ] + p_backward->k[ BIDIR_BACKWARD ] < 2L * p_bidir->best;
+}
+
+/*
+ * Steps 3b to 3e of the algorithm below.
+ */
+static void bidir_step( bidir_t* p_bidir )
+{
+	int direction = p_bidir->direction;
+	size_t i;
+
+	/* b.) Get a node from the open list of the current direction,
+	 *     call it N, and add it to the closed list.
+	 */
+	bidir_node_t* p_current_node = indexed_heap_pop( &p_bidir->open_list[ direction ] );
+	p_current_node->status[ direction ] = BIDIR_CLOSED;
+
+	#ifdef DEBUG_BIDIR
+	p_bidir->expansions++;
+	#endif
+
+	/* c.) Get the successors of N going forward, or its predecessors
+	 *     going backward.
+	 */
+	if( direction == BIDIR_FORWARD )
+	{
+		p_bidir->successors_of( p_current_node->state, &p_bidir->successors );
+	}
+	else
+	{
+		p_bidir->predecessors_of( p_current_node->state, &p_bidir->successors );
+	}
+
+	/* d.) For each neighbor S: */
+	for( i = 0; i < successors_size(&p_bidir->successors); i++ )
+	{
+		const void* neighbor_state = successors_get( &p_bidir->successors, i );
+		bidir_node_t* p_neighbor   = bidir_node( p_bidir, neighbor_state );
+		int g;
+
+		if( !p_neighbor )
+		{
+			bidir_fail( p_bidir );
+			break;
+		}
+
+		/* A copy of a state that was already reached is not needed. */
+		if( p_neighbor->state != neighbor_state )
+		{
+			successors_reclaim( &p_bidir->successors, i );
+			neighbor_state = p_neighbor->state;
+		}
+
+		/* i.) If S is closed in this direction, continue. */
+		if( p_neighbor->status[ direction ] == BIDIR_CLOSED )
+		{
+			continue;
+		}
+
+		g = p_current_node->g[ direction ] + (direction == BIDIR_FORWARD ?
+		                                      p_bidir->cost( p_current_node->state, neighbor_state ) :
+		                                      p_bidir->cost( neighbor_state, p_current_node->state ));
+
+		/* ii.) If S is open in this direction and the new cost is better,
+		 *      update it and sift it up the open list.
+		 */
+		if( p_neighbor->status[ direction ] == BIDIR_OPEN )
+		{
+			if( g < p_neighbor->g[ direction ] )
+			{
+				p_neighbor->k[ direction ]      -= 2 * (p_neighbor->g[ direction ] - g);
+				p_neighbor->g[ direction ]       = g;
+				p_neighbor->parent[ direction ]  = p_current_node;
+
+				indexed_heap_promote( &p_bidir->open_list[ direction ], p_neighbor );
+			}
+		}
+		else /* iii.) Otherwise, add S to the open list. */
+		{
+			bidir_open( p_bidir, direction, p_neighbor, p_current_node, g );
+		}
+
+		/* iv.) If the other search has reached S, keep the path
+		 *      through S if it is the best so far.
+		 */
+		bidir_meet( p_bidir, p_neighbor );
+	} /* for */
+
+	successors_clear( &p_bidir->successors );
+
+	/* e.) Switch directions. */
+	p_bidir->direction = !direction;
+}
+
+/*
+ * Bidirectional Search Algorithm
+ * ------------------------------------------------------------------------
+ *   Input: The start node and goal nodes.
+ *  Output: True if goal node is found, false if goal node cannot be found
+ *          from the start node.
+ * ------------------------------------------------------------------------
+ * 1.) Set both open lists to be empty.
+ * 2.) Add the start node to the forward open list and the end node
+ *     to the backward open list.
+ * 3.) While both open lists are not empty, do the following:
+ *    a.) If no path through the open nodes can be cheaper than the best
+ *        path found so far, stop.
+ *    b.) Get a node from the open list of the current direction, call
+ *        it N, and add it to the closed list.
+ *    c.) Get the successors of N going forward, or its predecessors
+ *        going backward.
+ *    d.) For each neighbor S:
+ *          i.) If S is closed in this direction, continue.
+ *         ii.) If S is open in this direction and the new cost is better,
+ *              update it and sift it up the open list.
+ *        iii.) Otherwise, add S to the open list.
+ *         iv.) If the other search has reached S, keep the path through
+ *              S if it is the best so far.
+ *    e.) Switch directions.
+ * 4.) Return true if a path was found.
+ */
+bool bidir_find( bidir_t* __restrict p_bidir, const void* __restrict start, const void* __restrict end )
+{
+	bool found;
+
+	#ifdef DEBUG_BIDIR
+	bench_mark_start( p_bidir->bm );
+	#endif
+
+	bidir_start( p_bidir, start, end );
+
+	/* 3.) While both open lists are not empty, do the following: */
+	while( bidir_should_continue( p_bidir ) )
+	{
+		bidir_step( p_bidir );
+	}
+
+	/* 4.) Return true if a path was found. */
+	found = p_bidir->meeting_node != NULL;
+
+	if( found )
+	{
+		bidir_stitch( p_bidir );
+	}
+
+	#ifdef DEBUG_BIDIR
+	bench_mark_end( p_bidir->bm );
+	bench_mark_report( p_bidir->bm );
+	printf( "Bidirectional search expanded %zu nodes.\n", p_bidir->expansions );
+	#endif
+
+	return found;
+}
+
+void bidir_cleanup( bidir_t* p_bidir )
+{
+	p_bidir->node_path    = NULL;
+	p_bidir->start        = NULL;
+	p_bidir->end          = NULL;
+	p_bidir->best         = INT_MAX;
+	p_bidir->meeting_node = NULL;
+	p_bidir->direction    = BIDIR_FORWARD;
+	successors_release_states( &p_bidir->successors );
+	indexed_heap_clear( &p_bidir->open_list[ BIDIR_FORWARD ] );
+	indexed_heap_clear( &p_bidir->open_list[ BIDIR_BACKWARD ] );
+	state_table_clear( &p_bidir->states );
+
+	/* release every node at once */
+	arena_reset( &p_bidir->nodes );
+
+	#ifdef DEBUG_BIDIR
+	p_bidir->expansions = 0;
+	#endif
+}
+
+bidir_node_t* bidir_first_node( const bidir_t* p_bidir )
+{
+	assert( p_bidir );
+	return p_bidir->node_path;
+}
+
+const void* bidir_state( const bidir_node_t* p_node )
+{
+	assert( p_node );
+	return p_node->state;
+}
+
+bidir_node_t* bidir_next_node( const bidir_node_t* p_node )
+{
+	assert( p_node );
+	return p_node->next;
+}
+
+void bidir_iterative_init( bidir_t* __restrict p_bidir, const void* __restrict start, const void* __restrict end, bool* found )
+{
+	#ifdef DEBUG_BIDIR
+	bench_mark_start( p_bidir->bm );
+	#endif
+	*found = false;
+
+	bidir_start( p_bidir, start, end );
+
+	if( !bidir_should_continue( p_bidir ) && p_bidir->meeting_node )
+	{
+		bidir_stitch( p_bidir );
+		*found = true;
+	}
+}
+
+void bidir_iterative_find( bidir_t* __restrict p_bidir, const void* __restrict start, const void* __restrict end, bool* found )
+{
+	/* 3.) While both open lists are not empty, do the following: */
+	if( !*found && bidir_should_continue( p_bidir ) )
+	{
+		bidir_step( p_bidir );
+
+		if( !bidir_should_continue( p_bidir ) && p_bidir->meeting_node )
+		{
+			bidir_stitch( p_bidir );
+			*found = true;
+		}
+	}
+
+	#ifdef DEBUG_BIDIR
+	if( *found )
+	{
+		bench_mark_end( p_bidir->bm );
+		bench_mark_report( p_bidir->bm );
+	}
+	#endif
+}
+
+bool bidir_iterative_is_done( bidir_t* __restrict p_bidir, bool* found )
+{
+	return *found || !bidir_should_continue( p_bidir );
+}
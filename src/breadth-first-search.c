@@ -22,31 +22,42 @@
 #include <stddef.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
-#include <libcollections/hash-map.h>
-#include <libcollections/tree-map.h>
-#include <libcollections/bench-mark.h>
+#include <collections/benchmark.h>
 #include "successors-private.h"
-#include "list.h"
+#include "state-table.h"
+#include "arena.h"
+#include "ring-buffer.h"
 #include "csearch.h"
 
+#define VISITED_WORD_BITS   (8 * sizeof(size_t))
+
 struct breadthfs_node {
 	struct breadthfs_node* parent;
 	const void* state; /* vertex */
 };
 
 struct breadthfs_algorithm {
-	alloc_fxn alloc;
-	free_fxn  free;
+	alloc_fxn_t alloc;
+	free_fxn_t  free;
 
-	compare_fxn       compare;
-	successors_fxn    successors_of;
+	compare_fxn_t     compare;
+	successors_fxn_t  successors_of;
 	breadthfs_node_t* node_path;
 
+	/* Dense state ID mode. When state_index is set, a state has
+	 * been visited when its bit in visited_bits is set and the
+	 * state table below is not used.
+	 */
+	state_index_fxn_t state_index;
+	size_t            num_states;
+	size_t*           visited_bits;
+
 	successors_t  successors;
-	list_t        open_list; /* list of breadthfs_node_t* */
-	lc_hash_map_t open_hash_map; /* (state, breadthfs_node_t*) */
-	lc_tree_map_t closed_list; /* (state, breadthfs_node_t*) */
+	arena_t       nodes; /* storage for breadthfs_node_t */
+	ring_buffer_t open_list; /* queue of breadthfs_node_t* */
+	state_table_t states; /* breadthfs_node_t* of every visited state */
 
 	#ifdef DEBUG_BREADTH_FIRST_SEARCH
 	size_t       allocations;
@@ -54,19 +65,10 @@ struct breadthfs_algorithm {
 	#endif
 };
 
+#define breadthfs_is_indexed( p_bfs )   ((p_bfs)->visited_bits != NULL)
 
-static boolean nop_keyval_fxn( void* __restrict key, void* __restrict value )
-{
-	return TRUE;
-}
-
-static int pointer_compare( const void* __restrict p_n1, const void* __restrict p_n2 )
-{
-	ptrdiff_t diff = (unsigned char*) p_n1 - (unsigned char*) p_n2;
-	return (int) diff;
-}
 
-breadthfs_t* breadthfs_create( compare_fxn compare, state_hash_fxn state_hasher, successors_fxn successors_of, alloc_fxn alloc, free_fxn free )
+static breadthfs_t* breadthfs_alloc( compare_fxn_t compare, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free )
 {
 	breadthfs_t* p_bfs = (breadthfs_t*) alloc( sizeof(breadthfs_t) );
 
@@ -77,17 +79,91 @@ breadthfs_t* breadthfs_create( compare_fxn compare, state_hash_fxn state_hasher,
 		p_bfs->compare       = compare;
 		p_bfs->successors_of = successors_of;
 		p_bfs->node_path     = NULL;
+		p_bfs->state_index   = NULL;
+		p_bfs->num_states    = 0;
+		p_bfs->visited_bits  = NULL;
 		#ifdef DEBUG_BREADTH_FIRST_SEARCH
 		p_bfs->allocations   = 0;
 		p_bfs->bm            = bench_mark_create( "Breadth First Search Algorithm" );
 		#endif
 
-		successors_create( &p_bfs->successors, 8, alloc, free );
-		list_create( &p_bfs->open_list, alloc, free );
-		hash_map_create( &p_bfs->open_hash_map, HASH_MAP_SIZE_MEDIUM,
-						 state_hasher, nop_keyval_fxn, pointer_compare,
-						 alloc, free );
-		tree_map_create( &p_bfs->closed_list, nop_keyval_fxn, pointer_compare, alloc, free );
+		arena_create( &p_bfs->nodes, sizeof(breadthfs_node_t) * 1024, alloc, free );
+
+		if( successors_create( &p_bfs->successors, 8, alloc, free ) )
+		{
+			if( ring_buffer_create( &p_bfs->open_list, 1024, alloc, free ) )
+			{
+				return p_bfs;
+			}
+
+			successors_destroy( &p_bfs->successors );
+		}
+
+		#ifdef DEBUG_BREADTH_FIRST_SEARCH
+		bench_mark_destroy( p_bfs->bm );
+		#endif
+		free( p_bfs );
+	}
+
+	return NULL;
+}
+
+/*
+ * Undo breadthfs_alloc() when the rest of a create function fails.
+ */
+static void breadthfs_free( breadthfs_t* p_bfs )
+{
+	free_fxn_t _free = p_bfs->free;
+
+	successors_destroy( &p_bfs->successors );
+	ring_buffer_destroy( &p_bfs->open_list );
+	#ifdef DEBUG_BREADTH_FIRST_SEARCH
+	bench_mark_destroy( p_bfs->bm );
+	#endif
+	_free( p_bfs );
+}
+
+breadthfs_t* breadthfs_create( compare_fxn_t compare, state_hash_fxn_t state_hasher, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free )
+{
+	breadthfs_t* p_bfs = breadthfs_alloc( compare, successors_of, alloc, free );
+
+	if( p_bfs && !state_table_create( &p_bfs->states, STATE_TABLE_DEFAULT_CAPACITY, offsetof(breadthfs_node_t, state), state_hasher, compare, alloc, free ) )
+	{
+		breadthfs_free( p_bfs );
+		return NULL;
+	}
+
+	return p_bfs;
+}
+
+/*
+ * Create a breadth first search over a dense state space where
+ * every state maps to a unique ID in [0, num_states). Visited
+ * states are kept in a bitmap of num_states bits instead of a
+ * hash table.
+ */
+breadthfs_t* breadthfs_create_indexed( size_t num_states, state_index_fxn_t state_index, compare_fxn_t compare, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free )
+{
+	breadthfs_t* p_bfs;
+	size_t words = (num_states + VISITED_WORD_BITS - 1) / VISITED_WORD_BITS;
+	assert( num_states > 0 );
+	assert( state_index );
+
+	p_bfs = breadthfs_alloc( compare, successors_of, alloc, free );
+
+	if( p_bfs )
+	{
+		p_bfs->state_index  = state_index;
+		p_bfs->num_states   = num_states;
+		p_bfs->visited_bits = (size_t*) alloc( sizeof(size_t) * words );
+
+		if( !p_bfs->visited_bits )
+		{
+			breadthfs_free( p_bfs );
+			return NULL;
+		}
+
+		memset( p_bfs->visited_bits, 0, sizeof(size_t) * words );
 	}
 
 	return p_bfs;
@@ -97,31 +173,45 @@ void breadthfs_destroy( breadthfs_t** p_bfs )
 {
 	if( p_bfs && *p_bfs )
 	{
-		#ifdef DEBUG_BEST_FIRST_SEARCH
+		#ifdef DEBUG_BREADTH_FIRST_SEARCH
 		bench_mark_destroy( (*p_bfs)->bm );
 		#endif
 
 		breadthfs_cleanup( *p_bfs );
+		arena_destroy( &(*p_bfs)->nodes );
 		successors_destroy( &(*p_bfs)->successors );
-		list_destroy( &(*p_bfs)->open_list );
-		tree_map_destroy( &(*p_bfs)->closed_list );
+		ring_buffer_destroy( &(*p_bfs)->open_list );
 
-		free_fxn _free = (*p_bfs)->free;
+		if( breadthfs_is_indexed(*p_bfs) )
+		{
+			(*p_bfs)->free( (*p_bfs)->visited_bits );
+		}
+		else
+		{
+			state_table_destroy( &(*p_bfs)->states );
+		}
+
+		free_fxn_t _free = (*p_bfs)->free;
 		_free( *p_bfs );
 		*p_bfs = NULL;
 	}
 }
 
-void breadthfs_set_compare_fxn( breadthfs_t* p_bfs, compare_fxn compare )
+void breadthfs_set_compare_fxn( breadthfs_t* p_bfs, compare_fxn_t compare )
 {
 	if( p_bfs )
 	{
 		assert( compare );
 		p_bfs->compare = compare;
+
+		if( !breadthfs_is_indexed(p_bfs) )
+		{
+			p_bfs->states.compare = compare;
+		}
 	}
 }
 
-void breadthfs_set_successors_fxn( breadthfs_t* p_bfs, successors_fxn successors_of )
+void breadthfs_set_successors_fxn( breadthfs_t* p_bfs, successors_fxn_t successors_of )
 {
 	if( p_bfs )
 	{
@@ -131,109 +221,171 @@ void breadthfs_set_successors_fxn( breadthfs_t* p_bfs, successors_fxn successors
 }
 
 /*
- * Breadth First Search Algorithm
- * ------------------------------------------------------------------------
- *   Input: The start node and goal nodes.
- *  Output: True if goal node is found, false if goal node cannot be found
- *          from the start node.
- * ------------------------------------------------------------------------
- * 1.) Set the open list and closed list to be empty.
- * 2.) Add the start node to the open list.
- * 3.) While the open list is not empty, do the following:
- *        a.) Get a node from the open list, call it N.
- *        b.) If N is the goal node, return true.
- *        c.) Get the successor nodes of N.
- *        d.) For each successor node S:
- *            i.) If S is in the closed list, continue.
- *            ii.) If S is in open list, continue
- *            iii.) If S is not in the open list, then add S to the open list.
- *        e.) Add N to the closed list.
- * 4.) Return false.
+ * Mark a state as visited. Returns false if it was visited
+ * already. Without state IDs, *p_entry is where breadthfs_open()
+ * puts the state's node, or is NULL if the state table
+ * could not grow.
  */
-bool breadthfs_find( breadthfs_t* __restrict p_bfs, const void* __restrict start, const void* __restrict end )
+static __inline bool breadthfs_visit( breadthfs_t* __restrict p_bfs, const void* __restrict state, state_table_entry_t** p_entry )
 {
-	breadthfs_node_t* p_node;
-	int i;
-	bool found = false;
+	if( breadthfs_is_indexed(p_bfs) )
+	{
+		size_t index = p_bfs->state_index( state );
+		size_t* p_word = &p_bfs->visited_bits[ index / VISITED_WORD_BITS ];
+		size_t bit     = (size_t) 1 << (index % VISITED_WORD_BITS);
+		assert( index < p_bfs->num_states );
 
-	#ifdef DEBUG_BEST_FIRST_SEARCH
-	bench_mark_start( p_bfs->bm );
-	#endif
+		*p_entry = NULL;
 
- 	/* 1.) Set the open list and closed list to be empty. */
-	breadthfs_cleanup( p_bfs );
+		if( *p_word & bit )
+		{
+			return false;
+		}
+
+		*p_word |= bit;
+		return true;
+	}
 
-	p_node         = (breadthfs_node_t*) p_bfs->alloc( sizeof(breadthfs_node_t) );
-	p_node->parent = NULL;
-	p_node->state  = start;
+	*p_entry = state_table_probe( &p_bfs->states, state );
+	return *p_entry && (*p_entry)->node == NULL;
+}
+
+#define breadthfs_visit_failed( p_bfs, p_entry )   (!breadthfs_is_indexed(p_bfs) && !(p_entry))
+
+/*
+ * Add a state to the open list. Returns false when out of memory.
+ */
+static __inline bool breadthfs_open( breadthfs_t* __restrict p_bfs, state_table_entry_t* __restrict p_entry, breadthfs_node_t* __restrict parent, const void* __restrict state )
+{
+	breadthfs_node_t* p_node = (breadthfs_node_t*) arena_alloc( &p_bfs->nodes, sizeof(breadthfs_node_t) );
+
+	if( !p_node )
+	{
+		return false;
+	}
+
+	p_node->parent = parent;
+	p_node->state  = state;
+
+	if( p_entry )
+	{
+		state_table_fill( &p_bfs->states, p_entry, p_node );
+	}
 
 	#ifdef DEBUG_BREADTH_FIRST_SEARCH
 	p_bfs->allocations++;
 	#endif
+	return ring_buffer_push_back( &p_bfs->open_list, p_node );
+}
 
- 	/* 2.) Add the start node to the open list. */
-	list_insert_back( &p_bfs->open_list, p_node );
-	hash_map_insert( &p_bfs->open_hash_map, p_node->state, p_node );
+static void breadthfs_start( breadthfs_t* __restrict p_bfs, const void* __restrict start )
+{
+	state_table_entry_t* p_entry;
 
- 	/* 3.) While the open list is not empty, do the following: */
-	while( !found && list_size(&p_bfs->open_list) > 0 )
+ 	/* 1.) Set the open list and visited set to be empty. */
+	breadthfs_cleanup( p_bfs );
+
+ 	/* 2.) Add the start node to the open list and visited set. */
+	breadthfs_visit( p_bfs, start, &p_entry );
+
+	/* out of memory; the open list stays empty and nothing is found */
+	if( !breadthfs_visit_failed( p_bfs, p_entry ) )
 	{
- 		/* a.) Get a node from the open list, call it p_current_node. */
-		breadthfs_node_t* p_current_node = list_front( &p_bfs->open_list )->data;
-		list_remove_front( &p_bfs->open_list );
-		hash_map_remove( &p_bfs->open_hash_map, p_current_node->state );
+		breadthfs_open( p_bfs, p_entry, NULL, start );
+	}
+}
 
-		/* b.) If p_current_node is the goal node, return true. */
-		if( p_current_node->state == end )
-		{
-			p_bfs->node_path = p_current_node;
-			found = true;
-		}
-		else
+/*
+ * One iteration of step 3 of the algorithm below. Returns true
+ * when the goal node was found.
+ */
+static bool breadthfs_step( breadthfs_t* __restrict p_bfs, const void* __restrict end )
+{
+	bool found = false;
+	size_t i;
+
+	/* a.) Get a node from the open list, call it p_current_node. */
+	breadthfs_node_t* p_current_node = ring_buffer_pop_front( &p_bfs->open_list );
+
+	/* b.) If p_current_node is the goal node, return true. */
+	if( p_bfs->compare( p_current_node->state, end ) == 0 )
+	{
+		p_bfs->node_path = p_current_node;
+		found = true;
+	}
+	else
+	{
+		/* c.) Get the successor nodes of p_current_node. */
+		p_bfs->successors_of( p_current_node->state, &p_bfs->successors );
+
+		/* d.) For each successor node S: */
+		for( i = 0; i < successors_size(&p_bfs->successors); i++ )
 		{
-			/* c.) Get the successor nodes of p_current_node. */
-			p_bfs->successors_of( p_current_node->state, &p_bfs->successors );
+			const void* __restrict successor_state = successors_get( &p_bfs->successors, i );
+			state_table_entry_t* p_entry;
 
-			/* d.) For each successor node S: */
-			for( i = 0; i < successors_size(&p_bfs->successors); i++ )
+			/* i.) If S has not been visited, then add S to the
+			 *     visited set and to the open list.
+			 */
+			if( breadthfs_visit( p_bfs, successor_state, &p_entry ) )
 			{
-				const void* successor_state = successors_get( &p_bfs->successors, i );
-
-				/* i.) If S is not in the closed list, continue. */
-				void* found_node;
-				if( tree_map_find( &p_bfs->closed_list, successor_state, &found_node ) )
+				if( breadthfs_open( p_bfs, p_entry, p_current_node, successor_state ) )
 				{
 					continue;
 				}
+			}
+			else if( !breadthfs_visit_failed( p_bfs, p_entry ) )
+			{
+				successors_reclaim( &p_bfs->successors, i );
+				continue;
+			}
 
-				/* ii.) If S is in open list, continue */
-				if( hash_map_find( &p_bfs->open_hash_map, successor_state, &found_node ) )
-				{
-					continue;
-				}
-				else /* iii.) If S is not in the open list, then add S to the open list. */
-				{
-					breadthfs_node_t* p_new_node = (breadthfs_node_t*) p_bfs->alloc( sizeof(breadthfs_node_t) );
-					p_new_node->parent     = p_current_node;
-					p_new_node->state      = successor_state;
+			/* out of memory; emptying the open list ends the search */
+			ring_buffer_clear( &p_bfs->open_list );
+			break;
+		} /* for */
 
-					list_insert_back( &p_bfs->open_list, p_new_node );
-					hash_map_insert( &p_bfs->open_hash_map, p_new_node->state, p_new_node );
+		successors_clear( &p_bfs->successors );
+	}
 
-					#ifdef DEBUG_BREADTH_FIRST_SEARCH
-					p_bfs->allocations++;
-					#endif
-				}
-			} /* for */
+	return found;
+}
 
-			successors_clear( &p_bfs->successors );
-		}
+/*
+ * Breadth First Search Algorithm
+ * ------------------------------------------------------------------------
+ *   Input: The start node and goal nodes.
+ *  Output: True if goal node is found, false if goal node cannot be found
+ *          from the start node.
+ * ------------------------------------------------------------------------
+ * 1.) Set the open list and visited set to be empty.
+ * 2.) Add the start node to the open list and visited set.
+ * 3.) While the open list is not empty, do the following:
+ *        a.) Get a node from the front of the open list, call it N.
+ *        b.) If N is the goal node, return true.
+ *        c.) Get the successor nodes of N.
+ *        d.) For each successor node S:
+ *            i.) If S has not been visited, then add S to the
+ *                visited set and to the back of the open list.
+ * 4.) Return false.
+ */
+bool breadthfs_find( breadthfs_t* __restrict p_bfs, const void* __restrict start, const void* __restrict end )
+{
+	bool found = false;
 
-		/* e.) Add p_current_node to the closed list. */
-		tree_map_insert( &p_bfs->closed_list, p_current_node->state, p_current_node );
+	#ifdef DEBUG_BREADTH_FIRST_SEARCH
+	bench_mark_start( p_bfs->bm );
+	#endif
+
+	breadthfs_start( p_bfs, start );
+
+ 	/* 3.) While the open list is not empty, do the following: */
+	while( !found && ring_buffer_size(&p_bfs->open_list) > 0 )
+	{
+		found = breadthfs_step( p_bfs, end );
 	}
 
-	#ifdef DEBUG_BEST_FIRST_SEARCH
+	#ifdef DEBUG_BREADTH_FIRST_SEARCH
 	bench_mark_end( p_bfs->bm );
 	bench_mark_report( p_bfs->bm );
 	#endif
@@ -243,47 +395,32 @@ bool breadthfs_find( breadthfs_t* __restrict p_bfs, const void* __restrict start
 
 void breadthfs_cleanup( breadthfs_t* p_bfs )
 {
-	lc_hash_map_iterator_t open_itr;
-	lc_tree_map_iterator_t closed_itr;
-
-	assert( hash_map_size(&p_bfs->open_hash_map) == list_size(&p_bfs->open_list) );
+	assert( p_bfs );
 	#ifdef DEBUG_BREADTH_FIRST_SEARCH
-	size_t size2 = hash_map_size(&p_bfs->open_hash_map);
-	size_t size3 = tree_map_size(&p_bfs->closed_list);
-	assert( size2 + size3 == p_bfs->allocations );
+	assert( breadthfs_is_indexed(p_bfs) || state_table_size(&p_bfs->states) == p_bfs->allocations );
 	#endif
 
-	successors_clear( &p_bfs->successors );
+	successors_release_states( &p_bfs->successors );
 
 	p_bfs->node_path = NULL;
 
-	hash_map_iterator( &p_bfs->open_hash_map, &open_itr );
+	// empty out the data structures
+	ring_buffer_clear( &p_bfs->open_list );
 
-	// free everything on the open list.
-	while( hash_map_iterator_next( &open_itr ) )
+	if( breadthfs_is_indexed(p_bfs) )
 	{
-		bestfs_node_t* p_node = hash_map_iterator_value( &open_itr );
-		p_bfs->free( p_node );
-		#ifdef DEBUG_BREADTH_FIRST_SEARCH
-		p_bfs->allocations--;
-		#endif
+		memset( p_bfs->visited_bits, 0, sizeof(size_t) * ((p_bfs->num_states + VISITED_WORD_BITS - 1) / VISITED_WORD_BITS) );
 	}
-
-	// free everything on the closed list.
-	for( closed_itr = tree_map_begin( &p_bfs->closed_list );
-	     closed_itr != tree_map_end( );
-	     closed_itr = tree_map_next( closed_itr ) )
+	else
 	{
-		p_bfs->free( closed_itr->value );
-		#ifdef DEBUG_BREADTH_FIRST_SEARCH
-		p_bfs->allocations--;
-		#endif
+		state_table_clear( &p_bfs->states );
 	}
 
-	// empty out the data structures
-	list_clear( &p_bfs->open_list );
-	hash_map_clear( &p_bfs->open_hash_map );
-	tree_map_clear( &p_bfs->closed_list );
+	/* release every node at once */
+	arena_reset( &p_bfs->nodes );
+	#ifdef DEBUG_BREADTH_FIRST_SEARCH
+	p_bfs->allocations = 0;
+	#endif
 }
 
 breadthfs_node_t* breadthfs_first_node( const breadthfs_t* p_bfs )
@@ -306,91 +443,23 @@ breadthfs_node_t* breadthfs_next_node( const breadthfs_node_t* p_node )
 
 void breadthfs_iterative_init( breadthfs_t* __restrict p_bfs, const void* __restrict start, const void* __restrict end, bool* __restrict found )
 {
-	breadthfs_node_t* p_node;
-	#ifdef DEBUG_BEST_FIRST_SEARCH
+	#ifdef DEBUG_BREADTH_FIRST_SEARCH
 	bench_mark_start( p_bfs->bm );
 	#endif
 	*found = false;
 
- 	/* 1.) Set the open list and closed list to be empty. */
-	breadthfs_cleanup( p_bfs );
-
-	p_node         = (breadthfs_node_t*) p_bfs->alloc( sizeof(breadthfs_node_t) );
-	p_node->parent = NULL;
-	p_node->state  = start;
-
-	#ifdef DEBUG_BREADTH_FIRST_SEARCH
-	p_bfs->allocations++;
-	#endif
-
- 	/* 2.) Add the start node to the open list. */
-	list_insert_back( &p_bfs->open_list, p_node );
-	hash_map_insert( &p_bfs->open_hash_map, p_node->state, p_node );
+	breadthfs_start( p_bfs, start );
 }
 
 void breadthfs_iterative_find( breadthfs_t* __restrict p_bfs, const void* __restrict start, const void* __restrict end, bool* __restrict found )
 {
  	/* 3.) While the open list is not empty, do the following: */
-	if( !*found && list_size(&p_bfs->open_list) > 0 )
+	if( !*found && ring_buffer_size(&p_bfs->open_list) > 0 )
 	{
- 		/* a.) Get a node from the open list, call it p_current_node. */
-		breadthfs_node_t* p_current_node = list_front( &p_bfs->open_list )->data;
-		list_remove_front( &p_bfs->open_list );
-		hash_map_remove( &p_bfs->open_hash_map, p_current_node->state );
-
-		/* b.) If p_current_node is the goal node, return true. */
-		if( p_current_node->state == end )
-		{
-			p_bfs->node_path = p_current_node;
-			*found = true;
-		}
-		else
-		{
-			int i;
-
-			/* c.) Get the successor nodes of p_current_node. */
-			p_bfs->successors_of( p_current_node->state, &p_bfs->successors );
-
-			/* d.) For each successor node S: */
-			for( i = 0; i < successors_size(&p_bfs->successors); i++ )
-			{
-				const void* successor_state = successors_get( &p_bfs->successors, i );
-
-				/* i.) If S is not in the closed list, continue. */
-				void* found_node;
-				if( tree_map_find( &p_bfs->closed_list, successor_state, &found_node ) )
-				{
-					return;
-				}
-
-				/* ii.) If S is in open list, continue */
-				if( hash_map_find( &p_bfs->open_hash_map, successor_state, &found_node ) )
-				{
-					return;
-				}
-				else /* iii.) If S is not in the open list, then add S to the open list. */
-				{
-					breadthfs_node_t* p_new_node = (breadthfs_node_t*) p_bfs->alloc( sizeof(breadthfs_node_t) );
-					p_new_node->parent     = p_current_node;
-					p_new_node->state      = successor_state;
-
-					list_insert_back( &p_bfs->open_list, p_new_node );
-					hash_map_insert( &p_bfs->open_hash_map, p_new_node->state, p_new_node );
-
-					#ifdef DEBUG_BREADTH_FIRST_SEARCH
-					p_bfs->allocations++;
-					#endif
-				}
-			} /* for */
-
-			successors_clear( &p_bfs->successors );
-		}
-
-		/* e.) Add p_current_node to the closed list. */
-		tree_map_insert( &p_bfs->closed_list, p_current_node->state, p_current_node );
+		*found = breadthfs_step( p_bfs, end );
 	}
 
-	#ifdef DEBUG_BEST_FIRST_SEARCH
+	#ifdef DEBUG_BREADTH_FIRST_SEARCH
 	if( *found )
 	{
 		bench_mark_end( p_bfs->bm );
@@ -401,5 +470,5 @@ void breadthfs_iterative_find( breadthfs_t* __restrict p_bfs, const void* __rest
 
 bool breadthfs_iterative_is_done( breadthfs_t* __restrict p_bfs, bool* __restrict found )
 {
-	return *found || list_size(&p_bfs->open_list) == 0;
+	return *found || ring_buffer_size(&p_bfs->open_list) == 0;
 }
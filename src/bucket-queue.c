@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "bucket-queue.h"
+
+#define bucket_queue_bucket( p_queue, key )   (&(p_queue)->buckets[ (size_t) (key) & (p_queue)->mask ])
+
+static __inline size_t* bucket_queue_slot( const bucket_queue_t* __restrict p_queue, void* __restrict element )
+{
+	return (size_t*) ((unsigned char*) element + p_queue->index_offset);
+}
+
+static bool bucket_append( bucket_queue_t* __restrict p_queue, bucket_t* __restrict p_bucket, void* __restrict element )
+{
+	/* grow the array if needed */
+	if( p_bucket->size >= p_bucket->capacity )
+	{
+		size_t new_capacity = p_bucket->capacity > 0 ? 2 * p_bucket->capacity : 16;
+		void** new_array    = p_queue->alloc( sizeof(void*) * new_capacity );
+
+		if( !new_array )
+		{
+			return false;
+		}
+
+		if( p_bucket->array )
+		{
+			memcpy( new_array, p_bucket->array, sizeof(void*) * p_bucket->size );
+			p_queue->free( p_bucket->array );
+		}
+
+		p_bucket->array    = new_array;
+		p_bucket->capacity = new_capacity;
+	}
+
+	*bucket_queue_slot( p_queue, element ) = p_bucket->size;
+	p_bucket->array[ p_bucket->size++ ] = element;
+	return true;
+}
+
+/*
+ * Double the number of buckets until keys from min_key to max_key
+ * map to distinct buckets. Every bucket in use holds a single key,
+ * so buckets are moved whole and element positions do not change.
+ */
+static bool bucket_queue_grow( bucket_queue_t* p_queue, int min_key, int max_key )
+{
+	size_t new_count = p_queue->mask + 1;
+	size_t new_mask;
+	bucket_t* new_buckets;
+	size_t i;
+	int key;
+
+	while( (size_t) (max_key - min_key) >= new_count )
+	{
+		new_count *= 2;
+	}
+
+	new_mask    = new_count - 1;
+	new_buckets = p_queue->alloc( sizeof(bucket_t) * new_count );
+
+	if( !new_buckets )
+	{
+		return false;
+	}
+
+	memset( new_buckets, 0, sizeof(bucket_t) * new_count );
+
+	for( key = p_queue->min_key; key <= p_queue->max_key; key++ )
+	{
+		bucket_t* p_bucket = bucket_queue_bucket( p_queue, key );
+
+		new_buckets[ (size_t) key & new_mask ] = *p_bucket;
+		p_bucket->array = NULL;
+	}
+
+	for( i = 0; i <= p_queue->mask; i++ )
+	{
+		if( p_queue->buckets[ i ].array )
+		{
+			p_queue->free( p_queue->buckets[ i ].array );
+		}
+	}
+
+	p_queue->free( p_queue->buckets );
+	p_queue->buckets = new_buckets;
+	p_queue->mask    = new_mask;
+	return true;
+}
+
+bool bucket_queue_create( bucket_queue_t* p_queue, size_t num_buckets, size_t index_offset, alloc_fxn_t alloc, free_fxn_t free )
+{
+	size_t count = 1;
+	assert( p_queue );
+
+	/* round up to a power of two */
+	while( count < num_buckets )
+	{
+		count *= 2;
+	}
+
+	p_queue->index_offset = index_offset;
+	p_queue->mask         = count - 1;
+	p_queue->size         = 0;
+	p_queue->min_key      = 0;
+	p_queue->max_key      = 0;
+	p_queue->alloc        = alloc;
+	p_queue->free         = free;
+	p_queue->buckets      = p_queue->alloc( sizeof(bucket_t) * count );
+
+	assert( p_queue->buckets );
+	if( p_queue->buckets )
+	{
+		memset( p_queue->buckets, 0, sizeof(bucket_t) * count );
+	}
+
+	return p_queue->buckets != NULL;
+}
+
+void bucket_queue_destroy( bucket_queue_t* p_queue )
+{
+	size_t i;
+	assert( p_queue );
+
+	for( i = 0; i <= p_queue->mask; i++ )
+	{
+		if( p_queue->buckets[ i ].array )
+		{
+			p_queue->free( p_queue->buckets[ i ].array );
+		}
+	}
+
+	p_queue->free( p_queue->buckets );
+
+	#ifdef _DEBUG_BUCKET_QUEUE
+	p_queue->buckets = NULL;
+	p_queue->mask    = 0;
+	p_queue->size    = 0;
+	#endif
+}
+
+bool bucket_queue_push( bucket_queue_t* __restrict p_queue, void* __restrict element, int key ) /* O(1) */
+{
+	int min_key = key;
+	int max_key = key;
+	assert( p_queue );
+	assert( key >= 0 );
+
+	if( p_queue->size > 0 )
+	{
+		min_key = key < p_queue->min_key ? key : p_queue->min_key;
+		max_key = key > p_queue->max_key ? key : p_queue->max_key;
+
+		if( (size_t) (max_key - min_key) > p_queue->mask &&
+		    !bucket_queue_grow( p_queue, min_key, max_key ) )
+		{
+			return false;
+		}
+	}
+
+	/* the key range only changes once the element is in */
+	if( !bucket_append( p_queue, bucket_queue_bucket( p_queue, key ), element ) )
+	{
+		return false;
+	}
+
+	p_queue->min_key = min_key;
+	p_queue->max_key = max_key;
+	p_queue->size++;
+	return true;
+}
+
+void* bucket_queue_pop( bucket_queue_t* p_queue ) /* O(1) amortized */
+{
+	bucket_t* p_bucket;
+	assert( p_queue );
+	assert( bucket_queue_size(p_queue) > 0 );
+
+	/* skip the empty buckets below the smallest key */
+	while( (p_bucket = bucket_queue_bucket( p_queue, p_queue->min_key ))->size == 0 )
+	{
+		p_queue->min_key++;
+	}
+
+	p_queue->size--;
+	return p_bucket->array[ --p_bucket->size ];
+}
+
+/*
+ * Move an element that is already in the queue from the bucket
+ * for old_key to the bucket for new_key.
+ */
+bool bucket_queue_update( bucket_queue_t* __restrict p_queue, void* __restrict element, int old_key, int new_key ) /* O(1) */
+{
+	bucket_t* p_bucket;
+	size_t index;
+	assert( p_queue );
+
+	p_bucket = bucket_queue_bucket( p_queue, old_key );
+	index    = *bucket_queue_slot( p_queue, element );
+	assert( index < p_bucket->size && p_bucket->array[ index ] == element );
+
+	/* fill the hole with the last element of the bucket */
+	if( index < --p_bucket->size )
+	{
+		void* last = p_bucket->array[ p_bucket->size ];
+		p_bucket->array[ index ] = last;
+		*bucket_queue_slot( p_queue, last ) = index;
+	}
+
+	p_queue->size--;
+	return bucket_queue_push( p_queue, element, new_key );
+}
+
+void bucket_queue_clear( bucket_queue_t* p_queue )
+{
+	int key;
+	assert( p_queue );
+
+	if( p_queue->size > 0 )
+	{
+		/* only the buckets between the smallest and largest key can be in use */
+		for( key = p_queue->min_key; key <= p_queue->max_key; key++ )
+		{
+			bucket_queue_bucket( p_queue, key )->size = 0;
+		}
+
+		p_queue->size = 0;
+	}
+}
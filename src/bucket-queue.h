@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _BUCKET_QUEUE_H_
+#define _BUCKET_QUEUE_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include "csearch.h"
+
+/*
+ * A bucket (Dial) queue of pointers for small non-negative integer
+ * keys. Buckets form a circular array indexed by key modulo the
+ * number of buckets, which is kept larger than the spread between
+ * the smallest and largest key in the queue. Pushing is O(1) and
+ * popping scans forward from the smallest key, so it is O(1)
+ * amortized when keys only grow, as in Dijkstra's algorithm and A*
+ * with a consistent heuristic.
+ *
+ * Elements with the same key are popped last in, first out. Like
+ * the indexed heap, every element reserves a size_t field that the
+ * queue keeps up to date with the element's position in its bucket.
+ */
+typedef struct bucket {
+	void** array;
+	size_t size;
+	size_t capacity;
+} bucket_t;
+
+typedef struct bucket_queue {
+	size_t index_offset; /* offset of the size_t position field in an element */
+	size_t mask; /* number of buckets - 1 */
+	size_t size;
+	int min_key; /* no element has a smaller key */
+	int max_key; /* no element has a larger key */
+	bucket_t* buckets;
+
+	alloc_fxn_t alloc;
+	free_fxn_t  free;
+} bucket_queue_t;
+
+bool  bucket_queue_create  ( bucket_queue_t* p_queue, size_t num_buckets, size_t index_offset, alloc_fxn_t alloc, free_fxn_t free );
+void  bucket_queue_destroy ( bucket_queue_t* p_queue );
+bool  bucket_queue_push    ( bucket_queue_t* __restrict p_queue, void* __restrict element, int key ); /* O(1) */
+void* bucket_queue_pop     ( bucket_queue_t* p_queue ); /* O(1) amortized */
+bool  bucket_queue_update  ( bucket_queue_t* __restrict p_queue, void* __restrict element, int old_key, int new_key ); /* O(1) */
+void  bucket_queue_clear   ( bucket_queue_t* p_queue );
+
+#define bucket_queue_size( p_queue )      ((p_queue)->size)
+#define bucket_queue_is_empty( p_queue )  ((p_queue)->size <= 0)
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _BUCKET_QUEUE_H_ */
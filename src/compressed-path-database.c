@@ -0,0 +1,629 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <collections/benchmark.h>
+#include "successors-private.h"
+#include "storage.h"
+#include "csearch.h"
+
+#define CPD_NONE             UINT32_MAX /* no first move; the target cannot be reached */
+#define CPD_PENDING          (UINT32_MAX - 1) /* first move not worked out yet */
+
+/*
+ * A saved database holds the run offsets, the runs and the target
+ * order, in that order (see storage.h).
+ */
+#define CPD_FILE_MAGIC       "CSCPDTBL"
+#define CPD_FILE_VERSION     1
+
+typedef struct cpd_file_header {
+	storage_file_header_t common;
+	uint64_t num_states;
+	uint64_t num_runs;
+} cpd_file_header_t;
+
+/*
+ * Targets that share the first move from a source, and that are
+ * next to each other in the target order.
+ */
+typedef struct cpd_run {
+	uint32_t first; /* position of the first target of the run */
+	uint32_t move; /* ID of the state to move to, or CPD_NONE */
+} cpd_run_t;
+
+struct cpd_node {
+	const void* state;
+	struct cpd_node* next;
+};
+
+struct compressed_path_database {
+	alloc_fxn_t alloc;
+	free_fxn_t  free;
+
+	state_index_fxn_t state_index;
+	size_t            num_states;
+	const void**      states; /* states[ id ] */
+
+	/* runs[ first_run[ s ] ... first_run[ s + 1 ] - 1 ] are the
+	 * runs of the source with ID s, in target order. order[ id ] is
+	 * the position of the state with that ID in the target order.
+	 */
+	uint64_t*  first_run;
+	cpd_run_t* runs;
+	size_t     num_runs;
+	uint32_t*  order;
+	void*      mapping; /* the mapped file of a loaded database, or NULL */
+	size_t     mapping_size;
+
+	cpd_node_t* node_path;
+	cpd_node_t* path; /* nodes of the last path, from the end to the start */
+	size_t      path_capacity;
+
+	#ifdef DEBUG_CPD
+	lc_bench_mark_t bm;
+	#endif
+};
+
+
+/*
+ * Order the targets by a depth first walk of the graph. States
+ * that are close in the graph end up close in the order, so the
+ * targets behind one first move form a few long runs instead of
+ * many short ones.
+ */
+static bool cpd_order_targets( cpd_t* __restrict p_cpd, successors_fxn_t successors_of )
+{
+	uint32_t* stack      = (uint32_t*) p_cpd->alloc( sizeof(uint32_t) * p_cpd->num_states );
+	unsigned char* seen  = (unsigned char*) p_cpd->alloc( p_cpd->num_states );
+	uint32_t position    = 0;
+	size_t size          = 0;
+	successors_t successors;
+	size_t root;
+	size_t i;
+
+	if( !stack || !seen || !successors_create( &successors, 8, p_cpd->alloc, p_cpd->free ) )
+	{
+		if( stack ) p_cpd->free( stack );
+		if( seen ) p_cpd->free( seen );
+		return false;
+	}
+
+	memset( seen, 0, p_cpd->num_states );
+
+	for( root = 0; root < p_cpd->num_states; root++ )
+	{
+		if( seen[ root ] )
+		{
+			continue;
+		}
+
+		seen[ root ]    = 1;
+		stack[ size++ ] = (uint32_t) root;
+
+		while( size > 0 )
+		{
+			uint32_t v = stack[ --size ];
+
+			p_cpd->order[ v ] = position++;
+			successors_of( p_cpd->states[ v ], &successors );
+
+			/* pushed backwards, so the first successor is walked first */
+			for( i = successors_size(&successors); i > 0; i-- )
+			{
+				size_t w = p_cpd->state_index( successors_get( &successors, i - 1 ) );
+				assert( w < p_cpd->num_states );
+
+				if( !seen[ w ] )
+				{
+					seen[ w ]       = 1;
+					stack[ size++ ] = (uint32_t) w;
+				}
+			}
+
+			successors_release_states( &successors );
+		}
+	}
+
+	successors_destroy( &successors );
+	p_cpd->free( seen );
+	p_cpd->free( stack );
+	return true;
+}
+
+/*
+ * The first move from the source to every state, from the parents
+ * of a search that closed every state reachable from the source.
+ * A state's first move is the first move to its parent, unless its
+ * parent is the source. Each state is worked out once, with the
+ * states between it and the first state already worked out on
+ * the stack.
+ */
+static void cpd_first_moves( uint32_t source, const size_t* __restrict parents, uint32_t* __restrict moves, uint32_t* __restrict stack, size_t num_states )
+{
+	size_t t;
+
+	for( t = 0; t < num_states; t++ )
+	{
+		moves[ t ] = CPD_PENDING;
+	}
+
+	moves[ source ] = CPD_NONE;
+
+	for( t = 0; t < num_states; t++ )
+	{
+		uint32_t v   = (uint32_t) t;
+		size_t depth = 0;
+
+		while( moves[ v ] == CPD_PENDING )
+		{
+			size_t parent = parents[ v ];
+
+			if( parent == SIZE_MAX )
+			{
+				moves[ v ] = CPD_NONE;
+			}
+			else if( parent == source )
+			{
+				moves[ v ] = v;
+			}
+			else
+			{
+				stack[ depth++ ] = v;
+				v = (uint32_t) parent;
+			}
+		}
+
+		while( depth > 0 )
+		{
+			v = stack[ --depth ];
+			moves[ v ] = moves[ parents[ v ] ];
+		}
+	}
+}
+
+/*
+ * Run-length encode the first moves from the source in target
+ * order. The source has no first move to itself, so it joins
+ * whichever run it falls in.
+ */
+static bool cpd_compress( cpd_t* __restrict p_cpd, uint32_t source, const uint32_t* __restrict moves, const uint32_t* __restrict targets, size_t* p_capacity )
+{
+	size_t first     = p_cpd->num_runs;
+	uint32_t last    = CPD_PENDING;
+	uint32_t position;
+
+	for( position = 0; position < p_cpd->num_states; position++ )
+	{
+		uint32_t t = targets[ position ];
+
+		if( t == source || moves[ t ] == last )
+		{
+			continue;
+		}
+
+		if( !storage_reserve( (void**) &p_cpd->runs, p_capacity, p_cpd->num_runs, p_cpd->num_runs + 1, sizeof(cpd_run_t), p_cpd->alloc, p_cpd->free ) )
+		{
+			return false;
+		}
+
+		p_cpd->runs[ p_cpd->num_runs ].first = position;
+		p_cpd->runs[ p_cpd->num_runs ].move  = moves[ t ];
+		p_cpd->num_runs++;
+		last = moves[ t ];
+	}
+
+	if( p_cpd->num_runs == first )
+	{
+		if( !storage_reserve( (void**) &p_cpd->runs, p_capacity, p_cpd->num_runs, p_cpd->num_runs + 1, sizeof(cpd_run_t), p_cpd->alloc, p_cpd->free ) )
+		{
+			return false;
+		}
+
+		p_cpd->runs[ p_cpd->num_runs ].move = CPD_NONE;
+		p_cpd->num_runs++;
+	}
+
+	/* every lookup finds a run that starts at or before its target */
+	p_cpd->runs[ first ].first = 0;
+	return true;
+}
+
+/*
+ * One search from every source, each closing every state it can
+ * reach.
+ */
+static bool cpd_build( cpd_t* __restrict p_cpd, compare_fxn_t compare, nonnegative_cost_fxn_t cost, successors_fxn_t successors_of )
+{
+	dijkstra_t* p_dijkstra = dijkstra_create_indexed_ex( OPEN_LIST_RADIX_HEAP, p_cpd->num_states, p_cpd->state_index, compare, cost, successors_of, p_cpd->alloc, p_cpd->free );
+	size_t* parents        = (size_t*) p_cpd->alloc( sizeof(size_t) * p_cpd->num_states );
+	uint32_t* moves        = (uint32_t*) p_cpd->alloc( sizeof(uint32_t) * p_cpd->num_states );
+	uint32_t* targets      = (uint32_t*) p_cpd->alloc( sizeof(uint32_t) * p_cpd->num_states ); /* targets[ position ] is an ID */
+	uint32_t* stack        = (uint32_t*) p_cpd->alloc( sizeof(uint32_t) * p_cpd->num_states );
+	size_t capacity        = 0;
+	bool result            = p_dijkstra && parents && moves && targets && stack;
+	size_t s;
+
+	if( result )
+	{
+		for( s = 0; s < p_cpd->num_states; s++ )
+		{
+			targets[ p_cpd->order[ s ] ] = (uint32_t) s;
+		}
+	}
+
+	for( s = 0; result && s < p_cpd->num_states; s++ )
+	{
+		p_cpd->first_run[ s ] = p_cpd->num_runs;
+
+		dijkstra_compute_all( p_dijkstra, p_cpd->states[ s ], NULL, parents );
+		cpd_first_moves( (uint32_t) s, parents, moves, stack, p_cpd->num_states );
+
+		result = cpd_compress( p_cpd, (uint32_t) s, moves, targets, &capacity );
+	}
+
+	p_cpd->first_run[ p_cpd->num_states ] = p_cpd->num_runs;
+
+	if( p_dijkstra ) dijkstra_destroy( &p_dijkstra );
+	if( parents ) p_cpd->free( parents );
+	if( moves ) p_cpd->free( moves );
+	if( targets ) p_cpd->free( targets );
+	if( stack ) p_cpd->free( stack );
+	return result;
+}
+
+static cpd_t* cpd_allocate( size_t num_states, const void* const* states, state_index_fxn_t state_index, alloc_fxn_t alloc, free_fxn_t free )
+{
+	cpd_t* p_cpd = (cpd_t*) alloc( sizeof(cpd_t) );
+
+	if( p_cpd )
+	{
+		memset( p_cpd, 0, sizeof(cpd_t) );
+		p_cpd->alloc       = alloc;
+		p_cpd->free        = free;
+		p_cpd->state_index = state_index;
+		p_cpd->num_states  = num_states;
+		#ifdef DEBUG_CPD
+		p_cpd->bm          = bench_mark_create( "Compressed Path Database" );
+		#endif
+
+		p_cpd->states = (const void**) alloc( sizeof(const void*) * num_states );
+
+		if( !p_cpd->states )
+		{
+			cpd_destroy( &p_cpd );
+			return NULL;
+		}
+
+		memcpy( p_cpd->states, states, sizeof(const void*) * num_states );
+	}
+
+	return p_cpd;
+}
+
+cpd_t* cpd_create( size_t num_states, const void* const* states, state_index_fxn_t state_index, compare_fxn_t compare, nonnegative_cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free )
+{
+	cpd_t* p_cpd;
+	assert( num_states > 0 && num_states < CPD_PENDING );
+	assert( states );
+	assert( state_index );
+	assert( cost );
+	assert( successors_of );
+
+	p_cpd = cpd_allocate( num_states, states, state_index, alloc, free );
+
+	if( p_cpd )
+	{
+		p_cpd->first_run = (uint64_t*) alloc( sizeof(uint64_t) * (num_states + 1) );
+		p_cpd->order     = (uint32_t*) alloc( sizeof(uint32_t) * num_states );
+
+		if( !p_cpd->first_run || !p_cpd->order ||
+		    !cpd_order_targets( p_cpd, successors_of ) ||
+		    !cpd_build( p_cpd, compare, cost, successors_of ) )
+		{
+			cpd_destroy( &p_cpd );
+		}
+	}
+
+	return p_cpd;
+}
+
+void cpd_destroy( cpd_t** p_cpd )
+{
+	if( p_cpd && *p_cpd )
+	{
+		cpd_t* p = *p_cpd;
+
+		#ifdef DEBUG_CPD
+		bench_mark_destroy( p->bm );
+		#endif
+
+		if( p->mapping )
+		{
+			storage_unmap( p->mapping, p->mapping_size );
+		}
+		else
+		{
+			if( p->first_run ) p->free( p->first_run );
+			if( p->runs )      p->free( p->runs );
+			if( p->order )     p->free( p->order );
+		}
+
+		if( p->states ) p->free( (void*) p->states );
+		if( p->path )   p->free( p->path );
+
+		free_fxn_t _free = p->free;
+		_free( p );
+		*p_cpd = NULL;
+	}
+}
+
+size_t cpd_runs( const cpd_t* p_cpd )
+{
+	assert( p_cpd );
+	return p_cpd->num_runs;
+}
+
+bool cpd_save( const cpd_t* __restrict p_cpd, const char* __restrict filename )
+{
+	cpd_file_header_t header;
+	storage_section_t sections[ 3 ];
+	assert( p_cpd );
+	assert( filename );
+
+	memset( &header, 0, sizeof(header) );
+	storage_header_init( &header.common, CPD_FILE_MAGIC, CPD_FILE_VERSION );
+	header.num_states = p_cpd->num_states;
+	header.num_runs   = p_cpd->num_runs;
+
+	sections[ 0 ].data = p_cpd->first_run;
+	sections[ 0 ].size = sizeof(uint64_t) * (p_cpd->num_states + 1);
+	sections[ 1 ].data = p_cpd->runs;
+	sections[ 1 ].size = sizeof(cpd_run_t) * p_cpd->num_runs;
+	sections[ 2 ].data = p_cpd->order;
+	sections[ 2 ].size = sizeof(uint32_t) * p_cpd->num_states;
+
+	return storage_save( filename, &header, sizeof(header), sections, 3 );
+}
+
+/*
+ * Every lookup trusts the offsets, the moves and the order, so a
+ * loaded database is checked in full before it is used. This reads
+ * the whole file once, in O(N + R).
+ */
+static bool cpd_is_valid( const cpd_t* p_cpd )
+{
+	size_t i;
+
+	if( p_cpd->first_run[ 0 ] != 0 || p_cpd->first_run[ p_cpd->num_states ] != p_cpd->num_runs )
+	{
+		return false;
+	}
+
+	/* every source has at least one run */
+	for( i = 0; i < p_cpd->num_states; i++ )
+	{
+		if( p_cpd->first_run[ i ] >= p_cpd->first_run[ i + 1 ] ||
+		    p_cpd->order[ i ] >= p_cpd->num_states )
+		{
+			return false;
+		}
+	}
+
+	for( i = 0; i < p_cpd->num_runs; i++ )
+	{
+		if( p_cpd->runs[ i ].move >= p_cpd->num_states && p_cpd->runs[ i ].move != CPD_NONE )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+cpd_t* cpd_load( const char* __restrict filename, size_t num_states, const void* const* states, state_index_fxn_t state_index, alloc_fxn_t alloc, free_fxn_t free )
+{
+	const cpd_file_header_t* header;
+	unsigned char* data;
+	cpd_t* p_cpd;
+	void* mapping;
+	size_t size;
+	assert( filename );
+	assert( states );
+	assert( state_index );
+	assert( num_states < CPD_PENDING );
+
+	if( !(mapping = storage_map( filename, &size )) )
+	{
+		return NULL;
+	}
+
+	header = (const cpd_file_header_t*) mapping;
+
+	if( !storage_header_is_valid( &header->common, CPD_FILE_MAGIC, CPD_FILE_VERSION ) ||
+	    header->num_states != num_states ||
+	    header->num_runs < num_states ||
+	    (uint64_t) size != STORAGE_FILE_DATA_OFFSET + sizeof(uint64_t) * (header->num_states + 1) + sizeof(cpd_run_t) * header->num_runs + sizeof(uint32_t) * header->num_states ||
+	    !(p_cpd = cpd_allocate( num_states, states, state_index, alloc, free )) )
+	{
+		storage_unmap( mapping, size );
+		return NULL;
+	}
+
+	data                = storage_data( mapping );
+	p_cpd->first_run    = (uint64_t*) data;
+	p_cpd->runs         = (cpd_run_t*) (data + sizeof(uint64_t) * (num_states + 1));
+	p_cpd->num_runs     = (size_t) header->num_runs;
+	p_cpd->order        = (uint32_t*) (data + sizeof(uint64_t) * (num_states + 1) + sizeof(cpd_run_t) * p_cpd->num_runs);
+	p_cpd->mapping      = mapping;
+	p_cpd->mapping_size = size;
+
+	if( !cpd_is_valid( p_cpd ) )
+	{
+		cpd_destroy( &p_cpd );
+	}
+
+	return p_cpd;
+}
+
+/*
+ * The first move from one state to another is the move of the
+ * last run of the source that starts at or before the target.
+ */
+static __inline uint32_t cpd_lookup( const cpd_t* __restrict p_cpd, size_t source, size_t target ) /* O(lg R) */
+{
+	const cpd_run_t* runs = &p_cpd->runs[ p_cpd->first_run[ source ] ];
+	size_t high           = (size_t) (p_cpd->first_run[ source + 1 ] - p_cpd->first_run[ source ]);
+	uint32_t position     = p_cpd->order[ target ];
+	size_t low            = 0;
+
+	while( high - low > 1 )
+	{
+		size_t middle = low + (high - low) / 2;
+
+		if( runs[ middle ].first <= position )
+		{
+			low = middle;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	return runs[ low ].move;
+}
+
+const void* cpd_next_move( const cpd_t* __restrict p_cpd, const void* __restrict state, const void* __restrict end )
+{
+	size_t s;
+	size_t t;
+	uint32_t move;
+	assert( p_cpd );
+
+	s = p_cpd->state_index( state );
+	t = p_cpd->state_index( end );
+	assert( s < p_cpd->num_states && t < p_cpd->num_states );
+
+	if( s == t )
+	{
+		return NULL;
+	}
+
+	move = cpd_lookup( p_cpd, s, t );
+	return move == CPD_NONE ? NULL : p_cpd->states[ move ];
+}
+
+bool cpd_find( cpd_t* __restrict p_cpd, const void* __restrict start, const void* __restrict end )
+{
+	size_t count = 0;
+	bool found   = false;
+	size_t s;
+	size_t t;
+	size_t i;
+
+	#ifdef DEBUG_CPD
+	bench_mark_start( p_cpd->bm );
+	#endif
+	assert( p_cpd );
+
+	cpd_cleanup( p_cpd );
+
+	s = p_cpd->state_index( start );
+	t = p_cpd->state_index( end );
+	assert( s < p_cpd->num_states && t < p_cpd->num_states );
+
+	/* A shortest path visits a state once at most, so a longer walk
+	 * means the database was built for a different graph.
+	 */
+	while( count < p_cpd->num_states )
+	{
+		uint32_t move;
+
+		if( !storage_reserve( (void**) &p_cpd->path, &p_cpd->path_capacity, count, count + 1, sizeof(cpd_node_t), p_cpd->alloc, p_cpd->free ) )
+		{
+			break;
+		}
+
+		p_cpd->path[ count++ ].state = p_cpd->states[ s ];
+
+		if( s == t )
+		{
+			found = true;
+			break;
+		}
+
+		move = cpd_lookup( p_cpd, s, t );
+
+		if( move == CPD_NONE )
+		{
+			break;
+		}
+
+		s = move;
+	}
+
+	if( found )
+	{
+		/* the nodes run from the end to the start, like A* */
+		for( i = 0; i < count; i++ )
+		{
+			p_cpd->path[ i ].next = i > 0 ? &p_cpd->path[ i - 1 ] : NULL;
+		}
+
+		p_cpd->node_path = &p_cpd->path[ count - 1 ];
+	}
+
+	#ifdef DEBUG_CPD
+	bench_mark_end( p_cpd->bm );
+	bench_mark_report( p_cpd->bm );
+	#endif
+
+	return found;
+}
+
+void cpd_cleanup( cpd_t* p_cpd )
+{
+	assert( p_cpd );
+	p_cpd->node_path = NULL;
+}
+
+cpd_node_t* cpd_first_node( const cpd_t* p_cpd )
+{
+	assert( p_cpd );
+	return p_cpd->node_path;
+}
+
+const void* cpd_state( const cpd_node_t* p_node )
+{
+	assert( p_node );
+	return p_node->state;
+}
+
+cpd_node_t* cpd_next_node( const cpd_node_t* p_node )
+{
+	assert( p_node );
+	return p_node->next;
+}
@@ -0,0 +1,945 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <assert.h>
+#include <collections/benchmark.h>
+#include "successors-private.h"
+#include "indexed-heap.h"
+#include "storage.h"
+#include "csearch.h"
+
+#define CH_NONE               UINT32_MAX
+#define CH_WITNESS_SETTLED    64 /* vertices a witness search may settle */
+
+/*
+ * An arc of the graph. In a vertex's out arcs, vertex is the head;
+ * in its in arcs, vertex is the tail. A shortcut stands for the two
+ * arcs through the middle vertex, which was contracted before both
+ * of its ends.
+ */
+typedef struct ch_arc {
+	uint32_t vertex;
+	uint32_t middle; /* CH_NONE for an arc of the original graph */
+	unsigned int cost;
+} ch_arc_t;
+
+typedef struct ch_arcs {
+	ch_arc_t* array;
+	uint32_t  size;
+	uint32_t  capacity;
+} ch_arcs_t;
+
+/*
+ * A vertex while the graph is being contracted.
+ */
+typedef struct ch_vertex {
+	ch_arcs_t out;
+	ch_arcs_t in;
+	int priority; /* contracted first when lowest */
+	uint32_t deleted_neighbors; /* neighbors contracted so far */
+	uint32_t rank; /* contraction order, or CH_NONE */
+	size_t heap_index; /* position in the contraction queue */
+} ch_vertex_t;
+
+/*
+ * A vertex reached by a search. Labels are stamped with the search
+ * that last reached them, like the nodes of the indexed searches.
+ */
+typedef struct ch_label {
+	unsigned int d; /* cost from the source */
+	unsigned int generation;
+	uint32_t parent; /* previous vertex on the path from the source */
+	uint32_t parent_arc; /* arc from parent, or CH_NONE */
+	size_t open_index; /* position in the open list */
+} ch_label_t;
+
+struct ch_node {
+	const void* state;
+	struct ch_node* next;
+};
+
+struct ch_algorithm {
+	alloc_fxn_t alloc;
+	free_fxn_t  free;
+
+	state_index_fxn_t state_index;
+	size_t            num_states;
+	const void**      states; /* states[ id ] */
+	size_t            shortcuts;
+
+	/* The search graph. forward_arcs[ forward_first[ v ] ...
+	 * forward_first[ v + 1 ] - 1 ] go from v to higher ranked
+	 * vertices. backward_arcs are indexed the same way by head and
+	 * come from higher ranked vertices.
+	 */
+	uint32_t* forward_first;
+	ch_arc_t* forward_arcs;
+	uint32_t* backward_first;
+	ch_arc_t* backward_arcs;
+
+	ch_label_t*    forward;
+	ch_label_t*    backward;
+	unsigned int   generation;
+	indexed_heap_t forward_open; /* heap of ch_label_t* */
+	indexed_heap_t backward_open; /* heap of ch_label_t* */
+
+	ch_node_t* node_path;
+	ch_node_t* path; /* nodes of the last path, from the end to the start */
+	size_t     path_capacity;
+	uint32_t*  vertices; /* scratch for unpacking a path */
+	size_t     vertices_capacity;
+	ch_arc_t*  stack; /* scratch for unpacking a shortcut */
+	size_t     stack_capacity;
+	unsigned int cost;
+
+	#ifdef DEBUG_CH
+	lc_bench_mark_t bm;
+	#endif
+};
+
+#define default_cost_compare( c1, c2 )      ((c1) < (c2) ? 1 : ((c1) > (c2) ? -1 : 0))
+
+static int best_cost_compare( const void* __restrict p_l1, const void* __restrict p_l2 )
+{
+	return default_cost_compare(((ch_label_t*)p_l1)->d,  ((ch_label_t*)p_l2)->d);
+}
+
+static int best_priority_compare( const void* __restrict p_v1, const void* __restrict p_v2 )
+{
+	return default_cost_compare(((ch_vertex_t*)p_v1)->priority,  ((ch_vertex_t*)p_v2)->priority);
+}
+
+#define ch_is_contracted( p_vertex )   ((p_vertex)->rank != CH_NONE)
+
+
+/*
+ * Add an arc to a list, or lower the cost of the arc to the same
+ * vertex if it is already there.
+ */
+static bool ch_arcs_add( ch_t* __restrict p_ch, ch_arcs_t* __restrict p_arcs, uint32_t vertex, unsigned int cost, uint32_t middle )
+{
+	size_t capacity = p_arcs->capacity;
+	uint32_t i;
+
+	for( i = 0; i < p_arcs->size; i++ )
+	{
+		if( p_arcs->array[ i ].vertex == vertex )
+		{
+			if( cost < p_arcs->array[ i ].cost )
+			{
+				p_arcs->array[ i ].cost   = cost;
+				p_arcs->array[ i ].middle = middle;
+			}
+
+			return true;
+		}
+	}
+
+	if( !storage_reserve( (void**) &p_arcs->array, &capacity, p_arcs->size, p_arcs->size + 1, sizeof(ch_arc_t), p_ch->alloc, p_ch->free ) )
+	{
+		return false;
+	}
+
+	p_arcs->capacity = (uint32_t) capacity;
+	p_arcs->array[ p_arcs->size ].vertex = vertex;
+	p_arcs->array[ p_arcs->size ].middle = middle;
+	p_arcs->array[ p_arcs->size ].cost   = cost;
+	p_arcs->size++;
+	return true;
+}
+
+static __inline bool ch_add_arc( ch_t* __restrict p_ch, ch_vertex_t* __restrict vertices, uint32_t tail, uint32_t head, unsigned int cost, uint32_t middle )
+{
+	return ch_arcs_add( p_ch, &vertices[ tail ].out, head, cost, middle ) &&
+	       ch_arcs_add( p_ch, &vertices[ head ].in, tail, cost, middle );
+}
+
+/*
+ * Start a new search over the labels. The labels only have to be
+ * cleared when the generation counter wraps around.
+ */
+static void ch_next_generation( ch_t* p_ch )
+{
+	if( ++p_ch->generation == 0 )
+	{
+		memset( p_ch->forward, 0, sizeof(ch_label_t) * p_ch->num_states );
+		memset( p_ch->backward, 0, sizeof(ch_label_t) * p_ch->num_states );
+		p_ch->generation = 1;
+	}
+
+	indexed_heap_clear( &p_ch->forward_open );
+	indexed_heap_clear( &p_ch->backward_open );
+}
+
+/*
+ * Reach a vertex with cost d, or reach it again for less. Returns
+ * false if the cost is not an improvement.
+ */
+static __inline bool ch_relax( ch_t* __restrict p_ch, ch_label_t* __restrict labels, indexed_heap_t* __restrict p_open, uint32_t vertex, unsigned int d, uint32_t parent, uint32_t parent_arc )
+{
+	ch_label_t* p_label = &labels[ vertex ];
+
+	if( p_label->generation != p_ch->generation )
+	{
+		p_label->d          = d;
+		p_label->generation = p_ch->generation;
+		p_label->parent     = parent;
+		p_label->parent_arc = parent_arc;
+		indexed_heap_push( p_open, p_label );
+		return true;
+	}
+	else if( d < p_label->d )
+	{
+		/* a vertex that was settled is never improved upon */
+		p_label->d          = d;
+		p_label->parent     = parent;
+		p_label->parent_arc = parent_arc;
+		indexed_heap_promote( p_open, p_label );
+		return true;
+	}
+
+	return false;
+}
+
+/*
+ * Dijkstra's algorithm from source over the vertices that are not
+ * contracted yet, without going through skip. It gives up past the
+ * cost limit or after settling CH_WITNESS_SETTLED vertices, so a
+ * witness may be missed; that only costs an extra shortcut.
+ */
+static void ch_witness_search( ch_t* __restrict p_ch, ch_vertex_t* __restrict vertices, uint32_t source, uint32_t skip, unsigned int limit )
+{
+	size_t settled = 0;
+
+	ch_next_generation( p_ch );
+	ch_relax( p_ch, p_ch->forward, &p_ch->forward_open, source, 0, CH_NONE, CH_NONE );
+
+	while( !indexed_heap_is_empty(&p_ch->forward_open) && settled < CH_WITNESS_SETTLED )
+	{
+		ch_label_t* p_label = indexed_heap_pop( &p_ch->forward_open );
+		ch_vertex_t* p_vertex;
+		uint32_t i;
+
+		if( p_label->d > limit )
+		{
+			break;
+		}
+
+		p_vertex = &vertices[ p_label - p_ch->forward ];
+		settled++;
+
+		for( i = 0; i < p_vertex->out.size; i++ )
+		{
+			const ch_arc_t* p_arc = &p_vertex->out.array[ i ];
+
+			if( p_arc->vertex != skip && !ch_is_contracted( &vertices[ p_arc->vertex ] ) )
+			{
+				ch_relax( p_ch, p_ch->forward, &p_ch->forward_open, p_arc->vertex, p_label->d + p_arc->cost, CH_NONE, CH_NONE );
+			}
+		}
+	}
+}
+
+/*
+ * Contract a vertex: for every pair of arcs u -> v -> x between
+ * vertices that are still in the graph, add the shortcut u -> x
+ * unless a witness search finds a path from u to x that costs no
+ * more and does not go through v. When simulating, the shortcuts
+ * are only counted. Returns the number of shortcuts, or -1 when
+ * out of memory.
+ */
+static int ch_contract( ch_t* __restrict p_ch, ch_vertex_t* __restrict vertices, uint32_t v, bool simulate )
+{
+	ch_vertex_t* p_vertex = &vertices[ v ];
+	int shortcuts         = 0;
+	uint32_t i;
+	uint32_t j;
+
+	for( i = 0; i < p_vertex->in.size; i++ )
+	{
+		ch_arc_t in         = p_vertex->in.array[ i ];
+		unsigned int limit  = 0;
+		bool has_head       = false;
+
+		if( ch_is_contracted( &vertices[ in.vertex ] ) )
+		{
+			continue;
+		}
+
+		for( j = 0; j < p_vertex->out.size; j++ )
+		{
+			const ch_arc_t* p_out = &p_vertex->out.array[ j ];
+
+			if( p_out->vertex != in.vertex && !ch_is_contracted( &vertices[ p_out->vertex ] ) )
+			{
+				has_head = true;
+
+				if( in.cost + p_out->cost > limit )
+				{
+					limit = in.cost + p_out->cost;
+				}
+			}
+		}
+
+		if( !has_head )
+		{
+			continue;
+		}
+
+		ch_witness_search( p_ch, vertices, in.vertex, v, limit );
+
+		for( j = 0; j < p_vertex->out.size; j++ )
+		{
+			ch_arc_t out = p_vertex->out.array[ j ];
+			const ch_label_t* p_label;
+
+			if( out.vertex == in.vertex || ch_is_contracted( &vertices[ out.vertex ] ) )
+			{
+				continue;
+			}
+
+			p_label = &p_ch->forward[ out.vertex ];
+
+			if( p_label->generation == p_ch->generation && p_label->d <= in.cost + out.cost )
+			{
+				/* witness found */
+				continue;
+			}
+
+			shortcuts++;
+
+			if( !simulate && !ch_add_arc( p_ch, vertices, in.vertex, out.vertex, in.cost + out.cost, v ) )
+			{
+				return -1;
+			}
+		}
+	}
+
+	return shortcuts;
+}
+
+/*
+ * Prefer vertices whose contraction removes more arcs than it
+ * adds, and spread the contractions out over the graph.
+ */
+static bool ch_update_priority( ch_t* __restrict p_ch, ch_vertex_t* __restrict vertices, uint32_t v )
+{
+	ch_vertex_t* p_vertex = &vertices[ v ];
+	int shortcuts         = ch_contract( p_ch, vertices, v, true );
+	int removed           = 0;
+	uint32_t i;
+
+	if( shortcuts < 0 )
+	{
+		return false;
+	}
+
+	for( i = 0; i < p_vertex->out.size; i++ )
+	{
+		removed += !ch_is_contracted( &vertices[ p_vertex->out.array[ i ].vertex ] );
+	}
+
+	for( i = 0; i < p_vertex->in.size; i++ )
+	{
+		removed += !ch_is_contracted( &vertices[ p_vertex->in.array[ i ].vertex ] );
+	}
+
+	p_vertex->priority = 2 * (shortcuts - removed) + (int) p_vertex->deleted_neighbors;
+	return true;
+}
+
+static bool ch_read_graph( ch_t* __restrict p_ch, ch_vertex_t* __restrict vertices, nonnegative_cost_fxn_t cost, successors_fxn_t successors_of )
+{
+	successors_t successors;
+	bool result = true;
+	size_t v;
+	size_t i;
+
+	if( !successors_create( &successors, 8, p_ch->alloc, p_ch->free ) )
+	{
+		return false;
+	}
+
+	for( v = 0; result && v < p_ch->num_states; v++ )
+	{
+		const void* state = p_ch->states[ v ];
+
+		successors_of( state, &successors );
+
+		for( i = 0; result && i < successors_size(&successors); i++ )
+		{
+			const void* successor = successors_get( &successors, i );
+			size_t head           = p_ch->state_index( successor );
+
+			assert( head < p_ch->num_states );
+
+			if( head != v )
+			{
+				result = ch_add_arc( p_ch, vertices, (uint32_t) v, (uint32_t) head, cost( state, successor ), CH_NONE );
+			}
+		}
+
+		successors_release_states( &successors );
+	}
+
+	successors_destroy( &successors );
+	return result;
+}
+
+/*
+ * Keep the arcs that go up the hierarchy. Every arc of the
+ * contracted graph goes up from one of its ends, so it is kept
+ * once, either from its tail or into its head.
+ */
+static bool ch_build_search_graph( ch_t* __restrict p_ch, const ch_vertex_t* __restrict vertices )
+{
+	size_t n = p_ch->num_states;
+	size_t v;
+	uint32_t i;
+
+	p_ch->forward_first  = (uint32_t*) p_ch->alloc( sizeof(uint32_t) * (n + 1) );
+	p_ch->backward_first = (uint32_t*) p_ch->alloc( sizeof(uint32_t) * (n + 1) );
+
+	if( !p_ch->forward_first || !p_ch->backward_first )
+	{
+		return false;
+	}
+
+	memset( p_ch->forward_first, 0, sizeof(uint32_t) * (n + 1) );
+	memset( p_ch->backward_first, 0, sizeof(uint32_t) * (n + 1) );
+
+	for( v = 0; v < n; v++ )
+	{
+		for( i = 0; i < vertices[ v ].out.size; i++ )
+		{
+			uint32_t head = vertices[ v ].out.array[ i ].vertex;
+
+			if( vertices[ head ].rank > vertices[ v ].rank )
+			{
+				p_ch->forward_first[ v + 1 ]++;
+			}
+			else
+			{
+				p_ch->backward_first[ head + 1 ]++;
+			}
+		}
+	}
+
+	for( v = 0; v < n; v++ )
+	{
+		p_ch->forward_first[ v + 1 ]  += p_ch->forward_first[ v ];
+		p_ch->backward_first[ v + 1 ] += p_ch->backward_first[ v ];
+	}
+
+	p_ch->forward_arcs  = (ch_arc_t*) p_ch->alloc( sizeof(ch_arc_t) * (p_ch->forward_first[ n ] + 1) );
+	p_ch->backward_arcs = (ch_arc_t*) p_ch->alloc( sizeof(ch_arc_t) * (p_ch->backward_first[ n ] + 1) );
+
+	if( !p_ch->forward_arcs || !p_ch->backward_arcs )
+	{
+		return false;
+	}
+
+	for( v = 0; v < n; v++ )
+	{
+		for( i = 0; i < vertices[ v ].out.size; i++ )
+		{
+			ch_arc_t arc  = vertices[ v ].out.array[ i ];
+			uint32_t head = arc.vertex;
+
+			if( vertices[ head ].rank > vertices[ v ].rank )
+			{
+				p_ch->forward_arcs[ p_ch->forward_first[ v ]++ ] = arc;
+			}
+			else
+			{
+				arc.vertex = (uint32_t) v;
+				p_ch->backward_arcs[ p_ch->backward_first[ head ]++ ] = arc;
+			}
+		}
+	}
+
+	/* filling moved every start to the next vertex's start */
+	for( v = n; v > 0; v-- )
+	{
+		p_ch->forward_first[ v ]  = p_ch->forward_first[ v - 1 ];
+		p_ch->backward_first[ v ] = p_ch->backward_first[ v - 1 ];
+	}
+
+	p_ch->forward_first[ 0 ]  = 0;
+	p_ch->backward_first[ 0 ] = 0;
+	return true;
+}
+
+static bool ch_preprocess( ch_t* __restrict p_ch, nonnegative_cost_fxn_t cost, successors_fxn_t successors_of )
+{
+	ch_vertex_t* vertices = (ch_vertex_t*) p_ch->alloc( sizeof(ch_vertex_t) * p_ch->num_states );
+	indexed_heap_t queue;
+	uint32_t rank = 0;
+	bool result;
+	size_t v;
+
+	if( !vertices )
+	{
+		return false;
+	}
+
+	memset( vertices, 0, sizeof(ch_vertex_t) * p_ch->num_states );
+	queue.array = NULL;
+
+	for( v = 0; v < p_ch->num_states; v++ )
+	{
+		vertices[ v ].rank = CH_NONE;
+	}
+
+	result = ch_read_graph( p_ch, vertices, cost, successors_of ) &&
+	         indexed_heap_create( &queue, p_ch->num_states, offsetof(ch_vertex_t, heap_index), best_priority_compare, p_ch->alloc, p_ch->free );
+
+	for( v = 0; result && v < p_ch->num_states; v++ )
+	{
+		result = ch_update_priority( p_ch, vertices, (uint32_t) v ) &&
+		         indexed_heap_push( &queue, &vertices[ v ] );
+	}
+
+	/* Lazy updates: a vertex's priority is only brought up to date
+	 * when it comes out of the queue. If it is no longer the lowest,
+	 * it goes back in.
+	 */
+	while( result && !indexed_heap_is_empty(&queue) )
+	{
+		ch_vertex_t* p_vertex = indexed_heap_pop( &queue );
+		uint32_t u            = (uint32_t) (p_vertex - vertices);
+		int shortcuts;
+		uint32_t i;
+
+		if( !ch_update_priority( p_ch, vertices, u ) )
+		{
+			result = false;
+			break;
+		}
+
+		if( !indexed_heap_is_empty(&queue) &&
+		    p_vertex->priority > ((ch_vertex_t*) indexed_heap_peek(&queue))->priority )
+		{
+			result = indexed_heap_push( &queue, p_vertex );
+			continue;
+		}
+
+		shortcuts = ch_contract( p_ch, vertices, u, false );
+
+		if( shortcuts < 0 )
+		{
+			result = false;
+			break;
+		}
+
+		p_ch->shortcuts += shortcuts;
+		p_vertex->rank   = rank++;
+
+		for( i = 0; i < p_vertex->out.size; i++ )
+		{
+			vertices[ p_vertex->out.array[ i ].vertex ].deleted_neighbors++;
+		}
+
+		for( i = 0; i < p_vertex->in.size; i++ )
+		{
+			vertices[ p_vertex->in.array[ i ].vertex ].deleted_neighbors++;
+		}
+	}
+
+	if( result )
+	{
+		result = ch_build_search_graph( p_ch, vertices );
+	}
+
+	if( queue.array )
+	{
+		indexed_heap_destroy( &queue );
+	}
+
+	for( v = 0; v < p_ch->num_states; v++ )
+	{
+		if( vertices[ v ].out.array ) p_ch->free( vertices[ v ].out.array );
+		if( vertices[ v ].in.array )  p_ch->free( vertices[ v ].in.array );
+	}
+
+	p_ch->free( vertices );
+	return result;
+}
+
+ch_t* ch_create( size_t num_states, const void* const* states, state_index_fxn_t state_index, nonnegative_cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free )
+{
+	ch_t* p_ch;
+	assert( num_states > 0 && num_states < CH_NONE );
+	assert( states );
+	assert( state_index );
+	assert( cost );
+	assert( successors_of );
+
+	p_ch = (ch_t*) alloc( sizeof(ch_t) );
+
+	if( p_ch )
+	{
+		memset( p_ch, 0, sizeof(ch_t) );
+		p_ch->alloc       = alloc;
+		p_ch->free        = free;
+		p_ch->state_index = state_index;
+		p_ch->num_states  = num_states;
+		p_ch->generation  = 0;
+		#ifdef DEBUG_CH
+		p_ch->bm          = bench_mark_create( "Contraction Hierarchies" );
+		#endif
+
+		p_ch->states   = (const void**) alloc( sizeof(const void*) * num_states );
+		p_ch->forward  = (ch_label_t*) alloc( sizeof(ch_label_t) * num_states );
+		p_ch->backward = (ch_label_t*) alloc( sizeof(ch_label_t) * num_states );
+
+		if( !p_ch->states || !p_ch->forward || !p_ch->backward ||
+		    !indexed_heap_create( &p_ch->forward_open, 128, offsetof(ch_label_t, open_index), best_cost_compare, alloc, free ) ||
+		    !indexed_heap_create( &p_ch->backward_open, 128, offsetof(ch_label_t, open_index), best_cost_compare, alloc, free ) )
+		{
+			ch_destroy( &p_ch );
+			return NULL;
+		}
+
+		memcpy( p_ch->states, states, sizeof(const void*) * num_states );
+		memset( p_ch->forward, 0, sizeof(ch_label_t) * num_states );
+		memset( p_ch->backward, 0, sizeof(ch_label_t) * num_states );
+
+		if( !ch_preprocess( p_ch, cost, successors_of ) )
+		{
+			ch_destroy( &p_ch );
+		}
+	}
+
+	return p_ch;
+}
+
+void ch_destroy( ch_t** p_ch )
+{
+	if( p_ch && *p_ch )
+	{
+		ch_t* p = *p_ch;
+
+		#ifdef DEBUG_CH
+		bench_mark_destroy( p->bm );
+		#endif
+
+		if( p->forward_open.array )  indexed_heap_destroy( &p->forward_open );
+		if( p->backward_open.array ) indexed_heap_destroy( &p->backward_open );
+		if( p->states )         p->free( (void*) p->states );
+		if( p->forward )        p->free( p->forward );
+		if( p->backward )       p->free( p->backward );
+		if( p->forward_first )  p->free( p->forward_first );
+		if( p->forward_arcs )   p->free( p->forward_arcs );
+		if( p->backward_first ) p->free( p->backward_first );
+		if( p->backward_arcs )  p->free( p->backward_arcs );
+		if( p->path )           p->free( p->path );
+		if( p->vertices )       p->free( p->vertices );
+		if( p->stack )          p->free( p->stack );
+
+		free_fxn_t _free = p->free;
+		_free( p );
+		*p_ch = NULL;
+	}
+}
+
+size_t ch_shortcuts( const ch_t* p_ch )
+{
+	assert( p_ch );
+	return p_ch->shortcuts;
+}
+
+/*
+ * One step of the search in one direction. Settles the closest
+ * vertex and relaxes the arcs that go up from it.
+ */
+static __inline void ch_step( ch_t* __restrict p_ch, ch_label_t* __restrict labels, indexed_heap_t* __restrict p_open, const ch_label_t* __restrict other, const uint32_t* __restrict first, const ch_arc_t* __restrict arcs, unsigned int* p_best, uint32_t* p_meet )
+{
+	ch_label_t* p_label = indexed_heap_pop( p_open );
+	uint32_t v          = (uint32_t) (p_label - labels);
+	uint32_t i;
+
+	/* the shortest path goes up to its highest ranked vertex and
+	 * then down, so the two searches meet there
+	 */
+	if( other[ v ].generation == p_ch->generation && p_label->d + other[ v ].d < *p_best )
+	{
+		*p_best = p_label->d + other[ v ].d;
+		*p_meet = v;
+	}
+
+	for( i = first[ v ]; i < first[ v + 1 ]; i++ )
+	{
+		ch_relax( p_ch, labels, p_open, arcs[ i ].vertex, p_label->d + arcs[ i ].cost, v, i );
+	}
+}
+
+/*
+ * Find the arc from tail to head among the arcs at vertex.
+ */
+static __inline const ch_arc_t* ch_find_arc( const uint32_t* __restrict first, const ch_arc_t* __restrict arcs, uint32_t vertex, uint32_t other )
+{
+	uint32_t i;
+
+	for( i = first[ vertex ]; i < first[ vertex + 1 ]; i++ )
+	{
+		if( arcs[ i ].vertex == other )
+		{
+			return &arcs[ i ];
+		}
+	}
+
+	assert( false );
+	return NULL;
+}
+
+/*
+ * Append the vertices after tail on the path that an arc stands
+ * for. A shortcut is split into its two arcs until only arcs of the
+ * original graph are left.
+ */
+static bool ch_unpack( ch_t* __restrict p_ch, size_t* p_count, uint32_t tail, uint32_t head, uint32_t middle )
+{
+	size_t top = 0;
+
+	if( !storage_reserve( (void**) &p_ch->stack, &p_ch->stack_capacity, 0, 1, sizeof(ch_arc_t), p_ch->alloc, p_ch->free ) )
+	{
+		return false;
+	}
+
+	/* a stack entry is an arc from the last vertex appended */
+	p_ch->stack[ top ].vertex = head;
+	p_ch->stack[ top ].middle = middle;
+	top++;
+
+	while( top > 0 )
+	{
+		ch_arc_t arc = p_ch->stack[ --top ];
+
+		if( arc.middle == CH_NONE )
+		{
+			if( !storage_reserve( (void**) &p_ch->vertices, &p_ch->vertices_capacity, *p_count, *p_count + 1, sizeof(uint32_t), p_ch->alloc, p_ch->free ) )
+			{
+				return false;
+			}
+
+			p_ch->vertices[ (*p_count)++ ] = arc.vertex;
+			tail = arc.vertex;
+		}
+		else
+		{
+			/* the middle vertex was contracted first, so both of
+			 * the arcs go up from it
+			 */
+			const ch_arc_t* p_first  = ch_find_arc( p_ch->backward_first, p_ch->backward_arcs, arc.middle, tail );
+			const ch_arc_t* p_second = ch_find_arc( p_ch->forward_first, p_ch->forward_arcs, arc.middle, arc.vertex );
+
+			if( !storage_reserve( (void**) &p_ch->stack, &p_ch->stack_capacity, top, top + 2, sizeof(ch_arc_t), p_ch->alloc, p_ch->free ) )
+			{
+				return false;
+			}
+
+			p_ch->stack[ top ].vertex = arc.vertex;
+			p_ch->stack[ top ].middle = p_second->middle;
+			top++;
+			p_ch->stack[ top ].vertex = arc.middle;
+			p_ch->stack[ top ].middle = p_first->middle;
+			top++;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * Turn the path through the meeting vertex into search nodes,
+ * unpacking every shortcut on the way.
+ */
+static bool ch_build_path( ch_t* __restrict p_ch, uint32_t start, uint32_t meet )
+{
+	size_t count = 0;
+	size_t up;
+	size_t i;
+	uint32_t v;
+
+	/* the upward half is walked back from the meeting vertex */
+	for( v = meet; v != start; v = p_ch->forward[ v ].parent )
+	{
+		if( !storage_reserve( (void**) &p_ch->vertices, &p_ch->vertices_capacity, count, count + 1, sizeof(uint32_t), p_ch->alloc, p_ch->free ) )
+		{
+			return false;
+		}
+
+		p_ch->vertices[ count++ ] = v;
+	}
+
+	if( !storage_reserve( (void**) &p_ch->vertices, &p_ch->vertices_capacity, count, count + 1, sizeof(uint32_t), p_ch->alloc, p_ch->free ) )
+	{
+		return false;
+	}
+
+	p_ch->vertices[ count++ ] = start;
+
+	/* the unpacked path is built after the reversed upward half */
+	up = count;
+
+	if( !storage_reserve( (void**) &p_ch->vertices, &p_ch->vertices_capacity, count, count + 1, sizeof(uint32_t), p_ch->alloc, p_ch->free ) )
+	{
+		return false;
+	}
+
+	p_ch->vertices[ count++ ] = start;
+
+	for( i = up - 1; i > 0; i-- )
+	{
+		uint32_t head             = p_ch->vertices[ i - 1 ];
+		const ch_label_t* p_label = &p_ch->forward[ head ];
+
+		if( !ch_unpack( p_ch, &count, p_label->parent, head, p_ch->forward_arcs[ p_label->parent_arc ].middle ) )
+		{
+			return false;
+		}
+	}
+
+	for( v = meet; p_ch->backward[ v ].parent_arc != CH_NONE; v = p_ch->backward[ v ].parent )
+	{
+		const ch_label_t* p_label = &p_ch->backward[ v ];
+
+		if( !ch_unpack( p_ch, &count, v, p_label->parent, p_ch->backward_arcs[ p_label->parent_arc ].middle ) )
+		{
+			return false;
+		}
+	}
+
+	count -= up;
+
+	if( !storage_reserve( (void**) &p_ch->path, &p_ch->path_capacity, 0, count, sizeof(ch_node_t), p_ch->alloc, p_ch->free ) )
+	{
+		return false;
+	}
+
+	/* the nodes run from the end to the start, like A* */
+	for( i = 0; i < count; i++ )
+	{
+		p_ch->path[ i ].state = p_ch->states[ p_ch->vertices[ up + count - 1 - i ] ];
+		p_ch->path[ i ].next  = i + 1 < count ? &p_ch->path[ i + 1 ] : NULL;
+	}
+
+	p_ch->node_path = &p_ch->path[ 0 ];
+	return true;
+}
+
+bool ch_find( ch_t* __restrict p_ch, const void* __restrict start, const void* __restrict end )
+{
+	uint32_t s;
+	uint32_t t;
+	uint32_t meet      = CH_NONE;
+	unsigned int best  = UINT_MAX;
+	bool found         = false;
+
+	#ifdef DEBUG_CH
+	bench_mark_start( p_ch->bm );
+	#endif
+	assert( p_ch );
+
+	ch_cleanup( p_ch );
+	ch_next_generation( p_ch );
+
+	s = (uint32_t) p_ch->state_index( start );
+	t = (uint32_t) p_ch->state_index( end );
+	assert( s < p_ch->num_states && t < p_ch->num_states );
+
+	ch_relax( p_ch, p_ch->forward, &p_ch->forward_open, s, 0, s, CH_NONE );
+	ch_relax( p_ch, p_ch->backward, &p_ch->backward_open, t, 0, t, CH_NONE );
+
+	/* Always settle the closer of the two open vertices, and stop
+	 * once neither search can lead to a better path.
+	 */
+	for( ;; )
+	{
+		const ch_label_t* p_forward  = indexed_heap_is_empty(&p_ch->forward_open) ? NULL : indexed_heap_peek(&p_ch->forward_open);
+		const ch_label_t* p_backward = indexed_heap_is_empty(&p_ch->backward_open) ? NULL : indexed_heap_peek(&p_ch->backward_open);
+
+		if( p_forward && (!p_backward || p_forward->d <= p_backward->d) )
+		{
+			if( p_forward->d >= best ) break;
+			ch_step( p_ch, p_ch->forward, &p_ch->forward_open, p_ch->backward, p_ch->forward_first, p_ch->forward_arcs, &best, &meet );
+		}
+		else if( p_backward )
+		{
+			if( p_backward->d >= best ) break;
+			ch_step( p_ch, p_ch->backward, &p_ch->backward_open, p_ch->forward, p_ch->backward_first, p_ch->backward_arcs, &best, &meet );
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	if( meet != CH_NONE )
+	{
+		p_ch->cost = best;
+		found      = ch_build_path( p_ch, s, meet );
+	}
+
+	#ifdef DEBUG_CH
+	bench_mark_end( p_ch->bm );
+	bench_mark_report( p_ch->bm );
+	#endif
+
+	return found;
+}
+
+unsigned int ch_cost( const ch_t* p_ch )
+{
+	assert( p_ch );
+	return p_ch->cost;
+}
+
+void ch_cleanup( ch_t* p_ch )
+{
+	assert( p_ch );
+	p_ch->node_path = NULL;
+	p_ch->cost      = 0;
+}
+
+ch_node_t* ch_first_node( const ch_t* p_ch )
+{
+	assert( p_ch );
+	return p_ch->node_path;
+}
+
+const void* ch_state( const ch_node_t* p_node )
+{
+	assert( p_node );
+	return p_node->state;
+}
+
+ch_node_t* ch_next_node( const ch_node_t* p_node )
+{
+	assert( p_node );
+	return p_node->next;
+}
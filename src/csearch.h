@@ -51,14 +51,23 @@ extern "C" {
 
 /*
  *  Successor Collection
+ *
+ *  A successors function either pushes states it owns, or calls
+ *  successors_emplace() to get a buffer for each successor's state
+ *  from the search. Emplaced states live until the search is
+ *  cleaned up, and the search reuses the buffer of a successor
+ *  that compares equal to a state it has already reached. For
+ *  emplaced states to be found again, the state hash function
+ *  must hash their contents, not their address.
  */
 struct successors;
 typedef struct successors successors_t;
 
-bool successors_push   ( successors_t* __restrict p_successors, const void* __restrict state );
-bool successors_pop    ( successors_t* p_successors );
-bool successors_resize ( successors_t* p_successors, size_t new_size );
-void successors_clear  ( successors_t* p_successors );
+bool  successors_push    ( successors_t* __restrict p_successors, const void* __restrict state );
+void* successors_emplace ( successors_t* __restrict p_successors, size_t size );
+bool  successors_pop     ( successors_t* p_successors );
+bool  successors_resize  ( successors_t* p_successors, size_t new_size );
+void  successors_clear   ( successors_t* p_successors );
 
 
 /*
@@ -67,6 +76,7 @@ void successors_clear  ( successors_t* p_successors );
 typedef void*        (*alloc_fxn_t)              ( size_t size );
 typedef void         (*free_fxn_t)               ( void *data );
 typedef size_t       (*state_hash_fxn_t)         ( const void* __restrict state );
+typedef size_t       (*state_index_fxn_t)        ( const void* __restrict state );
 typedef int          (*compare_fxn_t)            ( const void* __restrict state1, const void* __restrict state2 );
 typedef int          (*heuristic_fxn_t)          ( const void* __restrict state1, const void* __restrict state2 );
 typedef int          (*cost_fxn_t)               ( const void* __restrict state1, const void* __restrict state2 );
@@ -74,6 +84,61 @@ typedef unsigned int (*nonnegative_cost_fxn_t)   ( const void* __restrict state1
 typedef int          (*heuristic_comparer_fxn_t) ( int h1, int h2 );
 typedef void         (*successors_fxn_t)         ( const void* __restrict state, successors_t* __restrict p_successors );
 
+/*
+ *  State Pool
+ *
+ *  Interns fixed-size states. state_pool_intern() hashes the bytes
+ *  of a state and returns the pool's copy of it, storing the state
+ *  the first time it is seen. Equal states always intern to the
+ *  same pointer, so a search over interned states can hash and
+ *  compare the pointers, and a state reached along two paths is
+ *  found as a duplicate. Interned states are packed back to back
+ *  without headers and stay valid until the pool is cleared or
+ *  destroyed.
+ *
+ *  The start and end states given to a search must be interned
+ *  too. States are compared byte by byte, so padding bytes in a
+ *  state must be zeroed.
+ */
+struct state_pool;
+typedef struct state_pool state_pool_t;
+
+state_pool_t* state_pool_create     ( size_t state_size, alloc_fxn_t alloc, free_fxn_t free );
+void          state_pool_destroy    ( state_pool_t** p_pool );
+const void*   state_pool_intern     ( state_pool_t* __restrict p_pool, const void* __restrict state ); /* O(1) expected */
+const void*   state_pool_find       ( const state_pool_t* __restrict p_pool, const void* __restrict state ); /* O(1) expected */
+size_t        state_pool_size       ( const state_pool_t* p_pool );
+size_t        state_pool_state_size ( const state_pool_t* p_pool );
+void          state_pool_clear      ( state_pool_t* p_pool );
+
+/*
+ *  Open Lists
+ *
+ *  Dijkstra's algorithm and A* can keep their open list in one of
+ *  the following, chosen when the search is created.
+ *
+ *  - OPEN_LIST_BINARY_HEAP works with any costs. Pushing and
+ *    popping are O(lg N).
+ *  - OPEN_LIST_BUCKET_QUEUE keeps a circular array of buckets keyed
+ *    by F-value (cost for Dijkstra's algorithm), so pushing and
+ *    popping are O(1). Use it when costs are small non-negative
+ *    integers, like moves on a grid or in a puzzle. Nodes with the
+ *    same key are expanded last in, first out, which favors the
+ *    nodes nearest the goal.
+ *  - OPEN_LIST_RADIX_HEAP is for Dijkstra's algorithm only; A*
+ *    uses a binary heap instead. It relies on costs never going
+ *    below the last cost popped, which nonnegative edge costs
+ *    guarantee, and pops in O(lg C) amortized, where C is the
+ *    largest path cost, without calling a compare function. Use
+ *    it when costs are too spread out for a bucket queue, like
+ *    travel times on a road network.
+ */
+typedef enum open_list {
+	OPEN_LIST_BINARY_HEAP = 0,
+	OPEN_LIST_BUCKET_QUEUE,
+	OPEN_LIST_RADIX_HEAP
+} open_list_t;
+
 /*
  *  Breadth First Search Algorithm
  *
@@ -82,6 +147,10 @@ typedef void         (*successors_fxn_t)         ( const void* __restrict state,
  *  state, or all states have been examined. In other words, it
  *  exhaustively searches the entire graph or sequence without
  *  considering the goal until it finds it.
+ *
+ *  Visited states are kept in a hash table, or in a bitmap when
+ *  the search is created with breadthfs_create_indexed() and every
+ *  state has a dense ID.
  *  -----------------------------------------------------------
  *  Advantages
  *
@@ -100,6 +169,7 @@ struct breadthfs_node;
 typedef struct breadthfs_node breadthfs_node_t;
 
 breadthfs_t*      breadthfs_create             ( compare_fxn_t compare, state_hash_fxn_t state_hasher, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free );
+breadthfs_t*      breadthfs_create_indexed     ( size_t num_states, state_index_fxn_t state_index, compare_fxn_t compare, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free );
 void              breadthfs_destroy            ( breadthfs_t** p_bfs );
 void              breadthfs_set_compare_fxn    ( breadthfs_t* p_bfs, compare_fxn_t compare );
 void              breadthfs_set_successors_fxn ( breadthfs_t* p_bfs, successors_fxn_t successors_of );
@@ -112,12 +182,56 @@ void              breadthfs_iterative_init     ( breadthfs_t* __restrict p_bfs,
 void              breadthfs_iterative_find     ( breadthfs_t* __restrict p_bfs, const void* __restrict start, const void* __restrict end, bool* __restrict found );
 bool              breadthfs_iterative_is_done  ( breadthfs_t* __restrict p_bfs, bool* __restrict found );
 
+/*
+ *  Parallel Breadth First Search
+ *
+ *  Expands one level of the search at a time on several threads.
+ *  Each thread takes chunks of the current level, and the next
+ *  level is built from per-thread buffers after duplicates are
+ *  dropped through a shared visited set. Passing NULL for the end
+ *  state visits every state reachable from the start, and the
+ *  number of states first reached at each depth can be read
+ *  afterwards with pbfs_levels() and pbfs_level_size().
+ *  -----------------------------------------------------------
+ *  Advantages
+ *
+ *  - Like Breadth First Search, the path found has the fewest
+ *    steps.
+ *  - Large graphs are expanded on every core.
+ *  -----------------------------------------------------------
+ *  Disadvantages
+ *
+ *  - Every level is finished before the goal is reported, and
+ *    all threads wait for each other between levels.
+ *  - The callbacks must be safe to call from several threads at
+ *    once, and equal states must have the same hash.
+ */
+struct pbfs_algorithm;
+typedef struct pbfs_algorithm pbfs_t;
+
+struct pbfs_node;
+typedef struct pbfs_node pbfs_node_t;
+
+pbfs_t*      pbfs_create             ( size_t threads, compare_fxn_t compare, state_hash_fxn_t state_hasher, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free );
+void         pbfs_destroy            ( pbfs_t** p_pbfs );
+bool         pbfs_find               ( pbfs_t* __restrict p_pbfs, const void* __restrict start, const void* __restrict end );
+void         pbfs_cleanup            ( pbfs_t* p_pbfs );
+pbfs_node_t* pbfs_first_node         ( const pbfs_t* p_pbfs );
+const void*  pbfs_state              ( const pbfs_node_t* p_node );
+pbfs_node_t* pbfs_next_node          ( const pbfs_node_t* p_node );
+size_t       pbfs_levels             ( const pbfs_t* p_pbfs );
+size_t       pbfs_level_size         ( const pbfs_t* p_pbfs, size_t level );
+
 
 /*
  *  Depth First Search Algorithm
  *
  *  Depth First Search is an uninformed search method that explores
  *  as far as possible along each branch before backtracking.
+ *
+ *  Visited states are kept in a hash table, or in a bitmap when
+ *  the search is created with depthfs_create_indexed() and every
+ *  state has a dense ID.
  *  -----------------------------------------------------------
  *  Advantages
  *
@@ -136,6 +250,7 @@ struct depthfs_node;
 typedef struct depthfs_node depthfs_node_t;
 
 depthfs_t*      depthfs_create             ( compare_fxn_t compare, state_hash_fxn_t state_hasher, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free );
+depthfs_t*      depthfs_create_indexed     ( size_t num_states, state_index_fxn_t state_index, compare_fxn_t compare, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free );
 void            depthfs_destroy            ( depthfs_t** p_bfs );
 void            depthfs_set_compare_fxn    ( depthfs_t* p_bfs, compare_fxn_t compare );
 void            depthfs_set_successors_fxn ( depthfs_t* p_bfs, successors_fxn_t successors_of );
@@ -215,6 +330,17 @@ bool           bestfs_iterative_is_done  ( bestfs_t* __restrict p_best, bool* __
  *  - Requires initialization step to set the cost to infinity.
  *  - If the algorithm needs to be used over and over again, this
  *    is some overhead we can live without.
+ *  -----------------------------------------------------------
+ *  dijkstra_compute_all() searches from the source until every
+ *  reachable state is closed, for the dense state ID mode. It
+ *  writes the cost of reaching the state with ID i to
+ *  distances[ i ], or UINT_MAX if it cannot be reached, and the ID
+ *  of the state before it on its shortest path to parents[ i ], or
+ *  SIZE_MAX for the source and for states that cannot be reached.
+ *  Either array may be NULL. It returns the number of states
+ *  reached. When the edges go both ways, parents[ i ] is the next
+ *  move from state i toward the source, so one call guides every
+ *  agent headed to the same goal.
  */
 struct dijkstra_algorithm;
 typedef struct dijkstra_algorithm dijkstra_t;
@@ -223,11 +349,15 @@ struct dijkstra_node;
 typedef struct dijkstra_node dijkstra_node_t;
 
 dijkstra_t*      dijkstra_create             ( compare_fxn_t compare, state_hash_fxn_t state_hasher, nonnegative_cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free );
+dijkstra_t*      dijkstra_create_indexed     ( size_t num_states, state_index_fxn_t state_index, compare_fxn_t compare, nonnegative_cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free );
+dijkstra_t*      dijkstra_create_ex          ( open_list_t open_list, compare_fxn_t compare, state_hash_fxn_t state_hasher, nonnegative_cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free );
+dijkstra_t*      dijkstra_create_indexed_ex  ( open_list_t open_list, size_t num_states, state_index_fxn_t state_index, compare_fxn_t compare, nonnegative_cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free );
 void             dijkstra_destroy            ( dijkstra_t** p_dijkstra );
 void             dijkstra_set_compare_fxn    ( dijkstra_t* p_dijkstra, compare_fxn_t compare );
 void             dijkstra_set_cost_fxn       ( dijkstra_t* p_dijkstra, nonnegative_cost_fxn_t cost );
 void             dijkstra_set_successors_fxn ( dijkstra_t* p_dijkstra, successors_fxn_t successors_of );
 bool             dijkstra_find               ( dijkstra_t* __restrict p_dijkstra, const void* __restrict start, const void* __restrict end );
+size_t           dijkstra_compute_all        ( dijkstra_t* __restrict p_dijkstra, const void* __restrict source, unsigned int* __restrict distances, size_t* __restrict parents ); /* O(N lg N) */
 void             dijkstra_cleanup            ( dijkstra_t* p_dijkstra );
 dijkstra_node_t* dijkstra_first_node         ( const dijkstra_t* p_dijkstra );
 const void*      dijkstra_state              ( const dijkstra_node_t* p_node );
@@ -269,15 +399,58 @@ bool             dijkstra_iterative_is_done  ( dijkstra_t* __restrict p_dijkstra
  *    used to find a closer sub-start node that can then be fed
  *    into the A* algorithm to produce an intelligent path closer
  *    to the goal node.
+ *  -----------------------------------------------------------
+ *  Dense State IDs
+ *
+ *  - If every state maps to a unique integer in [0, num_states),
+ *    use astar_create_indexed(). Nodes are kept in a flat array
+ *    and no hashing is done during the search.
+ *  -----------------------------------------------------------
+ *  Batches
+ *
+ *  - astar_find_batch() runs many independent queries on several
+ *    threads. The extra threads search with copies of the engine
+ *    that are created on first use and kept until the engine is
+ *    destroyed. The callbacks must be safe to call from several
+ *    threads at once.
+ *  -----------------------------------------------------------
+ *  Configurations and Contexts
+ *
+ *  - An astar_config_t holds the callbacks and options of a
+ *    problem. An astar_context_t holds the open list, the state
+ *    table and the other buffers of one search. Create one
+ *    context per thread from a shared configuration and keep it
+ *    between queries so its buffers stay allocated. A context is
+ *    an astar_t, so every astar_* function works on it.
  */
 struct astar_algorithm;
 typedef struct astar_algorithm astar_t;
+typedef struct astar_algorithm astar_context_t;
+
+struct astar_config;
+typedef struct astar_config astar_config_t;
 
 struct astar_node;
 typedef struct astar_node astar_node_t;
 
+typedef struct astar_query {
+	const void*  start;
+	const void*  end;
+	const void** path; /* filled with the path from start to end */
+	size_t       path_capacity; /* number of states path can hold */
+	size_t       path_length; /* states on the path, which may exceed path_capacity */
+	bool         found;
+} astar_query_t;
+
 astar_t*      astar_create             ( compare_fxn_t compare, state_hash_fxn_t state_hasher, heuristic_fxn_t heuristic, cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free );
+astar_t*      astar_create_indexed     ( size_t num_states, state_index_fxn_t state_index, compare_fxn_t compare, heuristic_fxn_t heuristic, cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free );
+astar_t*      astar_create_ex          ( open_list_t open_list, compare_fxn_t compare, state_hash_fxn_t state_hasher, heuristic_fxn_t heuristic, cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free );
+astar_t*      astar_create_indexed_ex  ( open_list_t open_list, size_t num_states, state_index_fxn_t state_index, compare_fxn_t compare, heuristic_fxn_t heuristic, cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free );
 void          astar_destroy            ( astar_t** p_astar );
+astar_config_t*  astar_config_create         ( open_list_t open_list, compare_fxn_t compare, state_hash_fxn_t state_hasher, heuristic_fxn_t heuristic, cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free );
+astar_config_t*  astar_config_create_indexed ( open_list_t open_list, size_t num_states, state_index_fxn_t state_index, compare_fxn_t compare, heuristic_fxn_t heuristic, cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free );
+void             astar_config_destroy        ( astar_config_t** p_config );
+astar_context_t* astar_context_create        ( const astar_config_t* p_config );
 void          astar_set_compare_fxn    ( astar_t* p_astar, compare_fxn_t compare );
 void          astar_set_heuristic_fxn  ( astar_t* p_astar, heuristic_fxn_t heuristic );
 void          astar_set_cost_fxn       ( astar_t* p_astar, cost_fxn_t cost );
@@ -290,6 +463,284 @@ astar_node_t* astar_next_node          ( const astar_node_t* p_node );
 void          astar_iterative_init     ( astar_t* __restrict p_astar, const void* __restrict start, const void* __restrict end, bool* found );
 void          astar_iterative_find     ( astar_t* __restrict p_astar, const void* __restrict start, const void* __restrict end, bool* found );
 bool          astar_iterative_is_done  ( astar_t* __restrict p_astar, bool* found );
+bool          astar_find_batch         ( astar_t* __restrict p_astar, astar_query_t* __restrict queries, size_t count, size_t threads );
+
+/*
+ *  Iterative Deepening A* (IDA*)
+ *
+ *  IDA* runs a series of depth-first searches, each one cut off
+ *  where f = g + h exceeds a bound. The first bound is the start
+ *  state's heuristic and each iteration raises it to the smallest
+ *  f that was cut off, so the first path found is optimal when
+ *  the heuristic is admissible.
+ *  -----------------------------------------------------------
+ *  Advantages
+ *
+ *  - Memory is proportional to the depth of the solution rather
+ *    than the number of states generated, so it can solve
+ *    problems like the 15-puzzle that exhaust memory with A*.
+ *  - Once the search has been as deep as it needs to be, no
+ *    memory is allocated while searching.
+ *  -----------------------------------------------------------
+ *  Disadvantages
+ *
+ *  - States are not remembered, so states reachable by several
+ *    paths are searched again; only moving straight back to the
+ *    previous state is pruned. This makes it a poor fit for
+ *    graphs with many cycles, like grids.
+ *  - Every iteration repeats the work of the previous ones.
+ */
+struct idastar_algorithm;
+typedef struct idastar_algorithm idastar_t;
+
+struct idastar_node;
+typedef struct idastar_node idastar_node_t;
+
+idastar_t*      idastar_create             ( compare_fxn_t compare, heuristic_fxn_t heuristic, cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free );
+void            idastar_destroy            ( idastar_t** p_idastar );
+void            idastar_set_compare_fxn    ( idastar_t* p_idastar, compare_fxn_t compare );
+void            idastar_set_heuristic_fxn  ( idastar_t* p_idastar, heuristic_fxn_t heuristic );
+void            idastar_set_cost_fxn       ( idastar_t* p_idastar, cost_fxn_t cost );
+void            idastar_set_successors_fxn ( idastar_t* p_idastar, successors_fxn_t successors_of );
+bool            idastar_find               ( idastar_t* __restrict p_idastar, const void* __restrict start, const void* __restrict end );
+void            idastar_cleanup            ( idastar_t* p_idastar );
+idastar_node_t* idastar_first_node         ( const idastar_t* p_idastar );
+const void*     idastar_state              ( const idastar_node_t* p_node );
+idastar_node_t* idastar_next_node          ( const idastar_node_t* p_node );
+
+void            idastar_iterative_init     ( idastar_t* __restrict p_idastar, const void* __restrict start, const void* __restrict end, bool* found );
+void            idastar_iterative_find     ( idastar_t* __restrict p_idastar, const void* __restrict start, const void* __restrict end, bool* found );
+bool            idastar_iterative_is_done  ( idastar_t* __restrict p_idastar, bool* found );
+
+/*
+ *  Hash Distributed A* (HDA*)
+ *
+ *  HDA* runs one A* search on several threads. Every state is
+ *  owned by one thread, chosen by hashing the state, and that
+ *  thread alone keeps its node. Successors that belong to other
+ *  threads are sent to them through lock-free queues.
+ *  -----------------------------------------------------------
+ *  Advantages
+ *
+ *  - Large searches are spread over every core, and no lock is
+ *    taken while states are expanded.
+ *  - Like A*, the path found is the shortest when the heuristic
+ *    is admissible.
+ *  -----------------------------------------------------------
+ *  Disadvantages
+ *
+ *  - Threads cannot stop at the first path they find, so some
+ *    states are expanded that A* would not expand, and a state
+ *    can be expanded again when a cheaper path to it arrives
+ *    from another thread.
+ *  - Small searches are slower than A* because of the cost of
+ *    starting threads and passing messages.
+ *  - The callbacks must be safe to call from several threads at
+ *    once, and equal states must have the same hash.
+ */
+struct hdastar_algorithm;
+typedef struct hdastar_algorithm hdastar_t;
+
+struct hdastar_node;
+typedef struct hdastar_node hdastar_node_t;
+
+hdastar_t*      hdastar_create             ( size_t threads, compare_fxn_t compare, state_hash_fxn_t state_hasher, heuristic_fxn_t heuristic, cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free );
+void            hdastar_destroy            ( hdastar_t** p_hda );
+bool            hdastar_find               ( hdastar_t* __restrict p_hda, const void* __restrict start, const void* __restrict end );
+void            hdastar_cleanup            ( hdastar_t* p_hda );
+hdastar_node_t* hdastar_first_node         ( const hdastar_t* p_hda );
+const void*     hdastar_state              ( const hdastar_node_t* p_node );
+hdastar_node_t* hdastar_next_node          ( const hdastar_node_t* p_node );
+
+/*
+ *  Bidirectional Search
+ *
+ *  Runs A* forward from the start and backward from the end at the
+ *  same time, alternating between the two, and stops once no path
+ *  through the open nodes can beat the best path where the searches
+ *  met. Each search only has to reach about halfway, so on large
+ *  graphs far fewer nodes are expanded than with a single search.
+ *  -----------------------------------------------------------
+ *  Besides the successors function, the search needs a function
+ *  that returns the predecessors of a state: the states that have
+ *  an edge to it. cost(a, b) is always called with an edge going
+ *  from a to b. For undirected graphs, pass the successors function
+ *  as the predecessors function too.
+ *  -----------------------------------------------------------
+ *  Both searches are guided by the average of heuristic(state, end)
+ *  and heuristic(start, state). Pass a NULL heuristic to get a
+ *  bidirectional Dijkstra's algorithm. The path is only guaranteed
+ *  to be shortest when the heuristic is consistent.
+ *  -----------------------------------------------------------
+ *  The path returned by bidir_first_node() and bidir_next_node()
+ *  runs from the end to the start, like A*.
+ */
+struct bidir_algorithm;
+typedef struct bidir_algorithm bidir_t;
+
+struct bidir_node;
+typedef struct bidir_node bidir_node_t;
+
+bidir_t*      bidir_create               ( compare_fxn_t compare, state_hash_fxn_t state_hasher, heuristic_fxn_t heuristic, cost_fxn_t cost, successors_fxn_t successors_of, successors_fxn_t predecessors_of, alloc_fxn_t alloc, free_fxn_t free );
+void          bidir_destroy              ( bidir_t** p_bidir );
+void          bidir_set_compare_fxn      ( bidir_t* p_bidir, compare_fxn_t compare );
+void          bidir_set_heuristic_fxn    ( bidir_t* p_bidir, heuristic_fxn_t heuristic );
+void          bidir_set_cost_fxn         ( bidir_t* p_bidir, cost_fxn_t cost );
+void          bidir_set_successors_fxn   ( bidir_t* p_bidir, successors_fxn_t successors_of );
+void          bidir_set_predecessors_fxn ( bidir_t* p_bidir, successors_fxn_t predecessors_of );
+bool          bidir_find                 ( bidir_t* __restrict p_bidir, const void* __restrict start, const void* __restrict end );
+void          bidir_cleanup              ( bidir_t* p_bidir );
+bidir_node_t* bidir_first_node           ( const bidir_t* p_bidir );
+const void*   bidir_state                ( const bidir_node_t* p_node );
+bidir_node_t* bidir_next_node            ( const bidir_node_t* p_node );
+void          bidir_iterative_init       ( bidir_t* __restrict p_bidir, const void* __restrict start, const void* __restrict end, bool* found );
+void          bidir_iterative_find       ( bidir_t* __restrict p_bidir, const void* __restrict start, const void* __restrict end, bool* found );
+bool          bidir_iterative_is_done    ( bidir_t* __restrict p_bidir, bool* found );
+
+
+/*
+ *  Contraction Hierarchies
+ *
+ *  Preprocesses a static graph so that shortest path queries only
+ *  look at a tiny part of it. The vertices are contracted one at a
+ *  time, least important first; contracting a vertex adds shortcut
+ *  edges between its neighbors wherever it was on their only
+ *  shortest path. A query runs Dijkstra's algorithm forward from
+ *  the start and backward from the end, only ever going up to more
+ *  important vertices, and the two searches meet at the top of the
+ *  shortest path.
+ *  -----------------------------------------------------------
+ *  The graph is read once through the successors and cost
+ *  functions, and does not change afterwards. States need dense
+ *  IDs, like the indexed searches, and states[ id ] is the state
+ *  with that ID; the states are returned on paths and must outlive
+ *  the hierarchy. Edges may be directed.
+ *  -----------------------------------------------------------
+ *  Advantages
+ *  	- Queries on road networks take microseconds instead of
+ *  	  milliseconds.
+ *  	- Shortcuts are unpacked, so the path returned by
+ *  	  ch_first_node() and ch_next_node() has every state, from
+ *  	  the end to the start like A*.
+ *
+ *  Disadvantages
+ *  	- Building the hierarchy is slow, and has to be redone when
+ *  	  the graph changes.
+ *  	- It works best on graphs with a natural hierarchy, like road
+ *  	  networks; grids with uniform costs get many shortcuts.
+ */
+struct ch_algorithm;
+typedef struct ch_algorithm ch_t;
+
+struct ch_node;
+typedef struct ch_node ch_node_t;
+
+ch_t*        ch_create     ( size_t num_states, const void* const* states, state_index_fxn_t state_index, nonnegative_cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free );
+void         ch_destroy    ( ch_t** p_ch );
+size_t       ch_shortcuts  ( const ch_t* p_ch );
+bool         ch_find       ( ch_t* __restrict p_ch, const void* __restrict start, const void* __restrict end );
+unsigned int ch_cost       ( const ch_t* p_ch );
+void         ch_cleanup    ( ch_t* p_ch );
+ch_node_t*   ch_first_node ( const ch_t* p_ch );
+const void*  ch_state      ( const ch_node_t* p_node );
+ch_node_t*   ch_next_node  ( const ch_node_t* p_node );
+
+/*
+ *  Compressed Path Database
+ *
+ *  Stores the first move of a shortest path from every state to
+ *  every other state. One Dijkstra's algorithm search is run from
+ *  each state, and the first moves it finds are run-length encoded
+ *  over the targets, ordered by a depth first walk so that nearby
+ *  targets, which mostly share a first move, form long runs. A
+ *  query finds the run that holds its target with a binary search.
+ *  -----------------------------------------------------------
+ *  The graph is read through the successors and cost functions
+ *  and does not change afterwards. States need dense IDs, like the
+ *  indexed searches, and states[ id ] is the state with that ID;
+ *  the states are returned by queries and must outlive the
+ *  database. Edges may be directed. A database can be saved to a
+ *  file and loaded again with the same states; cpd_load() checks
+ *  the whole file and returns NULL if it is damaged.
+ *  -----------------------------------------------------------
+ *  Advantages
+ *  	- cpd_next_move() gives the next state toward any target in
+ *  	  O(lg R) time, where R is the number of runs of the state.
+ *  	- cpd_find() follows the first moves to the target, and the
+ *  	  path from cpd_first_node() and cpd_next_node() runs from
+ *  	  the end to the start like A*.
+ *
+ *  Disadvantages
+ *  	- Building the database runs a search from every state, so
+ *  	  it takes O(N) searches.
+ *  	- It has at least one run per state and usually many more;
+ *  	  it is meant for maps of up to some hundred thousand states.
+ */
+struct compressed_path_database;
+typedef struct compressed_path_database cpd_t;
+
+struct cpd_node;
+typedef struct cpd_node cpd_node_t;
+
+cpd_t*       cpd_create     ( size_t num_states, const void* const* states, state_index_fxn_t state_index, compare_fxn_t compare, nonnegative_cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free );
+cpd_t*       cpd_load       ( const char* __restrict filename, size_t num_states, const void* const* states, state_index_fxn_t state_index, alloc_fxn_t alloc, free_fxn_t free );
+bool         cpd_save       ( const cpd_t* __restrict p_cpd, const char* __restrict filename );
+void         cpd_destroy    ( cpd_t** p_cpd );
+size_t       cpd_runs       ( const cpd_t* p_cpd );
+const void*  cpd_next_move  ( const cpd_t* __restrict p_cpd, const void* __restrict state, const void* __restrict end ); /* O(lg R) */
+bool         cpd_find       ( cpd_t* __restrict p_cpd, const void* __restrict start, const void* __restrict end );
+void         cpd_cleanup    ( cpd_t* p_cpd );
+cpd_node_t*  cpd_first_node ( const cpd_t* p_cpd );
+const void*  cpd_state      ( const cpd_node_t* p_node );
+cpd_node_t*  cpd_next_node  ( const cpd_node_t* p_node );
+
+/*
+ *  Jump Point Search
+ *
+ *  An A* search specialized for uniform-cost grids. Moves are
+ *  8-connected; straight moves cost 10 and diagonal moves cost 14,
+ *  and a diagonal move is only allowed when both of the cells it
+ *  passes between are walkable (no corner cutting). Instead of
+ *  expanding every neighbor, JPS scans along straight and diagonal
+ *  lines and only adds the cells where the path may have to turn
+ *  (jump points) to the open list. On open maps this expands far
+ *  fewer nodes than A*.
+ *  -----------------------------------------------------------
+ *  States are cell indices (y * width + x). The path returned by
+ *  jps_first_node() and jps_next_node() consists of jump points;
+ *  consecutive nodes are always connected by a straight or
+ *  diagonal line of walkable cells.
+ *  -----------------------------------------------------------
+ *  The walkable bitmap holds one bit per cell in row-major order;
+ *  cell i is walkable if bit (i & 7) of byte (i >> 3) is set. The
+ *  bitmap is copied when the engine is created, so call
+ *  jps_set_grid() after changing it.
+ */
+struct jps_algorithm;
+typedef struct jps_algorithm jps_t;
+
+struct jps_node;
+typedef struct jps_node jps_node_t;
+
+typedef struct jps_grid {
+	size_t width;
+	size_t height;
+	const unsigned char* walkable;
+} jps_grid_t;
+
+#define jps_bitmap_size( width, height )   (((width) * (height) + 7) / 8)
+
+jps_t*      jps_create             ( const jps_grid_t* p_grid, alloc_fxn_t alloc, free_fxn_t free );
+void        jps_destroy            ( jps_t** p_jps );
+bool        jps_set_grid           ( jps_t* __restrict p_jps, const jps_grid_t* __restrict p_grid );
+bool        jps_find               ( jps_t* __restrict p_jps, size_t start, size_t end );
+void        jps_cleanup            ( jps_t* p_jps );
+jps_node_t* jps_first_node         ( const jps_t* p_jps );
+size_t      jps_state              ( const jps_node_t* p_node );
+jps_node_t* jps_next_node          ( const jps_node_t* p_node );
+void        jps_iterative_init     ( jps_t* __restrict p_jps, size_t start, size_t end, bool* found );
+void        jps_iterative_find     ( jps_t* __restrict p_jps, size_t start, size_t end, bool* found );
+bool        jps_iterative_is_done  ( jps_t* __restrict p_jps, bool* found );
 
 
 /*
@@ -301,6 +752,13 @@ bool          astar_iterative_is_done  ( astar_t* __restrict p_astar, bool* foun
 	depthfs_t**: depthfs_destroy, \
 	bestfs_t**: bestfs_destroy, \
 	dijkstra_t**: dijkstra_destroy, \
+	idastar_t**: idastar_destroy, \
+	bidir_t**: bidir_destroy, \
+	ch_t**: ch_destroy, \
+	cpd_t**: cpd_destroy, \
+	jps_t**: jps_destroy, \
+	hdastar_t**: hdastar_destroy, \
+	pbfs_t**: pbfs_destroy, \
 	astar_t**: astar_destroy \
 	)( X )
 #define csearch_set_compare_fxn( X, compare_fxn ) _Generic( (X), \
@@ -308,6 +766,8 @@ bool          astar_iterative_is_done  ( astar_t* __restrict p_astar, bool* foun
 	depthfs_t*: depthfs_set_compare_fxn, \
 	bestfs_t*: bestfs_set_compare_fxn, \
 	dijkstra_t*: dijkstra_set_compare_fxn, \
+	idastar_t*: idastar_set_compare_fxn, \
+	bidir_t*: bidir_set_compare_fxn, \
 	astar_t*: astar_set_compare_fxn \
 	)( X, compare_fxn )
 #define csearch_set_successors_fxn( X, successors_fxn ) _Generic( (X), \
@@ -315,14 +775,20 @@ bool          astar_iterative_is_done  ( astar_t* __restrict p_astar, bool* foun
 	depthfs_t*: depthfs_set_successors_fxn, \
 	bestfs_t*: bestfs_set_successors_fxn, \
 	dijkstra_t*: dijkstra_set_successors_fxn, \
+	idastar_t*: idastar_set_successors_fxn, \
+	bidir_t*: bidir_set_successors_fxn, \
 	astar_t*: astar_set_successors_fxn \
 	)( X, successors_fxn )
 #define csearch_set_heuristic_fxn( X, heuristic_fxn ) _Generic( (X), \
 	bestfs_t*: bestfs_set_heuristic_fxn, \
+	idastar_t*: idastar_set_heuristic_fxn, \
+	bidir_t*: bidir_set_heuristic_fxn, \
 	astar_t*: astar_set_heuristic_fxn \
 	)( X, heuristic_fxn )
 #define csearch_set_cost_fxn( X, cost_fxn ) _Generic( (X), \
 	dijkstra_t*: dijkstra_set_cost_fxn, \
+	idastar_t*: idastar_set_cost_fxn, \
+	bidir_t*: bidir_set_cost_fxn, \
 	astar_t*: astar_set_cost_fxn \
 	)( X, cost_fxn )
 #define csearch_find( X, start, end ) _Generic( (X), \
@@ -330,6 +796,13 @@ bool          astar_iterative_is_done  ( astar_t* __restrict p_astar, bool* foun
 	depthfs_t*: depthfs_find, \
 	bestfs_t*: bestfs_find, \
 	dijkstra_t*: dijkstra_find, \
+	idastar_t*: idastar_find, \
+	bidir_t*: bidir_find, \
+	ch_t*: ch_find, \
+	cpd_t*: cpd_find, \
+	jps_t*: jps_find, \
+	hdastar_t*: hdastar_find, \
+	pbfs_t*: pbfs_find, \
 	astar_t*: astar_find \
 	)( X, start, end )
 #define csearch_cleanup( X ) _Generic( (X), \
@@ -337,6 +810,13 @@ bool          astar_iterative_is_done  ( astar_t* __restrict p_astar, bool* foun
 	depthfs_t*: depthfs_cleanup, \
 	bestfs_t*: bestfs_cleanup, \
 	dijkstra_t*: dijkstra_cleanup, \
+	idastar_t*: idastar_cleanup, \
+	bidir_t*: bidir_cleanup, \
+	ch_t*: ch_cleanup, \
+	cpd_t*: cpd_cleanup, \
+	jps_t*: jps_cleanup, \
+	hdastar_t*: hdastar_cleanup, \
+	pbfs_t*: pbfs_cleanup, \
 	astar_t*: astar_cleanup \
 	)( X )
 #define csearch_first_node( X ) _Generic( (X), \
@@ -344,6 +824,13 @@ bool          astar_iterative_is_done  ( astar_t* __restrict p_astar, bool* foun
 	depthfs_t*: depthfs_first_node, \
 	bestfs_t*: bestfs_first_node, \
 	dijkstra_t*: dijkstra_first_node, \
+	idastar_t*: idastar_first_node, \
+	bidir_t*: bidir_first_node, \
+	ch_t*: ch_first_node, \
+	cpd_t*: cpd_first_node, \
+	jps_t*: jps_first_node, \
+	hdastar_t*: hdastar_first_node, \
+	pbfs_t*: pbfs_first_node, \
 	astar_t*: astar_first_node \
 	)( X )
 #define csearch_state( X ) _Generic( (X), \
@@ -351,6 +838,13 @@ bool          astar_iterative_is_done  ( astar_t* __restrict p_astar, bool* foun
 	depthfs_node_t*: depthfs_state, \
 	bestfs_node_t*: bestfs_state, \
 	dijkstra_node_t*: dijkstra_state, \
+	idastar_node_t*: idastar_state, \
+	bidir_node_t*: bidir_state, \
+	ch_node_t*: ch_state, \
+	cpd_node_t*: cpd_state, \
+	jps_node_t*: jps_state, \
+	hdastar_node_t*: hdastar_state, \
+	pbfs_node_t*: pbfs_state, \
 	astar_node_t*: astar_state \
 	)( X )
 #define csearch_next_node( X ) _Generic( (X), \
@@ -358,6 +852,13 @@ bool          astar_iterative_is_done  ( astar_t* __restrict p_astar, bool* foun
 	depthfs_node_t*: depthfs_next_node, \
 	bestfs_node_t*: bestfs_next_node, \
 	dijkstra_node_t*: dijkstra_next_node, \
+	idastar_node_t*: idastar_next_node, \
+	bidir_node_t*: bidir_next_node, \
+	ch_node_t*: ch_next_node, \
+	cpd_node_t*: cpd_next_node, \
+	jps_node_t*: jps_next_node, \
+	hdastar_node_t*: hdastar_next_node, \
+	pbfs_node_t*: pbfs_next_node, \
 	astar_node_t*: astar_next_node \
 	)( X )
 #define csearch_iterative_init( X, start, end, found ) _Generic( (X), \
@@ -365,6 +866,9 @@ bool          astar_iterative_is_done  ( astar_t* __restrict p_astar, bool* foun
 	depthfs_t*: depthfs_iterative_init, \
 	bestfs_t*: bestfs_iterative_init, \
 	dijkstra_t*: dijkstra_iterative_init, \
+	idastar_t*: idastar_iterative_init, \
+	bidir_t*: bidir_iterative_init, \
+	jps_t*: jps_iterative_init, \
 	astar_t*: astar_iterative_init \
 	)( X, start, end, found )
 #define csearch_iterative_find( X, start, end, found ) _Generic( (X), \
@@ -372,6 +876,9 @@ bool          astar_iterative_is_done  ( astar_t* __restrict p_astar, bool* foun
 	depthfs_t*: depthfs_iterative_find, \
 	bestfs_t*: bestfs_iterative_find, \
 	dijkstra_t*: dijkstra_iterative_find, \
+	idastar_t*: idastar_iterative_find, \
+	bidir_t*: bidir_iterative_find, \
+	jps_t*: jps_iterative_find, \
 	astar_t*: astar_iterative_find \
 	)( X, start, end, found )
 #define csearch_iterative_is_done( X, found ) _Generic( (X), \
@@ -379,6 +886,9 @@ bool          astar_iterative_is_done  ( astar_t* __restrict p_astar, bool* foun
 	depthfs_t*: depthfs_iterative_is_done, \
 	bestfs_t*: bestfs_iterative_is_done, \
 	dijkstra_t*: dijkstra_iterative_is_done, \
+	idastar_t*: idastar_iterative_is_done, \
+	bidir_t*: bidir_iterative_is_done, \
+	jps_t*: jps_iterative_is_done, \
 	astar_t*: astar_iterative_is_done \
 	)( X, found )
 #endif
@@ -390,21 +900,36 @@ bool          astar_iterative_is_done  ( astar_t* __restrict p_astar, bool* foun
 namespace csearch {
 	using ::successors_t;
 	using ::successors_push;
+	using ::successors_emplace;
 	using ::successors_pop;
 	using ::successors_resize;
 	using ::successors_clear;
 	using ::alloc_fxn_t;
 	using ::free_fxn_t;
 	using ::state_hash_fxn_t;
+	using ::state_index_fxn_t;
 	using ::compare_fxn_t;
 	using ::heuristic_fxn_t;
 	using ::cost_fxn_t;
 	using ::nonnegative_cost_fxn_t;
 	using ::heuristic_comparer_fxn_t;
 	using ::successors_fxn_t;
+	using ::state_pool_t;
+	using ::state_pool_create;
+	using ::state_pool_destroy;
+	using ::state_pool_intern;
+	using ::state_pool_find;
+	using ::state_pool_size;
+	using ::state_pool_state_size;
+	using ::state_pool_clear;
+	using ::open_list_t;
+	using ::OPEN_LIST_BINARY_HEAP;
+	using ::OPEN_LIST_BUCKET_QUEUE;
+	using ::OPEN_LIST_RADIX_HEAP;
 	using ::breadthfs_t;
 	using ::breadthfs_node_t;
 	using ::breadthfs_create;
+	using ::breadthfs_create_indexed;
 	using ::breadthfs_destroy;
 	using ::breadthfs_set_compare_fxn;
 	using ::breadthfs_set_successors_fxn;
@@ -416,9 +941,21 @@ namespace csearch {
 	using ::breadthfs_iterative_init;
 	using ::breadthfs_iterative_find;
 	using ::breadthfs_iterative_is_done;
+	using ::pbfs_t;
+	using ::pbfs_node_t;
+	using ::pbfs_create;
+	using ::pbfs_destroy;
+	using ::pbfs_find;
+	using ::pbfs_cleanup;
+	using ::pbfs_first_node;
+	using ::pbfs_state;
+	using ::pbfs_next_node;
+	using ::pbfs_levels;
+	using ::pbfs_level_size;
 	using ::depthfs_t;
 	using ::depthfs_node_t;
 	using ::depthfs_create;
+	using ::depthfs_create_indexed;
 	using ::depthfs_destroy;
 	using ::depthfs_set_compare_fxn;
 	using ::depthfs_set_successors_fxn;
@@ -448,11 +985,15 @@ namespace csearch {
 	using ::dijkstra_t;
 	using ::dijkstra_node_t;
 	using ::dijkstra_create;
+	using ::dijkstra_create_indexed;
+	using ::dijkstra_create_ex;
+	using ::dijkstra_create_indexed_ex;
 	using ::dijkstra_destroy;
 	using ::dijkstra_set_compare_fxn;
 	using ::dijkstra_set_cost_fxn;
 	using ::dijkstra_set_successors_fxn;
 	using ::dijkstra_find;
+	using ::dijkstra_compute_all;
 	using ::dijkstra_cleanup;
 	using ::dijkstra_first_node;
 	using ::dijkstra_state;
@@ -462,7 +1003,17 @@ namespace csearch {
 	using ::dijkstra_iterative_is_done;
 	using ::astar_t;
 	using ::astar_node_t;
+	using ::astar_context_t;
+	using ::astar_config_t;
+	using ::astar_query_t;
+	using ::astar_config_create;
+	using ::astar_config_create_indexed;
+	using ::astar_config_destroy;
+	using ::astar_context_create;
 	using ::astar_create;
+	using ::astar_create_indexed;
+	using ::astar_create_ex;
+	using ::astar_create_indexed_ex;
 	using ::astar_destroy;
 	using ::astar_set_compare_fxn;
 	using ::astar_set_heuristic_fxn;
@@ -476,6 +1027,87 @@ namespace csearch {
 	using ::astar_iterative_init;
 	using ::astar_iterative_find;
 	using ::astar_iterative_is_done;
+	using ::astar_find_batch;
+	using ::idastar_t;
+	using ::idastar_node_t;
+	using ::idastar_create;
+	using ::idastar_destroy;
+	using ::idastar_set_compare_fxn;
+	using ::idastar_set_heuristic_fxn;
+	using ::idastar_set_cost_fxn;
+	using ::idastar_set_successors_fxn;
+	using ::idastar_find;
+	using ::idastar_cleanup;
+	using ::idastar_first_node;
+	using ::idastar_state;
+	using ::idastar_next_node;
+	using ::idastar_iterative_init;
+	using ::idastar_iterative_find;
+	using ::idastar_iterative_is_done;
+	using ::hdastar_t;
+	using ::hdastar_node_t;
+	using ::hdastar_create;
+	using ::hdastar_destroy;
+	using ::hdastar_find;
+	using ::hdastar_cleanup;
+	using ::hdastar_first_node;
+	using ::hdastar_state;
+	using ::hdastar_next_node;
+	using ::bidir_t;
+	using ::bidir_node_t;
+	using ::bidir_create;
+	using ::bidir_destroy;
+	using ::bidir_set_compare_fxn;
+	using ::bidir_set_heuristic_fxn;
+	using ::bidir_set_cost_fxn;
+	using ::bidir_set_successors_fxn;
+	using ::bidir_set_predecessors_fxn;
+	using ::bidir_find;
+	using ::bidir_cleanup;
+	using ::bidir_first_node;
+	using ::bidir_state;
+	using ::bidir_next_node;
+	using ::bidir_iterative_init;
+	using ::bidir_iterative_find;
+	using ::bidir_iterative_is_done;
+	using ::ch_t;
+	using ::ch_node_t;
+	using ::ch_create;
+	using ::ch_destroy;
+	using ::ch_shortcuts;
+	using ::ch_find;
+	using ::ch_cost;
+	using ::ch_cleanup;
+	using ::ch_first_node;
+	using ::ch_state;
+	using ::ch_next_node;
+	using ::cpd_t;
+	using ::cpd_node_t;
+	using ::cpd_create;
+	using ::cpd_load;
+	using ::cpd_save;
+	using ::cpd_destroy;
+	using ::cpd_runs;
+	using ::cpd_next_move;
+	using ::cpd_find;
+	using ::cpd_cleanup;
+	using ::cpd_first_node;
+	using ::cpd_state;
+	using ::cpd_next_node;
+	using ::jps_t;
+	using ::jps_node_t;
+	using ::jps_grid_t;
+	using ::jps_create;
+	using ::jps_destroy;
+	using ::jps_set_grid;
+	using ::jps_find;
+	using ::jps_cleanup;
+	using ::jps_first_node;
+	using ::jps_state;
+	using ::jps_next_node;
+	using ::jps_iterative_init;
+	using ::jps_iterative_find;
+	using ::jps_iterative_is_done;
 } /* namespace csearch */
 #endif
 #endif /* _CSEARCH_H_ */
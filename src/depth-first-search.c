@@ -22,31 +22,42 @@
 #include <stddef.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
-#include <libcollections/hash-map.h>
-#include <libcollections/tree-map.h>
-#include <libcollections/bench-mark.h>
+#include <collections/benchmark.h>
 #include "successors-private.h"
-#include "list.h"
+#include "state-table.h"
+#include "arena.h"
+#include "ring-buffer.h"
 #include "csearch.h"
 
+#define VISITED_WORD_BITS   (8 * sizeof(size_t))
+
 struct depthfs_node {
 	struct depthfs_node* parent;
 	const void* state; /* vertex */
 };
 
 struct depthfs_algorithm {
-	alloc_fxn alloc;
-	free_fxn  free;
-
-	compare_fxn     compare;
-	successors_fxn  successors_of;
-	depthfs_node_t* node_path;
-
-	successors_t successors;
-	list_t       open_list; /* list of depthfs_node_t* */
-	lc_hash_map_t   open_hash_map; /* (state, depthfs_node_t*) */
-	lc_tree_map_t   closed_list; /* (state, depthfs_node_t*) */
+	alloc_fxn_t alloc;
+	free_fxn_t  free;
+
+	compare_fxn_t    compare;
+	successors_fxn_t successors_of;
+	depthfs_node_t*  node_path;
+
+	/* Dense state ID mode. When state_index is set, a state has
+	 * been visited when its bit in visited_bits is set and the
+	 * state table below is not used.
+	 */
+	state_index_fxn_t state_index;
+	size_t            num_states;
+	size_t*           visited_bits;
+
+	successors_t  successors;
+	arena_t       nodes; /* storage for depthfs_node_t */
+	ring_buffer_t open_list; /* stack of depthfs_node_t* */
+	state_table_t states; /* depthfs_node_t* of every visited state */
 
 	#ifdef DEBUG_DEPTH_FIRST_SEARCH
 	size_t       allocations;
@@ -54,19 +65,10 @@ struct depthfs_algorithm {
 	#endif
 };
 
+#define depthfs_is_indexed( p_dfs )   ((p_dfs)->visited_bits != NULL)
 
-static boolean nop_keyval_fxn( void* __restrict key, void* __restrict value )
-{
-	return TRUE;
-}
 
-static int pointer_compare( const void* __restrict p_n1, const void* __restrict p_n2 )
-{
-	ptrdiff_t diff = (unsigned char*) p_n1 - (unsigned char*) p_n2;
-	return (int) diff;
-}
-
-depthfs_t* depthfs_create( compare_fxn compare, state_hash_fxn state_hasher, successors_fxn successors_of, alloc_fxn alloc, free_fxn free )
+static depthfs_t* depthfs_alloc( compare_fxn_t compare, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free )
 {
 	depthfs_t* p_dfs = (depthfs_t*) alloc( sizeof(depthfs_t) );
 
@@ -77,17 +79,91 @@ depthfs_t* depthfs_create( compare_fxn compare, state_hash_fxn state_hasher, suc
 		p_dfs->compare       = compare;
 		p_dfs->successors_of = successors_of;
 		p_dfs->node_path     = NULL;
+		p_dfs->state_index   = NULL;
+		p_dfs->num_states    = 0;
+		p_dfs->visited_bits  = NULL;
 		#ifdef DEBUG_DEPTH_FIRST_SEARCH
 		p_dfs->allocations   = 0;
 		p_dfs->bm            = bench_mark_create( "Depth First Search Algorithm" );
 		#endif
 
-		successors_create( &p_dfs->successors, 8, alloc, free );
-		list_create( &p_dfs->open_list, alloc, free );
-		hash_map_create( &p_dfs->open_hash_map, HASH_MAP_SIZE_MEDIUM,
-						 state_hasher, nop_keyval_fxn, pointer_compare,
-						 alloc, free );
-		tree_map_create( &p_dfs->closed_list, nop_keyval_fxn, pointer_compare, alloc, free );
+		arena_create( &p_dfs->nodes, sizeof(depthfs_node_t) * 1024, alloc, free );
+
+		if( successors_create( &p_dfs->successors, 8, alloc, free ) )
+		{
+			if( ring_buffer_create( &p_dfs->open_list, 1024, alloc, free ) )
+			{
+				return p_dfs;
+			}
+
+			successors_destroy( &p_dfs->successors );
+		}
+
+		#ifdef DEBUG_DEPTH_FIRST_SEARCH
+		bench_mark_destroy( p_dfs->bm );
+		#endif
+		free( p_dfs );
+	}
+
+	return NULL;
+}
+
+/*
+ * Undo depthfs_alloc() when the rest of a create function fails.
+ */
+static void depthfs_free( depthfs_t* p_dfs )
+{
+	free_fxn_t _free = p_dfs->free;
+
+	successors_destroy( &p_dfs->successors );
+	ring_buffer_destroy( &p_dfs->open_list );
+	#ifdef DEBUG_DEPTH_FIRST_SEARCH
+	bench_mark_destroy( p_dfs->bm );
+	#endif
+	_free( p_dfs );
+}
+
+depthfs_t* depthfs_create( compare_fxn_t compare, state_hash_fxn_t state_hasher, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free )
+{
+	depthfs_t* p_dfs = depthfs_alloc( compare, successors_of, alloc, free );
+
+	if( p_dfs && !state_table_create( &p_dfs->states, STATE_TABLE_DEFAULT_CAPACITY, offsetof(depthfs_node_t, state), state_hasher, compare, alloc, free ) )
+	{
+		depthfs_free( p_dfs );
+		return NULL;
+	}
+
+	return p_dfs;
+}
+
+/*
+ * Create a depth first search over a dense state space where
+ * every state maps to a unique ID in [0, num_states). Visited
+ * states are kept in a bitmap of num_states bits instead of a
+ * hash table.
+ */
+depthfs_t* depthfs_create_indexed( size_t num_states, state_index_fxn_t state_index, compare_fxn_t compare, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free )
+{
+	depthfs_t* p_dfs;
+	size_t words = (num_states + VISITED_WORD_BITS - 1) / VISITED_WORD_BITS;
+	assert( num_states > 0 );
+	assert( state_index );
+
+	p_dfs = depthfs_alloc( compare, successors_of, alloc, free );
+
+	if( p_dfs )
+	{
+		p_dfs->state_index  = state_index;
+		p_dfs->num_states   = num_states;
+		p_dfs->visited_bits = (size_t*) alloc( sizeof(size_t) * words );
+
+		if( !p_dfs->visited_bits )
+		{
+			depthfs_free( p_dfs );
+			return NULL;
+		}
+
+		memset( p_dfs->visited_bits, 0, sizeof(size_t) * words );
 	}
 
 	return p_dfs;
@@ -102,26 +178,40 @@ void depthfs_destroy( depthfs_t** p_dfs )
 		#endif
 
 		depthfs_cleanup( *p_dfs );
+		arena_destroy( &(*p_dfs)->nodes );
 		successors_destroy( &(*p_dfs)->successors );
-		list_destroy( &(*p_dfs)->open_list );
-		tree_map_destroy( &(*p_dfs)->closed_list );
+		ring_buffer_destroy( &(*p_dfs)->open_list );
+
+		if( depthfs_is_indexed(*p_dfs) )
+		{
+			(*p_dfs)->free( (*p_dfs)->visited_bits );
+		}
+		else
+		{
+			state_table_destroy( &(*p_dfs)->states );
+		}
 
-		free_fxn _free = (*p_dfs)->free;
+		free_fxn_t _free = (*p_dfs)->free;
 		_free( *p_dfs );
 		*p_dfs = NULL;
 	}
 }
 
-void depthfs_set_compare_fxn( depthfs_t* p_dfs, compare_fxn compare )
+void depthfs_set_compare_fxn( depthfs_t* p_dfs, compare_fxn_t compare )
 {
 	if( p_dfs )
 	{
 		assert( compare );
 		p_dfs->compare = compare;
+
+		if( !depthfs_is_indexed(p_dfs) )
+		{
+			p_dfs->states.compare = compare;
+		}
 	}
 }
 
-void depthfs_set_successors_fxn( depthfs_t* p_dfs, successors_fxn successors_of )
+void depthfs_set_successors_fxn( depthfs_t* p_dfs, successors_fxn_t successors_of )
 {
 	if( p_dfs )
 	{
@@ -130,86 +220,169 @@ void depthfs_set_successors_fxn( depthfs_t* p_dfs, successors_fxn successors_of
 	}
 }
 
-bool depthfs_find( depthfs_t* __restrict p_dfs, const void* __restrict start, const void* __restrict end )
+/*
+ * Mark a state as visited. Returns false if it was visited
+ * already. Without state IDs, *p_entry is where depthfs_open()
+ * puts the state's node, or is NULL if the state table
+ * could not grow.
+ */
+static __inline bool depthfs_visit( depthfs_t* __restrict p_dfs, const void* __restrict state, state_table_entry_t** p_entry )
 {
-	depthfs_node_t* p_node;
-	#ifdef DEBUG_DEPTH_FIRST_SEARCH
-	bench_mark_start( p_dfs->bm );
-	#endif
-	int i;
-	bool found = false;
+	if( depthfs_is_indexed(p_dfs) )
+	{
+		size_t index = p_dfs->state_index( state );
+		size_t* p_word = &p_dfs->visited_bits[ index / VISITED_WORD_BITS ];
+		size_t bit     = (size_t) 1 << (index % VISITED_WORD_BITS);
+		assert( index < p_dfs->num_states );
 
- 	/* 1.) Set the open list and closed list to be empty. */
-	depthfs_cleanup( p_dfs );
+		*p_entry = NULL;
+
+		if( *p_word & bit )
+		{
+			return false;
+		}
+
+		*p_word |= bit;
+		return true;
+	}
+
+	*p_entry = state_table_probe( &p_dfs->states, state );
+	return *p_entry && (*p_entry)->node == NULL;
+}
+
+#define depthfs_visit_failed( p_dfs, p_entry )   (!depthfs_is_indexed(p_dfs) && !(p_entry))
 
-	p_node         = (depthfs_node_t*) p_dfs->alloc( sizeof(depthfs_node_t) );
-	p_node->parent = NULL;
-	p_node->state  = start;
+/*
+ * Add a state to the open list. Returns false when out of memory.
+ */
+static __inline bool depthfs_open( depthfs_t* __restrict p_dfs, state_table_entry_t* __restrict p_entry, depthfs_node_t* __restrict parent, const void* __restrict state )
+{
+	depthfs_node_t* p_node = (depthfs_node_t*) arena_alloc( &p_dfs->nodes, sizeof(depthfs_node_t) );
+
+	if( !p_node )
+	{
+		return false;
+	}
+
+	p_node->parent = parent;
+	p_node->state  = state;
+
+	if( p_entry )
+	{
+		state_table_fill( &p_dfs->states, p_entry, p_node );
+	}
 
 	#ifdef DEBUG_DEPTH_FIRST_SEARCH
 	p_dfs->allocations++;
 	#endif
+	return ring_buffer_push_back( &p_dfs->open_list, p_node );
+}
 
- 	/* 2.) Add the start node to the open list. */
-	list_insert_front( &p_dfs->open_list, p_node );
-	hash_map_insert( &p_dfs->open_hash_map, p_node->state, p_node );
+static void depthfs_start( depthfs_t* __restrict p_dfs, const void* __restrict start )
+{
+	state_table_entry_t* p_entry;
 
- 	/* 3.) While the open list is not empty, do the following: */
-	while( !found && list_size(&p_dfs->open_list) > 0 )
+ 	/* 1.) Set the open list and visited set to be empty. */
+	depthfs_cleanup( p_dfs );
+
+ 	/* 2.) Add the start node to the open list and visited set. */
+	depthfs_visit( p_dfs, start, &p_entry );
+
+	/* out of memory; the open list stays empty and nothing is found */
+	if( !depthfs_visit_failed( p_dfs, p_entry ) )
 	{
- 		/* a.) Get a node from the open list, call it p_current_node. */
-		depthfs_node_t* p_current_node = list_front( &p_dfs->open_list )->data;
-		list_remove_front( &p_dfs->open_list );
-		hash_map_remove( &p_dfs->open_hash_map, p_current_node->state );
+		depthfs_open( p_dfs, p_entry, NULL, start );
+	}
+}
 
-		/* b.) If p_current_node is the goal node, return true. */
-		if( p_current_node->state == end )
-		{
-			p_dfs->node_path = p_current_node;
-			found = true;
-		}
-		else
+/*
+ * One iteration of step 3 of the algorithm below. Returns true
+ * when the goal node was found.
+ */
+static bool depthfs_step( depthfs_t* __restrict p_dfs, const void* __restrict end )
+{
+	bool found = false;
+	size_t i;
+
+	/* a.) Get a node from the open list, call it p_current_node. */
+	depthfs_node_t* p_current_node = ring_buffer_pop_back( &p_dfs->open_list );
+
+	/* b.) If p_current_node is the goal node, return true. */
+	if( p_dfs->compare( p_current_node->state, end ) == 0 )
+	{
+		p_dfs->node_path = p_current_node;
+		found = true;
+	}
+	else
+	{
+		/* c.) Get the successor nodes of p_current_node. */
+		p_dfs->successors_of( p_current_node->state, &p_dfs->successors );
+
+		/* d.) For each successor node S: */
+		for( i = 0; i < successors_size(&p_dfs->successors); i++ )
 		{
-			/* c.) Get the successor nodes of p_current_node. */
-			p_dfs->successors_of( p_current_node->state, &p_dfs->successors );
+			const void* __restrict successor_state = successors_get( &p_dfs->successors, i );
+			state_table_entry_t* p_entry;
 
-			/* d.) For each successor node S: */
-			for( i = 0; i < successors_size(&p_dfs->successors); i++ )
+			/* i.) If S has not been visited, then add S to the
+			 *     visited set and to the open list.
+			 */
+			if( depthfs_visit( p_dfs, successor_state, &p_entry ) )
 			{
-				const void* successor_state = successors_get( &p_dfs->successors, i );
-
-				/* i.) If S is not in the closed list, continue. */
-				void* found_node;
-				if( tree_map_find( &p_dfs->closed_list, successor_state, &found_node ) )
+				if( depthfs_open( p_dfs, p_entry, p_current_node, successor_state ) )
 				{
 					continue;
 				}
+			}
+			else if( !depthfs_visit_failed( p_dfs, p_entry ) )
+			{
+				successors_reclaim( &p_dfs->successors, i );
+				continue;
+			}
 
-				/* ii.) If S is in open list, continue */
-				if( hash_map_find( &p_dfs->open_hash_map, successor_state, &found_node ) )
-				{
-					continue;
-				}
-				else /* iii.) If S is not in the open list, then add S to the open list. */
-				{
-					depthfs_node_t* p_new_node = (depthfs_node_t*) p_dfs->alloc( sizeof(depthfs_node_t) );
-					p_new_node->parent     = p_current_node;
-					p_new_node->state      = successor_state;
+			/* out of memory; emptying the open list ends the search */
+			ring_buffer_clear( &p_dfs->open_list );
+			break;
+		} /* for */
 
-					list_insert_front( &p_dfs->open_list, p_new_node );
-					hash_map_insert( &p_dfs->open_hash_map, p_new_node->state, p_new_node );
+		successors_clear( &p_dfs->successors );
+	}
 
-					#ifdef DEBUG_DEPTH_FIRST_SEARCH
-					p_dfs->allocations++;
-					#endif
-				}
-			} /* for */
+	return found;
+}
 
-			successors_clear( &p_dfs->successors );
-		}
+/*
+ * Depth First Search Algorithm
+ * ------------------------------------------------------------------------
+ *   Input: The start node and goal nodes.
+ *  Output: True if goal node is found, false if goal node cannot be found
+ *          from the start node.
+ * ------------------------------------------------------------------------
+ * 1.) Set the open list and visited set to be empty.
+ * 2.) Add the start node to the open list and visited set.
+ * 3.) While the open list is not empty, do the following:
+ *        a.) Get a node from the top of the open list, call it N.
+ *        b.) If N is the goal node, return true.
+ *        c.) Get the successor nodes of N.
+ *        d.) For each successor node S:
+ *            i.) If S has not been visited, then add S to the
+ *                visited set and to the top of the open list.
+ * 4.) Return false.
+ */
+bool depthfs_find( depthfs_t* __restrict p_dfs, const void* __restrict start, const void* __restrict end )
+{
+	bool found = false;
+
+	#ifdef DEBUG_DEPTH_FIRST_SEARCH
+	bench_mark_start( p_dfs->bm );
+	#endif
+
+	depthfs_start( p_dfs, start );
 
-		/* e.) Add p_current_node to the closed list. */
-		tree_map_insert( &p_dfs->closed_list, p_current_node->state, p_current_node );
+ 	/* 3.) While the open list is not empty, do the following: */
+	while( !found && ring_buffer_size(&p_dfs->open_list) > 0 )
+	{
+		found = depthfs_step( p_dfs, end );
 	}
 
 	#ifdef DEBUG_DEPTH_FIRST_SEARCH
@@ -222,47 +395,32 @@ bool depthfs_find( depthfs_t* __restrict p_dfs, const void* __restrict start, co
 
 void depthfs_cleanup( depthfs_t* p_dfs )
 {
-	lc_hash_map_iterator_t open_itr;
-	lc_tree_map_iterator_t closed_itr;
-
-	assert( hash_map_size(&p_dfs->open_hash_map) == list_size(&p_dfs->open_list) );
+	assert( p_dfs );
 	#ifdef DEBUG_DEPTH_FIRST_SEARCH
-	size_t size2 = hash_map_size(&p_dfs->open_hash_map);
-	size_t size3 = tree_map_size(&p_dfs->closed_list);
-	assert( size2 + size3 == p_dfs->allocations );
+	assert( depthfs_is_indexed(p_dfs) || state_table_size(&p_dfs->states) == p_dfs->allocations );
 	#endif
 
-	successors_clear( &p_dfs->successors );
+	successors_release_states( &p_dfs->successors );
 
 	p_dfs->node_path = NULL;
 
-	hash_map_iterator( &p_dfs->open_hash_map, &open_itr );
+	// empty out the data structures
+	ring_buffer_clear( &p_dfs->open_list );
 
-	// free everything on the open list.
-	while( hash_map_iterator_next( &open_itr ) )
+	if( depthfs_is_indexed(p_dfs) )
 	{
-		bestfs_node_t* p_node = hash_map_iterator_value( &open_itr );
-		p_dfs->free( p_node );
-		#ifdef DEBUG_DEPTH_FIRST_SEARCH
-		p_dfs->allocations--;
-		#endif
+		memset( p_dfs->visited_bits, 0, sizeof(size_t) * ((p_dfs->num_states + VISITED_WORD_BITS - 1) / VISITED_WORD_BITS) );
 	}
-
-	// free everything on the closed list.
-	for( closed_itr = tree_map_begin( &p_dfs->closed_list );
-	     closed_itr != tree_map_end( );
-	     closed_itr = tree_map_next( closed_itr ) )
+	else
 	{
-		p_dfs->free( closed_itr->value );
-		#ifdef DEBUG_DEPTH_FIRST_SEARCH
-		p_dfs->allocations--;
-		#endif
+		state_table_clear( &p_dfs->states );
 	}
 
-	// empty out the data structures
-	list_clear( &p_dfs->open_list );
-	hash_map_clear( &p_dfs->open_hash_map );
-	tree_map_clear( &p_dfs->closed_list );
+	/* release every node at once */
+	arena_reset( &p_dfs->nodes );
+	#ifdef DEBUG_DEPTH_FIRST_SEARCH
+	p_dfs->allocations = 0;
+	#endif
 }
 
 depthfs_node_t* depthfs_first_node( const depthfs_t* p_dfs )
@@ -283,90 +441,22 @@ depthfs_node_t* depthfs_next_node( const depthfs_node_t* p_node )
 	return p_node->parent;
 }
 
-void depthfs_iterative_init( depthfs_t* __restrict p_dfs, const void* __restrict start, const void* __restrict end, bool* found )
+void depthfs_iterative_init( depthfs_t* __restrict p_dfs, const void* __restrict start, const void* __restrict end, bool* __restrict found )
 {
-	depthfs_node_t* p_node;
 	#ifdef DEBUG_DEPTH_FIRST_SEARCH
 	bench_mark_start( p_dfs->bm );
 	#endif
 	*found = false;
 
- 	/* 1.) Set the open list and closed list to be empty. */
-	depthfs_cleanup( p_dfs );
-
-	p_node         = (depthfs_node_t*) p_dfs->alloc( sizeof(depthfs_node_t) );
-	p_node->parent = NULL;
-	p_node->state  = start;
-
-	#ifdef DEBUG_DEPTH_FIRST_SEARCH
-	p_dfs->allocations++;
-	#endif
-
- 	/* 2.) Add the start node to the open list. */
-	list_insert_front( &p_dfs->open_list, p_node );
-	hash_map_insert( &p_dfs->open_hash_map, p_node->state, p_node );
+	depthfs_start( p_dfs, start );
 }
 
-void depthfs_iterative_find( depthfs_t* __restrict p_dfs, const void* __restrict start, const void* __restrict end, bool* found )
+void depthfs_iterative_find( depthfs_t* __restrict p_dfs, const void* __restrict start, const void* __restrict end, bool* __restrict found )
 {
  	/* 3.) While the open list is not empty, do the following: */
-	if( !*found && list_size(&p_dfs->open_list) > 0 )
+	if( !*found && ring_buffer_size(&p_dfs->open_list) > 0 )
 	{
- 		/* a.) Get a node from the open list, call it p_current_node. */
-		depthfs_node_t* p_current_node = list_front( &p_dfs->open_list )->data;
-		list_remove_front( &p_dfs->open_list );
-		hash_map_remove( &p_dfs->open_hash_map, p_current_node->state );
-
-		/* b.) If p_current_node is the goal node, return true. */
-		if( p_current_node->state == end )
-		{
-			p_dfs->node_path = p_current_node;
-			*found = true;
-		}
-		else
-		{
-			int i;
-
-			/* c.) Get the successor nodes of p_current_node. */
-			p_dfs->successors_of( p_current_node->state, &p_dfs->successors );
-
-			/* d.) For each successor node S: */
-			for( i = 0; i < successors_size(&p_dfs->successors); i++ )
-			{
-				const void* successor_state = successors_get( &p_dfs->successors, i );
-
-				/* i.) If S is not in the closed list, continue. */
-				void* found_node;
-				if( tree_map_find( &p_dfs->closed_list, successor_state, &found_node ) )
-				{
-					return;
-				}
-
-				/* ii.) If S is in open list, continue */
-				if( hash_map_find( &p_dfs->open_hash_map, successor_state, &found_node ) )
-				{
-					return;
-				}
-				else /* iii.) If S is not in the open list, then add S to the open list. */
-				{
-					depthfs_node_t* p_new_node = (depthfs_node_t*) p_dfs->alloc( sizeof(depthfs_node_t) );
-					p_new_node->parent     = p_current_node;
-					p_new_node->state      = successor_state;
-
-					list_insert_front( &p_dfs->open_list, p_new_node );
-					hash_map_insert( &p_dfs->open_hash_map, p_new_node->state, p_new_node );
-
-					#ifdef DEBUG_DEPTH_FIRST_SEARCH
-					p_dfs->allocations++;
-					#endif
-				}
-			} /* for */
-
-			successors_clear( &p_dfs->successors );
-		}
-
-		/* e.) Add p_current_node to the closed list. */
-		tree_map_insert( &p_dfs->closed_list, p_current_node->state, p_current_node );
+		*found = depthfs_step( p_dfs, end );
 	}
 
 	#ifdef DEBUG_DEPTH_FIRST_SEARCH
@@ -378,7 +468,7 @@ void depthfs_iterative_find( depthfs_t* __restrict p_dfs, const void* __restrict
 	#endif
 }
 
-bool depthfs_iterative_is_done( depthfs_t* __restrict p_dfs, bool* found )
+bool depthfs_iterative_is_done( depthfs_t* __restrict p_dfs, bool* __restrict found )
 {
-	return *found || list_size(&p_dfs->open_list) == 0;
+	return *found || ring_buffer_size(&p_dfs->open_list) == 0;
 }
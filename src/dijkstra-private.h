@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _DIJKSTRA_PRIVATE_H_
+#define _DIJKSTRA_PRIVATE_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include "csearch.h"
+
+/*
+ * Results of a search made by dijkstra_find() with no end state,
+ * which closes every state reachable from the start. Both are for
+ * the dense state ID mode only and read the last search.
+ *
+ * dijkstra_distances() writes the cost of reaching the state with
+ * ID i to distances[ i * stride ], or UINT_MAX if the search did not
+ * reach it. dijkstra_indexed_state() returns the state with ID i,
+ * or NULL if the search did not reach it.
+ */
+void        dijkstra_distances     ( const dijkstra_t* __restrict p_dijkstra, unsigned int* __restrict distances, size_t stride ); /* O(N) */
+const void* dijkstra_indexed_state ( const dijkstra_t* p_dijkstra, size_t index ); /* O(1) */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _DIJKSTRA_PRIVATE_H_ */
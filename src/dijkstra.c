@@ -20,41 +20,62 @@
  * THE SOFTWARE.
  */
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <limits.h>
 #include <assert.h>
-#include <libcollections/alloc.h>
-#include <libcollections/bheap.h>
-#include <libcollections/hash-map.h>
-#include <libcollections/tree-map.h>
-#include <libcollections/bench-mark.h>
+#include <collections/benchmark.h>
 #include "successors-private.h"
+#include "dijkstra-private.h"
+#include "indexed-heap.h"
+#include "state-table.h"
+#include "bucket-queue.h"
+#include "radix-heap.h"
+#include "arena.h"
 #include "csearch.h"
 
+enum dijkstra_status {
+	DIJKSTRA_UNVISITED = 0,
+	DIJKSTRA_OPEN,
+	DIJKSTRA_CLOSED
+};
+
 struct dijkstra_node {
 	struct dijkstra_node* parent;
-	int c; /* cost */
+	unsigned int c; /* cost */
+	int status; /* unvisited, open or closed */
+	unsigned int generation; /* search that last reached this node */
+	size_t open_index; /* position in the open list */
 	const void* state; /* vertex */
 };
 
 struct dijkstra_algorithm {
-	alloc_fxn alloc;
-	free_fxn  free;
-
-	compare_fxn          compare;
-	nonnegative_cost_fxn cost;
-	successors_fxn       successors_of;
-	dijkstra_node_t*     node_path;
-
-	successors_t successors;
-	lc_pbheap_t     open_list; /* list of dijkstra_node_t* */
-	lc_hash_map_t   open_hash_map; /* (state, dijkstra_node_t*) */
-	#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-	lc_tree_map_t   closed_list; /* (state, dijkstra_node_t*) */
-	#else
-	lc_hash_map_t   closed_list; /* (state, dijkstra_node_t*) */
-	#endif
+	alloc_fxn_t alloc;
+	free_fxn_t  free;
+
+	compare_fxn_t          compare;
+	nonnegative_cost_fxn_t cost;
+	successors_fxn_t       successors_of;
+	dijkstra_node_t*       node_path;
+
+	/* Dense state ID mode. When state_index is set, every state
+	 * has its node at nodes[ state_index(state) ] and the state
+	 * table below is not used.
+	 */
+	state_index_fxn_t state_index;
+	size_t            num_states;
+	dijkstra_node_t*  node_array;
+	unsigned int      generation; /* nodes stamped with an older generation are unvisited */
+
+	successors_t    successors;
+	arena_t         nodes; /* storage for dijkstra_node_t */
+	open_list_t     open_list_type;
+	indexed_heap_t  open_list; /* heap of dijkstra_node_t* */
+	bucket_queue_t  open_buckets; /* dijkstra_node_t* keyed by cost */
+	radix_heap_t    open_radix; /* dijkstra_node_t* keyed by cost */
+	state_table_t   states; /* dijkstra_node_t* of every reached state */
 
 	#ifdef DEBUG_DIJKSTRA
 	size_t       allocations;
@@ -62,25 +83,48 @@ struct dijkstra_algorithm {
 	#endif
 };
 
-static boolean nop_keyval_fxn( void* __restrict key, void* __restrict value )
+#define default_cost_compare( c1, c2 )      ((c1) < (c2) ? 1 : ((c1) > (c2) ? -1 : 0))
+
+static int best_cost_compare( const void* __restrict p_n1, const void* __restrict p_n2 )
 {
-	return TRUE;
+	return default_cost_compare(((dijkstra_node_t*)p_n1)->c,  ((dijkstra_node_t*)p_n2)->c);
 }
 
-static int dijkstra_pointer_compare( const void* __restrict p_n1, const void* __restrict p_n2 )
+#define dijkstra_is_indexed( p_dijkstra )   ((p_dijkstra)->node_array != NULL)
+
+
+static bool dijkstra_open_list_create( dijkstra_t* p_dijkstra )
 {
-	ptrdiff_t diff = (size_t*) p_n1 - (size_t*) p_n2;
-	return (int) diff;
+	switch( p_dijkstra->open_list_type )
+	{
+		case OPEN_LIST_BUCKET_QUEUE:
+			return bucket_queue_create( &p_dijkstra->open_buckets, 64, offsetof(dijkstra_node_t, open_index), p_dijkstra->alloc, p_dijkstra->free );
+		case OPEN_LIST_RADIX_HEAP:
+			radix_heap_create( &p_dijkstra->open_radix, offsetof(dijkstra_node_t, open_index), p_dijkstra->alloc, p_dijkstra->free );
+			return true;
+		default:
+			p_dijkstra->open_list_type = OPEN_LIST_BINARY_HEAP;
+			return indexed_heap_create( &p_dijkstra->open_list, 128, offsetof(dijkstra_node_t, open_index), best_cost_compare, p_dijkstra->alloc, p_dijkstra->free );
+	}
 }
 
-#define default_cost_compare( c1, c2 )      ((c2) - (c1))
-
-static int best_cost_compare( const void* __restrict p_n1, const void* __restrict p_n2 )
+static void dijkstra_open_list_destroy( dijkstra_t* p_dijkstra )
 {
-	return default_cost_compare(((dijkstra_node_t*)p_n1)->c,  ((dijkstra_node_t*)p_n2)->c);
+	switch( p_dijkstra->open_list_type )
+	{
+		case OPEN_LIST_BUCKET_QUEUE:
+			bucket_queue_destroy( &p_dijkstra->open_buckets );
+			break;
+		case OPEN_LIST_RADIX_HEAP:
+			radix_heap_destroy( &p_dijkstra->open_radix );
+			break;
+		default:
+			indexed_heap_destroy( &p_dijkstra->open_list );
+			break;
+	}
 }
 
-dijkstra_t* dijkstra_create( compare_fxn compare, state_hash_fxn state_hasher, nonnegative_cost_fxn cost, successors_fxn successors_of, alloc_fxn alloc, free_fxn free )
+static dijkstra_t* dijkstra_alloc( open_list_t open_list, compare_fxn_t compare, nonnegative_cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free )
 {
 	dijkstra_t* p_dijkstra = (dijkstra_t*) alloc( sizeof(dijkstra_t) );
 
@@ -92,28 +136,108 @@ dijkstra_t* dijkstra_create( compare_fxn compare, state_hash_fxn state_hasher, n
 		p_dijkstra->cost          = cost;
 		p_dijkstra->successors_of = successors_of;
 		p_dijkstra->node_path     = NULL;
+		p_dijkstra->state_index   = NULL;
+		p_dijkstra->num_states    = 0;
+		p_dijkstra->node_array    = NULL;
+		p_dijkstra->generation    = 1;
+		p_dijkstra->open_list_type = open_list;
 		#ifdef DEBUG_DIJKSTRA
 		p_dijkstra->allocations   = 0;
 		p_dijkstra->bm            = bench_mark_create( "Dijkstra's Search Algorithm" );
 		#endif
 
-		successors_create( &p_dijkstra->successors, 8, alloc, free );
+		arena_create( &p_dijkstra->nodes, sizeof(dijkstra_node_t) * 1024, alloc, free );
 
-		pbheap_create( &p_dijkstra->open_list, 128,
-					  (heap_compare_function) best_cost_compare,
-					  alloc, free );
+		if( successors_create( &p_dijkstra->successors, 8, alloc, free ) )
+		{
+			if( dijkstra_open_list_create( p_dijkstra ) )
+			{
+				return p_dijkstra;
+			}
 
-		hash_map_create( &p_dijkstra->open_hash_map, HASH_MAP_SIZE_MEDIUM,
-						 state_hasher, nop_keyval_fxn, dijkstra_pointer_compare,
-						 alloc, free );
+			successors_destroy( &p_dijkstra->successors );
+		}
 
-		#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-		tree_map_create( &p_dijkstra->closed_list, nop_keyval_fxn, dijkstra_pointer_compare, alloc, free );
-		#else
-		hash_map_create( &p_dijkstra->closed_list, HASH_MAP_SIZE_MEDIUM,
-						 state_hasher, nop_keyval_fxn, dijkstra_pointer_compare,
-						 alloc, free );
+		#ifdef DEBUG_DIJKSTRA
+		bench_mark_destroy( p_dijkstra->bm );
 		#endif
+		free( p_dijkstra );
+	}
+
+	return NULL;
+}
+
+/*
+ * Undo dijkstra_alloc() when the rest of a create function fails.
+ */
+static void dijkstra_free( dijkstra_t* p_dijkstra )
+{
+	free_fxn_t _free = p_dijkstra->free;
+
+	successors_destroy( &p_dijkstra->successors );
+	dijkstra_open_list_destroy( p_dijkstra );
+	#ifdef DEBUG_DIJKSTRA
+	bench_mark_destroy( p_dijkstra->bm );
+	#endif
+	_free( p_dijkstra );
+}
+
+dijkstra_t* dijkstra_create( compare_fxn_t compare, state_hash_fxn_t state_hasher, nonnegative_cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free )
+{
+	return dijkstra_create_ex( OPEN_LIST_BINARY_HEAP, compare, state_hasher, cost, successors_of, alloc, free );
+}
+
+/*
+ * Same as dijkstra_create() but with a choice of open list.
+ */
+dijkstra_t* dijkstra_create_ex( open_list_t open_list, compare_fxn_t compare, state_hash_fxn_t state_hasher, nonnegative_cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free )
+{
+	dijkstra_t* p_dijkstra = dijkstra_alloc( open_list, compare, cost, successors_of, alloc, free );
+
+	if( p_dijkstra && !state_table_create( &p_dijkstra->states, STATE_TABLE_DEFAULT_CAPACITY, offsetof(dijkstra_node_t, state), state_hasher, compare, alloc, free ) )
+	{
+		dijkstra_free( p_dijkstra );
+		return NULL;
+	}
+
+	return p_dijkstra;
+}
+
+/*
+ * Create a Dijkstra search over a dense state space where every
+ * state maps to a unique ID in [0, num_states). Nodes live in a
+ * flat array indexed by state ID, so looking up a state is a
+ * single array access instead of a hash map lookup.
+ */
+dijkstra_t* dijkstra_create_indexed( size_t num_states, state_index_fxn_t state_index, compare_fxn_t compare, nonnegative_cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free )
+{
+	return dijkstra_create_indexed_ex( OPEN_LIST_BINARY_HEAP, num_states, state_index, compare, cost, successors_of, alloc, free );
+}
+
+/*
+ * Same as dijkstra_create_indexed() but with a choice of open list.
+ */
+dijkstra_t* dijkstra_create_indexed_ex( open_list_t open_list, size_t num_states, state_index_fxn_t state_index, compare_fxn_t compare, nonnegative_cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free )
+{
+	dijkstra_t* p_dijkstra;
+	assert( num_states > 0 );
+	assert( state_index );
+
+	p_dijkstra = dijkstra_alloc( open_list, compare, cost, successors_of, alloc, free );
+
+	if( p_dijkstra )
+	{
+		p_dijkstra->state_index = state_index;
+		p_dijkstra->num_states  = num_states;
+		p_dijkstra->node_array  = (dijkstra_node_t*) alloc( sizeof(dijkstra_node_t) * num_states );
+
+		if( !p_dijkstra->node_array )
+		{
+			dijkstra_free( p_dijkstra );
+			return NULL;
+		}
+
+		memset( p_dijkstra->node_array, 0, sizeof(dijkstra_node_t) * num_states );
 	}
 
 	return p_dijkstra;
@@ -123,36 +247,45 @@ void dijkstra_destroy( dijkstra_t** p_dijkstra )
 {
 	if( p_dijkstra && *p_dijkstra )
 	{
-		#ifdef DEBUG_BEST_FIRST_SEARCH
+		#ifdef DEBUG_DIJKSTRA
 		bench_mark_destroy( (*p_dijkstra)->bm );
 		#endif
 
 		dijkstra_cleanup( *p_dijkstra );
+		arena_destroy( &(*p_dijkstra)->nodes );
 		successors_destroy( &(*p_dijkstra)->successors );
-		pbheap_destroy( &(*p_dijkstra)->open_list );
-		hash_map_destroy( &(*p_dijkstra)->open_hash_map );
-		#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-		tree_map_destroy( &(*p_dijkstra)->closed_list );
-		#else
-		hash_map_destroy( &(*p_dijkstra)->closed_list );
-		#endif
+		dijkstra_open_list_destroy( *p_dijkstra );
+
+		if( dijkstra_is_indexed(*p_dijkstra) )
+		{
+			(*p_dijkstra)->free( (*p_dijkstra)->node_array );
+		}
+		else
+		{
+			state_table_destroy( &(*p_dijkstra)->states );
+		}
 
-		free_fxn _free = (*p_dijkstra)->free;
+		free_fxn_t _free = (*p_dijkstra)->free;
 		_free( *p_dijkstra );
 		*p_dijkstra = NULL;
 	}
 }
 
-void dijkstra_set_compare_fxn( dijkstra_t* p_dijkstra, compare_fxn compare )
+void dijkstra_set_compare_fxn( dijkstra_t* p_dijkstra, compare_fxn_t compare )
 {
 	if( p_dijkstra )
 	{
 		assert( compare );
 		p_dijkstra->compare = compare;
+
+		if( !dijkstra_is_indexed(p_dijkstra) )
+		{
+			p_dijkstra->states.compare = compare;
+		}
 	}
 }
 
-void dijkstra_set_cost_fxn( dijkstra_t* p_dijkstra, nonnegative_cost_fxn cost )
+void dijkstra_set_cost_fxn( dijkstra_t* p_dijkstra, nonnegative_cost_fxn_t cost )
 {
 	if( p_dijkstra )
 	{
@@ -161,7 +294,7 @@ void dijkstra_set_cost_fxn( dijkstra_t* p_dijkstra, nonnegative_cost_fxn cost )
 	}
 }
 
-void dijkstra_set_successors_fxn( dijkstra_t* p_dijkstra, successors_fxn successors_of )
+void dijkstra_set_successors_fxn( dijkstra_t* p_dijkstra, successors_fxn_t successors_of )
 {
 	if( p_dijkstra )
 	{
@@ -170,6 +303,262 @@ void dijkstra_set_successors_fxn( dijkstra_t* p_dijkstra, successors_fxn success
 	}
 }
 
+/*
+ * Find the node of a state that has already been reached in this
+ * search, or NULL if the state has not been seen yet. Without
+ * state IDs, *p_entry is where dijkstra_open() puts a new node, or
+ * NULL if the state table could not grow.
+ */
+static __inline dijkstra_node_t* dijkstra_lookup( dijkstra_t* __restrict p_dijkstra, const void* __restrict state, state_table_entry_t** p_entry )
+{
+	if( dijkstra_is_indexed(p_dijkstra) )
+	{
+		dijkstra_node_t* p_node = &p_dijkstra->node_array[ p_dijkstra->state_index( state ) ];
+		*p_entry = NULL;
+		return p_node->generation == p_dijkstra->generation ? p_node : NULL;
+	}
+
+	*p_entry = state_table_probe( &p_dijkstra->states, state );
+	return *p_entry ? (dijkstra_node_t*) (*p_entry)->node : NULL;
+}
+
+#define dijkstra_lookup_failed( p_dijkstra, p_entry )   (!dijkstra_is_indexed(p_dijkstra) && !(p_entry))
+
+static __inline size_t dijkstra_open_list_size( const dijkstra_t* p_dijkstra )
+{
+	switch( p_dijkstra->open_list_type )
+	{
+		case OPEN_LIST_BUCKET_QUEUE: return bucket_queue_size( &p_dijkstra->open_buckets );
+		case OPEN_LIST_RADIX_HEAP:   return radix_heap_size( &p_dijkstra->open_radix );
+		default:                     return indexed_heap_size( &p_dijkstra->open_list );
+	}
+}
+
+static __inline bool dijkstra_open_list_push( dijkstra_t* __restrict p_dijkstra, dijkstra_node_t* __restrict p_node )
+{
+	switch( p_dijkstra->open_list_type )
+	{
+		case OPEN_LIST_BUCKET_QUEUE:
+			return bucket_queue_push( &p_dijkstra->open_buckets, p_node, (int) p_node->c );
+		case OPEN_LIST_RADIX_HEAP:
+			return radix_heap_push( &p_dijkstra->open_radix, p_node, p_node->c );
+		default:
+			return indexed_heap_push( &p_dijkstra->open_list, p_node );
+	}
+}
+
+static __inline dijkstra_node_t* dijkstra_open_list_pop( dijkstra_t* p_dijkstra )
+{
+	switch( p_dijkstra->open_list_type )
+	{
+		case OPEN_LIST_BUCKET_QUEUE: return (dijkstra_node_t*) bucket_queue_pop( &p_dijkstra->open_buckets );
+		case OPEN_LIST_RADIX_HEAP:   return (dijkstra_node_t*) radix_heap_pop( &p_dijkstra->open_radix );
+		default:                     return (dijkstra_node_t*) indexed_heap_pop( &p_dijkstra->open_list );
+	}
+}
+
+/*
+ * Move a node in the open list after its cost improved from old_c.
+ * Returns false when out of memory; the node may then be missing from
+ * the open list.
+ */
+static __inline bool dijkstra_open_list_promote( dijkstra_t* __restrict p_dijkstra, dijkstra_node_t* __restrict p_node, unsigned int old_c )
+{
+	switch( p_dijkstra->open_list_type )
+	{
+		case OPEN_LIST_BUCKET_QUEUE:
+			return bucket_queue_update( &p_dijkstra->open_buckets, p_node, (int) old_c, (int) p_node->c );
+		case OPEN_LIST_RADIX_HEAP:
+			return radix_heap_update( &p_dijkstra->open_radix, p_node, old_c, p_node->c );
+		default:
+			indexed_heap_promote( &p_dijkstra->open_list, p_node );
+			return true;
+	}
+}
+
+static __inline void dijkstra_open_list_clear( dijkstra_t* p_dijkstra )
+{
+	switch( p_dijkstra->open_list_type )
+	{
+		case OPEN_LIST_BUCKET_QUEUE:
+			bucket_queue_clear( &p_dijkstra->open_buckets );
+			break;
+		case OPEN_LIST_RADIX_HEAP:
+			radix_heap_clear( &p_dijkstra->open_radix );
+			break;
+		default:
+			indexed_heap_clear( &p_dijkstra->open_list );
+			break;
+	}
+}
+
+/*
+ * Add a state to the open list. Returns NULL when out of memory.
+ */
+static __inline dijkstra_node_t* dijkstra_open( dijkstra_t* __restrict p_dijkstra, state_table_entry_t* __restrict p_entry, dijkstra_node_t* __restrict parent, const void* __restrict state, unsigned int c )
+{
+	dijkstra_node_t* p_node;
+
+	if( dijkstra_is_indexed(p_dijkstra) )
+	{
+		p_node = &p_dijkstra->node_array[ p_dijkstra->state_index( state ) ];
+	}
+	else
+	{
+		p_node = (dijkstra_node_t*) arena_alloc( &p_dijkstra->nodes, sizeof(dijkstra_node_t) );
+
+		if( !p_node )
+		{
+			return NULL;
+		}
+	}
+
+	p_node->parent = parent;
+	p_node->c      = c;
+	p_node->status = DIJKSTRA_OPEN;
+	p_node->generation = p_dijkstra->generation;
+	p_node->state  = state;
+
+	if( !dijkstra_is_indexed(p_dijkstra) )
+	{
+		state_table_fill( &p_dijkstra->states, p_entry, p_node );
+	}
+
+	#ifdef DEBUG_DIJKSTRA
+	p_dijkstra->allocations++;
+	#endif
+	return dijkstra_open_list_push( p_dijkstra, p_node ) ? p_node : NULL;
+}
+
+static __inline void dijkstra_close( dijkstra_t* __restrict p_dijkstra, dijkstra_node_t* __restrict p_node )
+{
+	p_node->status = DIJKSTRA_CLOSED;
+}
+
+/*
+ * Steps 1 and 2 of the algorithm below.
+ */
+static void dijkstra_start( dijkstra_t* __restrict p_dijkstra, const void* __restrict start )
+{
+	state_table_entry_t* p_entry;
+
+ 	/* 1.) Set the start node to have 0 cost. Set the open list and closed
+ 	 *     list to be empty.
+ 	 */
+	dijkstra_cleanup( p_dijkstra );
+
+ 	/* 2.) Add the start node to the open list. */
+	dijkstra_lookup( p_dijkstra, start, &p_entry );
+
+	/* out of memory; the open list stays empty and nothing is found */
+	if( !dijkstra_lookup_failed( p_dijkstra, p_entry ) )
+	{
+		dijkstra_open( p_dijkstra, p_entry, NULL, start, 0 );
+	}
+}
+
+/*
+ * One iteration of step 3 of the algorithm below. Returns true
+ * when the goal node was found.
+ */
+static bool dijkstra_step( dijkstra_t* __restrict p_dijkstra, const void* __restrict end )
+{
+	state_table_entry_t* p_entry;
+	bool found = false;
+	size_t i;
+
+	/* a.) Get a node from the open list, call it N. */
+	dijkstra_node_t* p_current_node = dijkstra_open_list_pop( p_dijkstra );
+
+	/* out of memory (only the radix heap can fail to pop) */
+	if( !p_current_node )
+	{
+		dijkstra_open_list_clear( p_dijkstra );
+		return false;
+	}
+
+	/* b.) If N is the goal node, return true. */
+	if( end && p_dijkstra->compare( p_current_node->state, end ) == 0 )
+	{
+		p_dijkstra->node_path = p_current_node;
+		found = true;
+	}
+	else
+	{
+		/* c.) Get the successor nodes of N. */
+		p_dijkstra->successors_of( p_current_node->state, &p_dijkstra->successors );
+
+		/* d.) For each successor node S: */
+		for( i = 0; i < successors_size(&p_dijkstra->successors); i++ )
+		{
+			const void* __restrict successor_state = successors_get( &p_dijkstra->successors, i );
+			dijkstra_node_t* p_found_node          = dijkstra_lookup( p_dijkstra, successor_state, &p_entry );
+			unsigned int c                         = p_current_node->c + p_dijkstra->cost( p_current_node->state, successor_state );
+
+			/* out of memory; emptying the open list ends the search */
+			if( dijkstra_lookup_failed( p_dijkstra, p_entry ) )
+			{
+				dijkstra_open_list_clear( p_dijkstra );
+				break;
+			}
+
+			/* i.) If S is in the closed list, continue. */
+			if( p_found_node && p_found_node->status == DIJKSTRA_CLOSED )
+			{
+				/* NOTE: The closed list is used to prevent re-examining
+				 * nodes that already have the minimal cost computed in
+				 * them. Without this, nodes would be added to the open
+				 * list without ever having a hope of being more optimal
+				 * than already computed.
+				 */
+				successors_reclaim( &p_dijkstra->successors, i );
+				continue;
+			}
+
+			/* ii.) If S is in the open list, update its cost with the cost of
+			 *      N plus the cost to go from N to S, if it is better.  Make
+			 *      sure to resort the open list.
+			 */
+			if( p_found_node )
+			{
+				if( default_cost_compare( c, p_found_node->c ) > 0 )
+				{
+					unsigned int old_c = p_found_node->c;
+
+					p_found_node->c      = c;
+					p_found_node->parent = p_current_node;
+
+					if( !dijkstra_open_list_promote( p_dijkstra, p_found_node, old_c ) )
+					{
+						dijkstra_open_list_clear( p_dijkstra );
+						break;
+					}
+				}
+
+				successors_reclaim( &p_dijkstra->successors, i );
+			}
+			else
+			{
+				/* iii.) If S is not in the open list, add it with the cost of N
+				 *       plus the cost to go from N to S.
+				 */
+				if( !dijkstra_open( p_dijkstra, p_entry, p_current_node, successor_state, c ) )
+				{
+					dijkstra_open_list_clear( p_dijkstra );
+					break;
+				}
+			}
+		} /* for */
+
+		successors_clear( &p_dijkstra->successors );
+	}
+
+	/* e.) Add N to the closed list. */
+	dijkstra_close( p_dijkstra, p_current_node );
+
+	return found;
+}
+
 /*
  * Dijkstra's Algorithm
  * ------------------------------------------------------------------------
@@ -196,187 +585,102 @@ void dijkstra_set_successors_fxn( dijkstra_t* p_dijkstra, successors_fxn success
  */
 bool dijkstra_find( dijkstra_t* __restrict p_dijkstra, const void* __restrict start, const void* __restrict end )
 {
-	dijkstra_node_t* p_node;
 	bool found = false;
-	int i;
 
-	#ifdef DEBUG_BEST_FIRST_SEARCH
+	#ifdef DEBUG_DIJKSTRA
 	bench_mark_start( p_dijkstra->bm );
 	#endif
 	assert( p_dijkstra );
 
- 	/* 1.) Set the open list and closed list to be empty. */
-	dijkstra_cleanup( p_dijkstra );
+	dijkstra_start( p_dijkstra, start );
 
-	p_node         = (dijkstra_node_t*) p_dijkstra->alloc( sizeof(dijkstra_node_t) );
-	p_node->parent = NULL;
-	p_node->c      = 0;
-	p_node->state  = start;
+ 	/* 3.) While the open list is not empty, do the following: */
+	while( !found && dijkstra_open_list_size(p_dijkstra) > 0 )
+	{
+		found = dijkstra_step( p_dijkstra, end );
+	}
 
 	#ifdef DEBUG_DIJKSTRA
-	p_dijkstra->allocations++;
+	bench_mark_end( p_dijkstra->bm );
+	bench_mark_report( p_dijkstra->bm );
 	#endif
 
- 	/* 2.) Add the start node to the open list. */
-	pbheap_push( &p_dijkstra->open_list, p_node );
-	hash_map_insert( &p_dijkstra->open_hash_map, p_node->state, p_node );
+	return found;
+}
 
- 	/* 3.) While the open list is not empty, do the following: */
-	while( !found && pbheap_size(&p_dijkstra->open_list) > 0 )
+/*
+ * Copy the results of the last search in the dense state ID mode
+ * to distances[ i * stride ] and parents[ i ]; either may be NULL.
+ * Returns the number of states the search closed.
+ */
+static size_t dijkstra_export( const dijkstra_t* __restrict p_dijkstra, unsigned int* __restrict distances, size_t stride, size_t* __restrict parents ) /* O(N) */
+{
+	size_t reached = 0;
+	size_t i;
+	assert( p_dijkstra );
+	assert( dijkstra_is_indexed(p_dijkstra) );
+
+	for( i = 0; i < p_dijkstra->num_states; i++ )
 	{
- 		/* a.) Get a node from the open list, call it N. */
-		dijkstra_node_t* p_current_node = pbheap_peek( &p_dijkstra->open_list );
-		pbheap_pop( &p_dijkstra->open_list );
-		hash_map_remove( &p_dijkstra->open_hash_map, p_current_node->state );
+		const dijkstra_node_t* p_node = &p_dijkstra->node_array[ i ];
+		bool is_reached               = p_node->generation == p_dijkstra->generation && p_node->status == DIJKSTRA_CLOSED;
 
-		/* b.) If N is the goal node, return true. */
-		if( p_dijkstra->compare( p_current_node->state, end ) == 0 )
+		if( distances )
 		{
-			/* NOTE: This final node will not have the final cost
- 			 * in the dijkstra_node_t object.
- 			 */
-			p_dijkstra->node_path = p_current_node;
-			found = true;
+			distances[ i * stride ] = is_reached ? p_node->c : UINT_MAX;
 		}
-		else
-		{
-			/* c.) Get the successor nodes of N. */
-			p_dijkstra->successors_of( p_current_node->state, &p_dijkstra->successors );
-
-			/* d.) For each successor node S: */
-			for( i = 0; i < successors_size(&p_dijkstra->successors); i++ )
-			{
-				const void* __restrict successor_state = successors_get( &p_dijkstra->successors, i );
-
-				/* i.) If S is in the closed list, continue. */
-				void* found_node;
-				#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-				if( tree_map_find( &p_dijkstra->closed_list, successor_state, &found_node ) )
-				#else
-				if( hash_map_find( &p_dijkstra->closed_list, successor_state, &found_node ) )
-				#endif
-				{
-					/* NOTE: The closed list is used to prevent re-examining
- 					 * nodes that already have the minimal cost computed in
- 					 * them. Without this, nodes would be added to the open
- 					 * list without ever having a hope of being more optimal
- 					 * than already computed. Although this is not needed,
- 					 * it may improve performance.  Profiling will be needed
- 					 * to determine this.
-					 */
-					continue;
-				}
-
-				/* ii.) If S is in the open list, update its cost with the cost of
-				 *      N plus the cost to go from N to S, if it is better.  Make
-				 *      sure to resort the open list.
-				 */
-				if( hash_map_find( &p_dijkstra->open_hash_map, successor_state, &found_node ) )
-				{
-					dijkstra_node_t* p_found_node = (dijkstra_node_t*) found_node;
-
-					int c = p_dijkstra->cost( p_current_node->state, successor_state );
-
-					if( default_cost_compare( c, p_found_node->c ) < 0 )
-					{
-						p_found_node->c      = c;
-						p_found_node->parent = p_current_node;
-
-						pbheap_reheapify( &p_dijkstra->open_list );
-					}
-				}
-				else
-				{
-					/* iii.) If S is not in the open list, add it with the cost of N
-					 *       plus the cost to go from N to S.
-					 */
-					dijkstra_node_t* p_new_node = (dijkstra_node_t*) p_dijkstra->alloc( sizeof(dijkstra_node_t) );
-					p_new_node->parent     = p_current_node;
-					p_new_node->c          = p_current_node->c + p_dijkstra->cost( p_current_node->state, successor_state );
-					p_new_node->state      = successor_state;
-
-					pbheap_push( &p_dijkstra->open_list, p_new_node );
-					hash_map_insert( &p_dijkstra->open_hash_map, p_new_node->state, p_new_node );
-
-					#ifdef DEBUG_DIJKSTRA
-					p_dijkstra->allocations++;
-					#endif
-				}
-			} /* for */
 
-			successors_clear( &p_dijkstra->successors );
+		if( parents )
+		{
+			parents[ i ] = is_reached && p_node->parent ? (size_t) (p_node->parent - p_dijkstra->node_array) : SIZE_MAX;
 		}
 
-		/* e.) Add p_current_node to the closed list. */
-		#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-		tree_map_insert( &p_dijkstra->closed_list, p_current_node->state, p_current_node );
-		#else
-		hash_map_insert( &p_dijkstra->closed_list, p_current_node->state, p_current_node );
-		#endif
+		reached += is_reached;
 	}
 
-	#ifdef DEBUG_BEST_FIRST_SEARCH
-	bench_mark_end( p_dijkstra->bm );
-	bench_mark_report( p_dijkstra->bm );
-	#endif
+	return reached;
+}
 
-	return found;
+size_t dijkstra_compute_all( dijkstra_t* __restrict p_dijkstra, const void* __restrict source, unsigned int* __restrict distances, size_t* __restrict parents ) /* O(N lg N) */
+{
+	assert( p_dijkstra );
+	assert( dijkstra_is_indexed(p_dijkstra) );
+
+	/* with no end state, the search runs until the open list is empty */
+	dijkstra_find( p_dijkstra, source, NULL );
+
+	return dijkstra_export( p_dijkstra, distances, 1, parents );
 }
 
 void dijkstra_cleanup( dijkstra_t* p_dijkstra )
 {
-	lc_hash_map_iterator_t open_itr;
-	#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-	lc_tree_map_iterator_t closed_itr;
-	#else
-	lc_hash_map_iterator_t closed_itr;
-	#endif
-
 	assert( p_dijkstra );
-	assert( hash_map_size(&p_dijkstra->open_hash_map) == pbheap_size(&p_dijkstra->open_list) );
 
 	p_dijkstra->node_path = NULL;
-	successors_clear( &p_dijkstra->successors );
-	pbheap_clear( &p_dijkstra->open_list );
-
-	hash_map_iterator( &p_dijkstra->open_hash_map, &open_itr );
-	// free everything on the open list.
-	while( hash_map_iterator_next( &open_itr ) )
-	{
-		dijkstra_node_t* p_node = hash_map_iterator_value( &open_itr );
-		p_dijkstra->free( p_node );
-		#ifdef DEBUG_DIJKSTRA
-		p_dijkstra->allocations--;
-		#endif
-	}
-	hash_map_clear( &p_dijkstra->open_hash_map );
+	successors_release_states( &p_dijkstra->successors );
+	assert( dijkstra_is_indexed(p_dijkstra) || state_table_size(&p_dijkstra->states) >= dijkstra_open_list_size(p_dijkstra) );
+	dijkstra_open_list_clear( p_dijkstra );
 
-	#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-	// free everything on the closed list.
-	for( closed_itr = tree_map_begin( &p_dijkstra->closed_list );
-	     closed_itr != tree_map_end( );
-	     closed_itr = tree_map_next( closed_itr ) )
+	if( dijkstra_is_indexed(p_dijkstra) )
 	{
-		p_dijkstra->free( closed_itr->value );
-		#ifdef DEBUG_DIJKSTRA
-		p_dijkstra->allocations--;
-		#endif
+		/* a new generation unvisits every node; clear the array only on wrap around */
+		if( ++p_dijkstra->generation == 0 )
+		{
+			memset( p_dijkstra->node_array, 0, sizeof(dijkstra_node_t) * p_dijkstra->num_states );
+			p_dijkstra->generation = 1;
+		}
 	}
-	tree_map_clear( &p_dijkstra->closed_list );
-	#else
-	hash_map_iterator( &p_dijkstra->closed_list, &closed_itr );
-	// free everything on the open list.
-	while( hash_map_iterator_next( &closed_itr ) )
+	else
 	{
-		dijkstra_node_t* p_node = hash_map_iterator_value( &closed_itr );
-		p_dijkstra->free( p_node );
-		#ifdef DEBUG_DIJKSTRA
-		p_dijkstra->allocations--;
-		#endif
+		state_table_clear( &p_dijkstra->states );
+
+		/* release every node at once */
+		arena_reset( &p_dijkstra->nodes );
 	}
-	hash_map_clear( &p_dijkstra->closed_list );
-	#endif
 
+	#ifdef DEBUG_DIJKSTRA
+	p_dijkstra->allocations = 0;
+	#endif
 }
 
 dijkstra_node_t* dijkstra_first_node( const dijkstra_t* p_dijkstra )
@@ -399,129 +703,24 @@ dijkstra_node_t* dijkstra_next_node( const dijkstra_node_t* p_node )
 
 void dijkstra_iterative_init( dijkstra_t* __restrict p_dijkstra, const void* __restrict start, const void* __restrict end, bool* found )
 {
-	dijkstra_node_t* p_node;
-	#ifdef DEBUG_BEST_FIRST_SEARCH
+	#ifdef DEBUG_DIJKSTRA
 	bench_mark_start( p_dijkstra->bm );
 	#endif
 	assert( p_dijkstra );
 	*found = false;
 
- 	/* 1.) Set the open list and closed list to be empty. */
-	dijkstra_cleanup( p_dijkstra );
-
-	p_node         = (dijkstra_node_t*) p_dijkstra->alloc( sizeof(dijkstra_node_t) );
-	p_node->parent = NULL;
-	p_node->c      = 0;
-	p_node->state  = start;
-
-	#ifdef DEBUG_DIJKSTRA
-	p_dijkstra->allocations++;
-	#endif
-
- 	/* 2.) Add the start node to the open list. */
-	pbheap_push( &p_dijkstra->open_list, p_node );
-	hash_map_insert( &p_dijkstra->open_hash_map, p_node->state, p_node );
+	dijkstra_start( p_dijkstra, start );
 }
 
 void dijkstra_iterative_find( dijkstra_t* __restrict p_dijkstra, const void* __restrict start, const void* __restrict end, bool* found )
 {
  	/* 3.) While the open list is not empty, do the following: */
-	if( !*found && pbheap_size(&p_dijkstra->open_list) > 0 )
+	if( !*found && dijkstra_open_list_size(p_dijkstra) > 0 )
 	{
- 		/* a.) Get a node from the open list, call it N. */
-		dijkstra_node_t* p_current_node = pbheap_peek( &p_dijkstra->open_list );
-		pbheap_pop( &p_dijkstra->open_list );
-		hash_map_remove( &p_dijkstra->open_hash_map, p_current_node->state );
-
-		/* b.) If N is the goal node, return true. */
-		if( p_dijkstra->compare( p_current_node->state, end ) == 0 )
-		{
-			/* NOTE: This final node will not have the final cost
- 			 * in the dijkstra_node_t object.
- 			 */
-			p_dijkstra->node_path = p_current_node;
-			*found = true;
-		}
-		else
-		{
-			int i;
-
-			/* c.) Get the successor nodes of N. */
-			p_dijkstra->successors_of( p_current_node->state, &p_dijkstra->successors );
-
-			/* d.) For each successor node S: */
-			for( i = 0; i < successors_size(&p_dijkstra->successors); i++ )
-			{
-				const void* __restrict successor_state = successors_get( &p_dijkstra->successors, i );
-
-				/* i.) If S is in the closed list, continue. */
-				void* found_node;
-				#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-				if( tree_map_find( &p_dijkstra->closed_list, successor_state, &found_node ) )
-				#else
-				if( hash_map_find( &p_dijkstra->closed_list, successor_state, &found_node ) )
-				#endif
-				{
-					/* NOTE: The closed list is used to prevent re-examining
- 					 * nodes that already have the minimal cost computed in
- 					 * them. Without this, nodes would be added to the open
- 					 * list without ever having a hope of being more optimal
- 					 * than already computed. Although this is not needed,
- 					 * it may improve performance.  Profiling will be needed
- 					 * to determine this.
-					 */
-					return;
-				}
-
-				/* ii.) If S is in the open list, update its cost with the cost of
-				 *      N plus the cost to go from N to S, if it is better.  Make
-				 *      sure to resort the open list.
-				 */
-				if( hash_map_find( &p_dijkstra->open_hash_map, successor_state, &found_node ) )
-				{
-					dijkstra_node_t* p_found_node = (dijkstra_node_t*) found_node;
-
-					int c = p_dijkstra->cost( p_current_node->state, successor_state );
-
-					if( default_cost_compare( c, p_found_node->c ) < 0 )
-					{
-						p_found_node->c      = c;
-						p_found_node->parent = p_current_node;
-
-						pbheap_reheapify( &p_dijkstra->open_list );
-					}
-				}
-				else
-				{
-					/* iii.) If S is not in the open list, add it with the cost of N
-					 *       plus the cost to go from N to S.
-					 */
-					dijkstra_node_t* p_new_node = (dijkstra_node_t*) p_dijkstra->alloc( sizeof(dijkstra_node_t) );
-					p_new_node->parent     = p_current_node;
-					p_new_node->c          = p_current_node->c + p_dijkstra->cost( p_current_node->state, successor_state );
-					p_new_node->state      = successor_state;
-
-					pbheap_push( &p_dijkstra->open_list, p_new_node );
-					hash_map_insert( &p_dijkstra->open_hash_map, p_new_node->state, p_new_node );
-
-					#ifdef DEBUG_DIJKSTRA
-					p_dijkstra->allocations++;
-					#endif
-				}
-			} /* for */
-
-			successors_clear( &p_dijkstra->successors );
-		}
-
-		/* e.) Add p_current_node to the closed list. */
-		#ifdef USE_TREEMAP_FOR_CLOSEDLIST
-		tree_map_insert( &p_dijkstra->closed_list, p_current_node->state, p_current_node );
-		#else
-		hash_map_insert( &p_dijkstra->closed_list, p_current_node->state, p_current_node );
-		#endif
+		*found = dijkstra_step( p_dijkstra, end );
 	}
 
-	#ifdef DEBUG_BEST_FIRST_SEARCH
+	#ifdef DEBUG_DIJKSTRA
 	if( *found )
 	{
 		bench_mark_end( p_dijkstra->bm );
@@ -532,5 +731,22 @@ void dijkstra_iterative_find( dijkstra_t* __restrict p_dijkstra, const void* __r
 
 bool dijkstra_iterative_is_done( dijkstra_t* __restrict p_dijkstra, bool* found )
 {
-	return *found || pbheap_size(&p_dijkstra->open_list) == 0;
+	return *found || dijkstra_open_list_size(p_dijkstra) == 0;
+}
+
+void dijkstra_distances( const dijkstra_t* __restrict p_dijkstra, unsigned int* __restrict distances, size_t stride ) /* O(N) */
+{
+	assert( distances );
+	dijkstra_export( p_dijkstra, distances, stride, NULL );
+}
+
+const void* dijkstra_indexed_state( const dijkstra_t* p_dijkstra, size_t index ) /* O(1) */
+{
+	const dijkstra_node_t* p_node;
+	assert( p_dijkstra );
+	assert( dijkstra_is_indexed(p_dijkstra) );
+	assert( index < p_dijkstra->num_states );
+
+	p_node = &p_dijkstra->node_array[ index ];
+	return p_node->generation == p_dijkstra->generation ? p_node->state : NULL;
 }
@@ -0,0 +1,703 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <assert.h>
+#include <pthread.h>
+#include <collections/benchmark.h>
+#include "successors-private.h"
+#include "indexed-heap.h"
+#include "state-table.h"
+#include "arena.h"
+#include "csearch.h"
+
+enum hdastar_status {
+	HDASTAR_OPEN = 1,
+	HDASTAR_CLOSED
+};
+
+struct hdastar_node {
+	struct hdastar_node* parent; /* may belong to another thread */
+	int h; /* heuristic */
+	int g; /* cost */
+	int f; /* heuristic + cost */
+	int status; /* open or closed */
+	size_t open_index; /* position in the open list */
+	const void* state; /* vertex */
+};
+
+/*
+ * A state reached by one thread that belongs to another.
+ */
+typedef struct hdastar_message {
+	struct hdastar_message* next;
+	const void*     state;
+	hdastar_node_t* parent;
+	int             g;
+} hdastar_message_t;
+
+/*
+ * A lock-free queue with many producers and one consumer. Senders
+ * only swap the head, so a message can be briefly unreachable
+ * while its sender links it in; the receiver then sees an empty
+ * queue and tries again later.
+ */
+typedef struct hdastar_inbox {
+	hdastar_message_t* head; /* last message pushed, shared by the senders */
+	hdastar_message_t* tail; /* next message to pop, owned by the receiver */
+	hdastar_message_t  stub;
+} hdastar_inbox_t;
+
+typedef struct hdastar_worker {
+	hdastar_t*      p_hda;
+	pthread_t       thread;
+	hdastar_inbox_t inbox;
+	successors_t    successors;
+	arena_t         nodes; /* storage for hdastar_node_t */
+	arena_t         messages; /* storage for the hdastar_message_t this thread sends */
+	indexed_heap_t  open_list; /* heap of hdastar_node_t* */
+	state_table_t   states; /* hdastar_node_t* of every state this thread owns */
+	bool            sleeping; /* waiting for a message */
+} hdastar_worker_t;
+
+struct hdastar_algorithm {
+	alloc_fxn_t alloc;
+	free_fxn_t  free;
+
+	compare_fxn_t    compare;
+	state_hash_fxn_t state_hasher;
+	heuristic_fxn_t  heuristic;
+	cost_fxn_t       cost;
+	successors_fxn_t successors_of;
+	hdastar_node_t*  node_path;
+
+	const void*       end;
+	size_t            num_workers;
+	hdastar_worker_t* workers;
+
+	/* The thread that owns the end state is the only one that
+	 * writes these, but every thread reads best to prune nodes
+	 * that cannot lead to a cheaper path.
+	 */
+	int             best; /* cost of the best path found so far */
+	hdastar_node_t* goal_node;
+	bool            failed; /* a thread ran out of memory; every thread winds down */
+
+	/* Termination. The search is over when every thread is idle
+	 * and no message is in flight. Messages are counted before
+	 * they are sent and uncounted after they are handled, and a
+	 * thread only stops being idle while holding the lock, so
+	 * the check made under the lock cannot miss any work.
+	 */
+	size_t          outstanding; /* messages sent but not handled */
+	size_t          idle; /* threads with no work */
+	bool            done;
+	pthread_mutex_t lock;
+	pthread_cond_t  wake; /* a message was sent to a sleeping thread, or the search is over */
+
+	#ifdef DEBUG_HDASTAR
+	lc_bench_mark_t bm;
+	#endif
+};
+
+#define default_f_compare( f1, f2 )      ((f2) - (f1))
+
+static int best_f_compare( const void* __restrict p_n1, const void* __restrict p_n2 )
+{
+	return default_f_compare( ((hdastar_node_t* __restrict)p_n1)->f, ((hdastar_node_t* __restrict)p_n2)->f );
+}
+
+#if SIZE_MAX > 0xFFFFFFFF
+#define hdastar_mix( hash )   ((hash) * (size_t) 0x9E3779B97F4A7C15ULL)
+#else
+#define hdastar_mix( hash )   ((hash) * (size_t) 0x9E3779B9UL)
+#endif
+
+/*
+ * The thread that owns a state. The low bits of the mixed hash are
+ * used so they do not line up with the high bits that the state
+ * tables index by.
+ */
+static __inline hdastar_worker_t* hdastar_owner( hdastar_t* __restrict p_hda, const void* __restrict state )
+{
+	size_t mixed = hdastar_mix( p_hda->state_hasher( state ) );
+	return &p_hda->workers[ (mixed >> 16) % p_hda->num_workers ];
+}
+
+static void hdastar_inbox_init( hdastar_inbox_t* p_inbox )
+{
+	p_inbox->stub.next = NULL;
+	p_inbox->head      = &p_inbox->stub;
+	p_inbox->tail      = &p_inbox->stub;
+}
+
+static __inline void hdastar_inbox_push( hdastar_inbox_t* __restrict p_inbox, hdastar_message_t* __restrict p_message )
+{
+	hdastar_message_t* p_previous;
+
+	p_message->next = NULL;
+	p_previous      = __atomic_exchange_n( &p_inbox->head, p_message, __ATOMIC_ACQ_REL );
+	__atomic_store_n( &p_previous->next, p_message, __ATOMIC_SEQ_CST );
+}
+
+static __inline hdastar_message_t* hdastar_inbox_pop( hdastar_inbox_t* p_inbox )
+{
+	hdastar_message_t* p_tail = p_inbox->tail;
+	hdastar_message_t* p_next = __atomic_load_n( &p_tail->next, __ATOMIC_ACQUIRE );
+
+	if( p_tail == &p_inbox->stub )
+	{
+		if( !p_next )
+		{
+			return NULL;
+		}
+
+		p_inbox->tail = p_next;
+		p_tail        = p_next;
+		p_next        = __atomic_load_n( &p_tail->next, __ATOMIC_ACQUIRE );
+	}
+
+	if( p_next )
+	{
+		p_inbox->tail = p_next;
+		return p_tail;
+	}
+
+	/* p_tail is the last message unless a sender is still linking one in */
+	if( p_tail != __atomic_load_n( &p_inbox->head, __ATOMIC_ACQUIRE ) )
+	{
+		return NULL;
+	}
+
+	hdastar_inbox_push( p_inbox, &p_inbox->stub );
+	p_next = __atomic_load_n( &p_tail->next, __ATOMIC_ACQUIRE );
+
+	if( p_next )
+	{
+		p_inbox->tail = p_next;
+		return p_tail;
+	}
+
+	return NULL;
+}
+
+static __inline bool hdastar_inbox_is_empty( hdastar_inbox_t* p_inbox )
+{
+	return p_inbox->tail == &p_inbox->stub && !__atomic_load_n( &p_inbox->stub.next, __ATOMIC_SEQ_CST );
+}
+
+static bool hdastar_worker_create( hdastar_worker_t* p_worker, hdastar_t* p_hda )
+{
+	p_worker->p_hda    = p_hda;
+	p_worker->sleeping = false;
+	hdastar_inbox_init( &p_worker->inbox );
+
+	if( !successors_create( &p_worker->successors, 8, p_hda->alloc, p_hda->free ) )
+	{
+		return false;
+	}
+
+	arena_create( &p_worker->nodes, sizeof(hdastar_node_t) * 1024, p_hda->alloc, p_hda->free );
+	arena_create( &p_worker->messages, sizeof(hdastar_message_t) * 1024, p_hda->alloc, p_hda->free );
+
+	if( indexed_heap_create( &p_worker->open_list, 128, offsetof(hdastar_node_t, open_index), best_f_compare, p_hda->alloc, p_hda->free ) )
+	{
+		if( state_table_create( &p_worker->states, STATE_TABLE_DEFAULT_CAPACITY, offsetof(hdastar_node_t, state), p_hda->state_hasher, p_hda->compare, p_hda->alloc, p_hda->free ) )
+		{
+			return true;
+		}
+
+		indexed_heap_destroy( &p_worker->open_list );
+	}
+
+	/* undo the partial worker; hdastar_destroy() only sees whole ones */
+	arena_destroy( &p_worker->nodes );
+	arena_destroy( &p_worker->messages );
+	successors_destroy( &p_worker->successors );
+	return false;
+}
+
+static void hdastar_worker_destroy( hdastar_worker_t* p_worker )
+{
+	arena_destroy( &p_worker->nodes );
+	arena_destroy( &p_worker->messages );
+	successors_destroy( &p_worker->successors );
+	indexed_heap_destroy( &p_worker->open_list );
+	state_table_destroy( &p_worker->states );
+}
+
+static void hdastar_worker_clear( hdastar_worker_t* p_worker )
+{
+	hdastar_inbox_init( &p_worker->inbox );
+	successors_release_states( &p_worker->successors );
+	indexed_heap_clear( &p_worker->open_list );
+	state_table_clear( &p_worker->states );
+
+	/* release every node and message at once */
+	arena_reset( &p_worker->nodes );
+	arena_reset( &p_worker->messages );
+}
+
+/*
+ * Create a hash distributed A* search that runs on threads threads.
+ * Every state is owned by one thread, chosen by its hash, and only
+ * that thread keeps a node for it. The callbacks must be safe to
+ * call from several threads at once, and like the other engines,
+ * equal states must have the same hash.
+ */
+hdastar_t* hdastar_create( size_t threads, compare_fxn_t compare, state_hash_fxn_t state_hasher, heuristic_fxn_t heuristic, cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free )
+{
+	hdastar_t* p_hda;
+	assert( state_hasher );
+
+	if( threads < 1 )
+	{
+		threads = 1;
+	}
+
+	p_hda = (hdastar_t*) alloc( sizeof(hdastar_t) );
+
+	if( p_hda )
+	{
+		size_t i;
+
+		p_hda->alloc         = alloc;
+		p_hda->free          = free;
+		p_hda->compare       = compare;
+		p_hda->state_hasher  = state_hasher;
+		p_hda->heuristic     = heuristic;
+		p_hda->cost          = cost;
+		p_hda->successors_of = successors_of;
+		p_hda->node_path     = NULL;
+		p_hda->end           = NULL;
+		p_hda->best          = INT_MAX;
+		p_hda->goal_node     = NULL;
+		p_hda->num_workers   = 0;
+		p_hda->workers       = (hdastar_worker_t*) alloc( sizeof(hdastar_worker_t) * threads );
+		#ifdef DEBUG_HDASTAR
+		p_hda->bm            = bench_mark_create( "Hash Distributed A* Search Algorithm" );
+		#endif
+
+		pthread_mutex_init( &p_hda->lock, NULL );
+		pthread_cond_init( &p_hda->wake, NULL );
+
+		if( p_hda->workers )
+		{
+			for( i = 0; i < threads; i++ )
+			{
+				if( !hdastar_worker_create( &p_hda->workers[ i ], p_hda ) )
+				{
+					hdastar_destroy( &p_hda );
+					break;
+				}
+
+				p_hda->num_workers++;
+			}
+		}
+		else
+		{
+			hdastar_destroy( &p_hda );
+		}
+	}
+
+	return p_hda;
+}
+
+void hdastar_destroy( hdastar_t** p_hda )
+{
+	if( p_hda && *p_hda )
+	{
+		size_t i;
+
+		#ifdef DEBUG_HDASTAR
+		bench_mark_destroy( (*p_hda)->bm );
+		#endif
+
+		for( i = 0; i < (*p_hda)->num_workers; i++ )
+		{
+			hdastar_worker_destroy( &(*p_hda)->workers[ i ] );
+		}
+
+		if( (*p_hda)->workers )
+		{
+			(*p_hda)->free( (*p_hda)->workers );
+		}
+
+		pthread_mutex_destroy( &(*p_hda)->lock );
+		pthread_cond_destroy( &(*p_hda)->wake );
+
+		free_fxn_t _free = (*p_hda)->free;
+		_free( *p_hda );
+		*p_hda = NULL;
+	}
+}
+
+/*
+ * A state owned by p_worker was reached with cost g. Open it if it
+ * is new or was reached more cheaply than before. Closed nodes are
+ * reopened, because a cheaper path can arrive from another thread
+ * after a node has been expanded.
+ */
+static void hdastar_reach( hdastar_worker_t* __restrict p_worker, const void* __restrict state, hdastar_node_t* __restrict parent, int g )
+{
+	hdastar_t* p_hda = p_worker->p_hda;
+	state_table_entry_t* p_entry;
+	hdastar_node_t* p_node;
+
+	if( __atomic_load_n( &p_hda->failed, __ATOMIC_RELAXED ) )
+	{
+		return;
+	}
+
+	p_entry = state_table_probe( &p_worker->states, state );
+
+	if( !p_entry )
+	{
+		__atomic_store_n( &p_hda->failed, true, __ATOMIC_RELAXED );
+		return;
+	}
+
+	p_node = p_entry->node;
+
+	if( p_node )
+	{
+		if( g >= p_node->g )
+		{
+			return;
+		}
+
+		p_node->parent = parent;
+		p_node->g      = g;
+		p_node->f      = g + p_node->h;
+
+		if( p_node->status == HDASTAR_OPEN )
+		{
+			indexed_heap_promote( &p_worker->open_list, p_node );
+		}
+		else
+		{
+			p_node->status = HDASTAR_OPEN;
+			indexed_heap_push( &p_worker->open_list, p_node );
+		}
+	}
+	else
+	{
+		int h = p_hda->heuristic( state, p_hda->end );
+
+		/* it cannot lead to a cheaper path than the best one */
+		if( g + h >= __atomic_load_n( &p_hda->best, __ATOMIC_RELAXED ) )
+		{
+			return;
+		}
+
+		p_node = (hdastar_node_t*) arena_alloc( &p_worker->nodes, sizeof(hdastar_node_t) );
+
+		if( !p_node )
+		{
+			__atomic_store_n( &p_hda->failed, true, __ATOMIC_RELAXED );
+			return;
+		}
+
+		p_node->parent = parent;
+		p_node->h      = h;
+		p_node->g      = g;
+		p_node->f      = g + h;
+		p_node->status = HDASTAR_OPEN;
+		p_node->state  = state;
+
+		state_table_fill( &p_worker->states, p_entry, p_node );
+		indexed_heap_push( &p_worker->open_list, p_node );
+	}
+}
+
+/*
+ * Expand the best open node of p_worker. Successors owned by other
+ * threads are sent to them.
+ */
+static void hdastar_expand( hdastar_worker_t* p_worker )
+{
+	hdastar_t* p_hda               = p_worker->p_hda;
+	hdastar_node_t* p_current_node = indexed_heap_pop( &p_worker->open_list );
+	size_t i;
+
+	p_current_node->status = HDASTAR_CLOSED;
+
+	if( p_current_node->f >= __atomic_load_n( &p_hda->best, __ATOMIC_RELAXED ) ||
+	    __atomic_load_n( &p_hda->failed, __ATOMIC_RELAXED ) )
+	{
+		return;
+	}
+
+	if( p_hda->compare( p_current_node->state, p_hda->end ) == 0 )
+	{
+		/* only the owner of the end state gets here */
+		p_hda->goal_node = p_current_node;
+		__atomic_store_n( &p_hda->best, p_current_node->g, __ATOMIC_RELAXED );
+		return;
+	}
+
+	p_hda->successors_of( p_current_node->state, &p_worker->successors );
+
+	for( i = 0; i < successors_size(&p_worker->successors); i++ )
+	{
+		const void* __restrict successor_state = successors_get( &p_worker->successors, i );
+		hdastar_worker_t* p_owner              = hdastar_owner( p_hda, successor_state );
+		int g                                  = p_current_node->g + p_hda->cost( p_current_node->state, successor_state );
+
+		if( p_owner == p_worker )
+		{
+			hdastar_reach( p_worker, successor_state, p_current_node, g );
+		}
+		else
+		{
+			hdastar_message_t* p_message = (hdastar_message_t*) arena_alloc( &p_worker->messages, sizeof(hdastar_message_t) );
+
+			if( !p_message )
+			{
+				__atomic_store_n( &p_hda->failed, true, __ATOMIC_RELAXED );
+				break;
+			}
+
+			p_message->state  = successor_state;
+			p_message->parent = p_current_node;
+			p_message->g      = g;
+
+			__atomic_fetch_add( &p_hda->outstanding, 1, __ATOMIC_ACQ_REL );
+			hdastar_inbox_push( &p_owner->inbox, p_message );
+
+			/* Either the owner sees the message before it sleeps
+			 * or this thread sees that it is sleeping.
+			 */
+			if( __atomic_load_n( &p_owner->sleeping, __ATOMIC_SEQ_CST ) )
+			{
+				pthread_mutex_lock( &p_hda->lock );
+				pthread_cond_broadcast( &p_hda->wake );
+				pthread_mutex_unlock( &p_hda->lock );
+			}
+		}
+	}
+
+	successors_clear( &p_worker->successors );
+}
+
+/*
+ * Wait for a message while idle. Returns false once the search is
+ * over.
+ */
+static bool hdastar_wait( hdastar_worker_t* p_worker )
+{
+	hdastar_t* p_hda = p_worker->p_hda;
+	bool working     = false;
+
+	pthread_mutex_lock( &p_hda->lock );
+	p_hda->idle++;
+
+	while( !p_hda->done )
+	{
+		if( p_hda->idle == p_hda->num_workers && __atomic_load_n( &p_hda->outstanding, __ATOMIC_ACQUIRE ) == 0 )
+		{
+			p_hda->done = true;
+			pthread_cond_broadcast( &p_hda->wake );
+			break;
+		}
+
+		__atomic_store_n( &p_worker->sleeping, true, __ATOMIC_SEQ_CST );
+
+		if( !hdastar_inbox_is_empty( &p_worker->inbox ) )
+		{
+			__atomic_store_n( &p_worker->sleeping, false, __ATOMIC_RELAXED );
+			p_hda->idle--;
+			working = true;
+			break;
+		}
+
+		pthread_cond_wait( &p_hda->wake, &p_hda->lock );
+		__atomic_store_n( &p_worker->sleeping, false, __ATOMIC_RELAXED );
+	}
+
+	pthread_mutex_unlock( &p_hda->lock );
+	return working;
+}
+
+static void* hdastar_run( void* p_arg )
+{
+	hdastar_worker_t* p_worker = (hdastar_worker_t*) p_arg;
+	hdastar_t* p_hda           = p_worker->p_hda;
+
+	do {
+		hdastar_message_t* p_message;
+
+		while( (p_message = hdastar_inbox_pop( &p_worker->inbox )) != NULL )
+		{
+			hdastar_reach( p_worker, p_message->state, p_message->parent, p_message->g );
+			__atomic_fetch_sub( &p_hda->outstanding, 1, __ATOMIC_ACQ_REL );
+		}
+
+		if( !indexed_heap_is_empty( &p_worker->open_list ) )
+		{
+			hdastar_expand( p_worker );
+		}
+	} while( !indexed_heap_is_empty( &p_worker->open_list ) ||
+	         !hdastar_inbox_is_empty( &p_worker->inbox ) ||
+	         hdastar_wait( p_worker ) );
+
+	return NULL;
+}
+
+/*
+ * Hash Distributed A* Search Algorithm
+ * ------------------------------------------------------------------------
+ *   Input: The start node and goal nodes.
+ *  Output: True if goal node is found, false if goal node cannot be found
+ *          from the start node.
+ * ------------------------------------------------------------------------
+ * 1.) Send the start node to the thread that owns it.
+ * 2.) On every thread, until every thread is idle and no message
+ *     is in flight:
+ *        a.) Add the nodes sent to this thread to its open list
+ *            when they are new or cheaper than before.
+ *        b.) Get the best node from the open list, call it N.
+ *        c.) If N cannot beat the best path found so far, drop it.
+ *        d.) If N is the goal node, it is the best path so far.
+ *        e.) Otherwise send each successor of N to its owner.
+ * 3.) Return true if a path was found.
+ *
+ * The first path found is not always the cheapest, because other
+ * threads may still hold cheaper nodes, so the search runs until
+ * no thread has a node that could beat it. With an admissible
+ * heuristic the path found is optimal.
+ */
+bool hdastar_find( hdastar_t* __restrict p_hda, const void* __restrict start, const void* __restrict end )
+{
+	size_t started = 0;
+	size_t i;
+
+	#ifdef DEBUG_HDASTAR
+	bench_mark_start( p_hda->bm );
+	#endif
+
+	hdastar_cleanup( p_hda );
+	p_hda->end = end;
+
+ 	/* 1.) Send the start node to the thread that owns it. */
+	hdastar_reach( hdastar_owner( p_hda, start ), start, NULL, 0 );
+
+ 	/* 2.) Search on every thread. The calling thread is the first one. */
+	for( i = 1; i < p_hda->num_workers; i++ )
+	{
+		if( pthread_create( &p_hda->workers[ i ].thread, NULL, hdastar_run, &p_hda->workers[ i ] ) != 0 )
+		{
+			break;
+		}
+
+		started++;
+	}
+
+	if( started + 1 == p_hda->num_workers )
+	{
+		hdastar_run( &p_hda->workers[ 0 ] );
+	}
+	else
+	{
+		/* States owned by threads that did not start would never be
+		 * expanded. Stop the others and search on this thread alone.
+		 */
+		size_t num_workers = p_hda->num_workers;
+
+		pthread_mutex_lock( &p_hda->lock );
+		p_hda->done = true;
+		pthread_mutex_unlock( &p_hda->lock );
+
+		for( i = 1; i <= started; i++ )
+		{
+			pthread_join( p_hda->workers[ i ].thread, NULL );
+		}
+
+		started = 0;
+		hdastar_cleanup( p_hda );
+		p_hda->end         = end;
+		p_hda->num_workers = 1;
+
+		hdastar_reach( &p_hda->workers[ 0 ], start, NULL, 0 );
+		hdastar_run( &p_hda->workers[ 0 ] );
+
+		p_hda->num_workers = num_workers;
+	}
+
+	for( i = 1; i <= started; i++ )
+	{
+		pthread_join( p_hda->workers[ i ].thread, NULL );
+	}
+
+	/* a search that dropped states may have missed the cheapest path */
+	p_hda->node_path = p_hda->failed ? NULL : p_hda->goal_node;
+
+	#ifdef DEBUG_HDASTAR
+	bench_mark_end( p_hda->bm );
+	bench_mark_report( p_hda->bm );
+	#endif
+
+ 	/* 3.) Return true if a path was found. */
+	return p_hda->node_path != NULL;
+}
+
+void hdastar_cleanup( hdastar_t* p_hda )
+{
+	size_t i;
+
+	for( i = 0; i < p_hda->num_workers; i++ )
+	{
+		hdastar_worker_clear( &p_hda->workers[ i ] );
+	}
+
+	p_hda->node_path   = NULL;
+	p_hda->end         = NULL;
+	p_hda->best        = INT_MAX;
+	p_hda->goal_node   = NULL;
+	p_hda->failed      = false;
+	p_hda->outstanding = 0;
+	p_hda->idle        = 0;
+	p_hda->done        = false;
+}
+
+hdastar_node_t* hdastar_first_node( const hdastar_t* p_hda )
+{
+	assert( p_hda );
+	return p_hda->node_path;
+}
+
+const void* hdastar_state( const hdastar_node_t* p_node )
+{
+	assert( p_node );
+	return p_node->state;
+}
+
+hdastar_node_t* hdastar_next_node( const hdastar_node_t* p_node )
+{
+	assert( p_node );
+	return p_node->parent;
+}
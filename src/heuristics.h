@@ -21,6 +21,7 @@
  */
 #ifndef _GSEARCH_H_
 #define _GSEARCH_H_
+#include "csearch.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -38,6 +39,84 @@ typedef struct coordinate {
 unsigned int manhattan_distance ( const coordinate_t* c1, const coordinate_t* c2 );
 unsigned int euclidean_distance ( const coordinate_t* c1, const coordinate_t* c2 );
 
+/*
+ *  Pattern Databases
+ *
+ *  A pattern database stores, for every placement of a subset of
+ *  the tiles of a sliding-tile puzzle (the pattern), the number of
+ *  moves of those tiles needed to bring them to their goal cells.
+ *  It is built once with a backward breadth-first search from the
+ *  goal, where every tile outside of the pattern is treated as a
+ *  blank.
+ *  -----------------------------------------------------------
+ *  Boards are arrays of width * height ints holding the tile
+ *  values, with 0 for the blank. Boards of up to 64 cells are
+ *  supported.
+ *  -----------------------------------------------------------
+ *  Only moves of pattern tiles are counted, so the lookups of
+ *  disjoint patterns can be added and the sum is still an
+ *  admissible heuristic. pdb_additive_lookup() does this for a
+ *  partition of the tiles, such as 6-6-3 or 7-8 for the
+ *  15-puzzle.
+ *  -----------------------------------------------------------
+ *  A database with k tiles on an n cell board has n!/(n-k)!
+ *  one byte entries; building it needs another n bits per entry
+ *  of scratch memory.
+ */
+struct pattern_database;
+typedef struct pattern_database pdb_t;
+
+pdb_t*       pdb_create          ( size_t width, size_t height, const int* goal, const int* pattern, size_t pattern_size, alloc_fxn_t alloc, free_fxn_t free );
+void         pdb_destroy         ( pdb_t** p_pdb );
+size_t       pdb_size            ( const pdb_t* p_pdb );
+unsigned int pdb_lookup          ( const pdb_t* __restrict p_pdb, const int* __restrict board );
+unsigned int pdb_additive_lookup ( const pdb_t* const* __restrict p_pdbs, size_t count, const int* __restrict board );
+
+/*
+ *  Landmarks (ALT)
+ *
+ *  A landmark heuristic stores the cost from a few landmark states
+ *  to every state, found with one Dijkstra search per landmark. By
+ *  the triangle inequality, the cost between two states is at
+ *  least the difference of their costs to a landmark, and the
+ *  largest difference over all landmarks is an admissible and
+ *  consistent heuristic. It stays informed on maps where walls
+ *  make the straight-line distance a poor estimate.
+ *  -----------------------------------------------------------
+ *  States need dense IDs, like the indexed searches, and the graph
+ *  must be undirected: every edge costs the same both ways. The
+ *  landmarks are picked one at a time as the reachable state
+ *  farthest from the ones picked so far, starting from the seed.
+ *  alt_count() is less than count when fewer states are
+ *  reachable.
+ *  -----------------------------------------------------------
+ *  alt_lookup() is called from a heuristic_fxn_t, like the pattern
+ *  database lookups. Built with SSE4.1 (-msse4.1), it compares
+ *  four landmarks at a time.
+ *  -----------------------------------------------------------
+ *  The table holds count * num_states unsigned ints, with count
+ *  rounded up to a multiple of 4.
+ *  -----------------------------------------------------------
+ *  alt_save() writes the table to a versioned binary file, and
+ *  alt_load() maps such a file read-only instead of building the
+ *  table again. Loading takes no time for the distances, which
+ *  are paged in as lookups touch them, and processes that load
+ *  the same file share its pages. A file only loads on machines
+ *  with the same byte order, for the same num_states; the states
+ *  must have the same IDs as when it was saved. alt_load() returns
+ *  NULL when the file is missing or does not match.
+ */
+struct landmarks;
+typedef struct landmarks alt_t;
+
+alt_t*       alt_create          ( size_t count, const void* seed, size_t num_states, state_index_fxn_t state_index, compare_fxn_t compare, nonnegative_cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free );
+void         alt_destroy         ( alt_t** p_alt );
+bool         alt_save            ( const alt_t* __restrict p_alt, const char* __restrict filename );
+alt_t*       alt_load            ( const char* __restrict filename, size_t num_states, state_index_fxn_t state_index, alloc_fxn_t alloc, free_fxn_t free );
+size_t       alt_count           ( const alt_t* p_alt );
+size_t       alt_landmark        ( const alt_t* p_alt, size_t i );
+unsigned int alt_lookup          ( const alt_t* __restrict p_alt, const void* __restrict state, const void* __restrict goal );
+
 
 #ifdef __cplusplus
 } /* extern C Linkage */
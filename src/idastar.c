@@ -0,0 +1,407 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <assert.h>
+#include <collections/benchmark.h>
+#include "successors-private.h"
+#include "csearch.h"
+
+struct idastar_node {
+	struct idastar_node* parent;
+	int g; /* cost */
+	const void* state; /* vertex */
+};
+
+/*
+ * One level of the depth-first search. Frames are allocated the
+ * first time the search gets this deep and are reused afterwards,
+ * so the nodes on the path never move.
+ */
+typedef struct idastar_frame {
+	idastar_node_t node;
+	successors_t   successors;
+	size_t         next; /* next successor to visit */
+} idastar_frame_t;
+
+struct idastar_algorithm {
+	alloc_fxn_t alloc;
+	free_fxn_t  free;
+
+	compare_fxn_t    compare;
+	heuristic_fxn_t  heuristic;
+	cost_fxn_t       cost;
+	successors_fxn_t successors_of;
+	idastar_node_t*  node_path;
+
+	const void*       start;
+	const void*       end;
+	int               bound; /* f limit of this iteration */
+	int               next_bound; /* smallest f above the limit */
+	idastar_frame_t** frames;
+	size_t            frames_capacity;
+	size_t            frames_allocated;
+	size_t            depth; /* frames on the stack */
+	bool              failed; /* out of memory; the search ends without a path */
+
+	#ifdef DEBUG_IDASTAR
+	size_t          expansions;
+	lc_bench_mark_t bm;
+	#endif
+};
+
+
+idastar_t* idastar_create( compare_fxn_t compare, heuristic_fxn_t heuristic, cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free )
+{
+	idastar_t* p_idastar = (idastar_t*) alloc( sizeof(idastar_t) );
+
+	if( p_idastar )
+	{
+		p_idastar->alloc            = alloc;
+		p_idastar->free             = free;
+		p_idastar->compare          = compare;
+		p_idastar->heuristic        = heuristic;
+		p_idastar->cost             = cost;
+		p_idastar->successors_of    = successors_of;
+		p_idastar->node_path        = NULL;
+		p_idastar->start            = NULL;
+		p_idastar->end              = NULL;
+		p_idastar->bound            = 0;
+		p_idastar->next_bound       = INT_MAX;
+		p_idastar->frames           = NULL;
+		p_idastar->frames_capacity  = 0;
+		p_idastar->frames_allocated = 0;
+		p_idastar->depth            = 0;
+		p_idastar->failed           = false;
+		#ifdef DEBUG_IDASTAR
+		p_idastar->expansions       = 0;
+		p_idastar->bm               = bench_mark_create( "IDA* Search Algorithm" );
+		#endif
+	}
+
+	return p_idastar;
+}
+
+void idastar_destroy( idastar_t** p_idastar )
+{
+	if( p_idastar && *p_idastar )
+	{
+		size_t i;
+
+		#ifdef DEBUG_IDASTAR
+		bench_mark_destroy( (*p_idastar)->bm );
+		#endif
+
+		for( i = 0; i < (*p_idastar)->frames_allocated; i++ )
+		{
+			successors_destroy( &(*p_idastar)->frames[ i ]->successors );
+			(*p_idastar)->free( (*p_idastar)->frames[ i ] );
+		}
+
+		if( (*p_idastar)->frames )
+		{
+			(*p_idastar)->free( (*p_idastar)->frames );
+		}
+
+		free_fxn_t _free = (*p_idastar)->free;
+		_free( *p_idastar );
+		*p_idastar = NULL;
+	}
+}
+
+void idastar_set_compare_fxn( idastar_t* p_idastar, compare_fxn_t compare )
+{
+	if( p_idastar )
+	{
+		assert( compare );
+		p_idastar->compare = compare;
+	}
+}
+
+void idastar_set_heuristic_fxn( idastar_t* p_idastar, heuristic_fxn_t heuristic )
+{
+	if( p_idastar )
+	{
+		assert( heuristic );
+		p_idastar->heuristic = heuristic;
+	}
+}
+
+void idastar_set_cost_fxn( idastar_t* p_idastar, cost_fxn_t cost )
+{
+	if( p_idastar )
+	{
+		assert( cost );
+		p_idastar->cost = cost;
+	}
+}
+
+void idastar_set_successors_fxn( idastar_t* p_idastar, successors_fxn_t successors_of )
+{
+	if( p_idastar )
+	{
+		assert( successors_of );
+		p_idastar->successors_of = successors_of;
+	}
+}
+
+/*
+ * Make sure there is a frame for the next level of the search.
+ * This only allocates the first time the search reaches a new
+ * depth.
+ */
+static bool idastar_reserve_frame( idastar_t* p_idastar )
+{
+	if( p_idastar->depth < p_idastar->frames_allocated )
+	{
+		return true;
+	}
+
+	if( p_idastar->frames_allocated >= p_idastar->frames_capacity )
+	{
+		size_t capacity          = p_idastar->frames_capacity ? 2 * p_idastar->frames_capacity : 64;
+		idastar_frame_t** frames = (idastar_frame_t**) p_idastar->alloc( sizeof(idastar_frame_t*) * capacity );
+
+		if( !frames )
+		{
+			return false;
+		}
+
+		if( p_idastar->frames )
+		{
+			memcpy( frames, p_idastar->frames, sizeof(idastar_frame_t*) * p_idastar->frames_allocated );
+			p_idastar->free( p_idastar->frames );
+		}
+
+		p_idastar->frames          = frames;
+		p_idastar->frames_capacity = capacity;
+	}
+
+	idastar_frame_t* p_frame = (idastar_frame_t*) p_idastar->alloc( sizeof(idastar_frame_t) );
+
+	if( !p_frame || !successors_create( &p_frame->successors, 8, p_idastar->alloc, p_idastar->free ) )
+	{
+		if( p_frame ) p_idastar->free( p_frame );
+		return false;
+	}
+
+	p_idastar->frames[ p_idastar->frames_allocated++ ] = p_frame;
+	return true;
+}
+
+/*
+ * Visit a state at the next depth. States whose f exceeds the
+ * bound are not pushed; they only lower the next bound. Returns
+ * true when the state is the goal.
+ */
+static bool idastar_push( idastar_t* __restrict p_idastar, const void* __restrict state, int g )
+{
+	idastar_frame_t* p_frame;
+	int f = g + p_idastar->heuristic( state, p_idastar->end );
+
+	if( f > p_idastar->bound )
+	{
+		if( f < p_idastar->next_bound )
+		{
+			p_idastar->next_bound = f;
+		}
+		return false;
+	}
+
+	if( !idastar_reserve_frame( p_idastar ) )
+	{
+		/* Out of memory. Pruning the branch could miss the goal or
+		 * the smallest cut off f, so unwind and end the search.
+		 */
+		p_idastar->failed = true;
+		p_idastar->depth  = 0;
+		return false;
+	}
+
+	p_frame              = p_idastar->frames[ p_idastar->depth ];
+	p_frame->node.parent = p_idastar->depth > 0 ? &p_idastar->frames[ p_idastar->depth - 1 ]->node : NULL;
+	p_frame->node.g      = g;
+	p_frame->node.state  = state;
+	p_frame->next        = 0;
+	successors_release_states( &p_frame->successors );
+	p_idastar->depth++;
+
+	if( p_idastar->compare( state, p_idastar->end ) == 0 )
+	{
+		p_idastar->node_path = &p_frame->node;
+		return true;
+	}
+
+	#ifdef DEBUG_IDASTAR
+	p_idastar->expansions++;
+	#endif
+	p_idastar->successors_of( state, &p_frame->successors );
+	return false;
+}
+
+/*
+ * Start the first iteration with the bound set to the start
+ * state's heuristic. Returns true when the start is the goal.
+ */
+static bool idastar_start( idastar_t* __restrict p_idastar, const void* __restrict start, const void* __restrict end )
+{
+	idastar_cleanup( p_idastar );
+
+	p_idastar->start = start;
+	p_idastar->end   = end;
+	p_idastar->bound = p_idastar->heuristic( start, end );
+
+	return idastar_push( p_idastar, start, 0 );
+}
+
+/*
+ * Advance the depth-first search by one state. When an iteration
+ * runs out of states, the next one starts over from the start
+ * state with the bound raised to the smallest f that was cut off.
+ * Returns true when the goal was found.
+ */
+static bool idastar_step( idastar_t* p_idastar )
+{
+	idastar_frame_t* p_top;
+
+	if( p_idastar->depth == 0 )
+	{
+		p_idastar->bound      = p_idastar->next_bound;
+		p_idastar->next_bound = INT_MAX;
+
+		return idastar_push( p_idastar, p_idastar->start, 0 );
+	}
+
+	p_top = p_idastar->frames[ p_idastar->depth - 1 ];
+
+	while( p_top->next < successors_size(&p_top->successors) )
+	{
+		const void* successor_state = successors_get( &p_top->successors, p_top->next++ );
+
+		/* Do not walk straight back to where we came from. */
+		if( p_top->node.parent && p_idastar->compare( successor_state, p_top->node.parent->state ) == 0 )
+		{
+			continue;
+		}
+
+		return idastar_push( p_idastar, successor_state, p_top->node.g + p_idastar->cost( p_top->node.state, successor_state ) );
+	}
+
+	p_idastar->depth--;
+	return false;
+}
+
+bool idastar_find( idastar_t* __restrict p_idastar, const void* __restrict start, const void* __restrict end )
+{
+	bool found = false;
+
+	#ifdef DEBUG_IDASTAR
+	bench_mark_start( p_idastar->bm );
+	#endif
+	assert( p_idastar );
+
+	found = idastar_start( p_idastar, start, end );
+
+	while( !idastar_iterative_is_done( p_idastar, &found ) )
+	{
+		found = idastar_step( p_idastar );
+	}
+
+	#ifdef DEBUG_IDASTAR
+	bench_mark_end( p_idastar->bm );
+	bench_mark_report( p_idastar->bm );
+	printf( "[IDA*] Expanded %zu nodes.\n", p_idastar->expansions );
+	#endif
+
+	return found;
+}
+
+void idastar_cleanup( idastar_t* p_idastar )
+{
+	assert( p_idastar );
+
+	p_idastar->node_path  = NULL;
+	p_idastar->start      = NULL;
+	p_idastar->end        = NULL;
+	p_idastar->depth      = 0;
+	p_idastar->next_bound = INT_MAX;
+	p_idastar->failed     = false;
+
+	#ifdef DEBUG_IDASTAR
+	p_idastar->expansions = 0;
+	#endif
+}
+
+idastar_node_t* idastar_first_node( const idastar_t* p_idastar )
+{
+	assert( p_idastar );
+	return p_idastar->node_path;
+}
+
+const void* idastar_state( const idastar_node_t* p_node )
+{
+	assert( p_node );
+	return p_node->state;
+}
+
+idastar_node_t* idastar_next_node( const idastar_node_t* p_node )
+{
+	assert( p_node );
+	return p_node->parent;
+}
+
+void idastar_iterative_init( idastar_t* __restrict p_idastar, const void* __restrict start, const void* __restrict end, bool* found )
+{
+	#ifdef DEBUG_IDASTAR
+	bench_mark_start( p_idastar->bm );
+	#endif
+	assert( p_idastar );
+	*found = idastar_start( p_idastar, start, end );
+}
+
+void idastar_iterative_find( idastar_t* __restrict p_idastar, const void* __restrict start, const void* __restrict end, bool* found )
+{
+	if( !idastar_iterative_is_done( p_idastar, found ) )
+	{
+		*found = idastar_step( p_idastar );
+	}
+
+	#ifdef DEBUG_IDASTAR
+	if( *found )
+	{
+		bench_mark_end( p_idastar->bm );
+		bench_mark_report( p_idastar->bm );
+	}
+	#endif
+}
+
+/*
+ * The search is over when the goal was found, when an iteration
+ * ended without cutting off any state, or when it ran out of memory.
+ */
+bool idastar_iterative_is_done( idastar_t* __restrict p_idastar, bool* found )
+{
+	return *found || p_idastar->failed || (p_idastar->depth == 0 && p_idastar->next_bound == INT_MAX);
+}
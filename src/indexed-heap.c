@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "indexed-heap.h"
+
+#define indexed_heap_parent( i )   (((i) - 1) >> 1)
+#define indexed_heap_left( i )     (((i) << 1) + 1)
+#define indexed_heap_right( i )    (((i) << 1) + 2)
+
+static __inline size_t* indexed_heap_slot( const indexed_heap_t* __restrict p_heap, void* __restrict element )
+{
+	return (size_t*) ((unsigned char*) element + p_heap->index_offset);
+}
+
+static __inline void indexed_heap_place( indexed_heap_t* __restrict p_heap, size_t index, void* __restrict element )
+{
+	p_heap->array[ index ] = element;
+	*indexed_heap_slot( p_heap, element ) = index;
+}
+
+static void indexed_heap_sift_up( indexed_heap_t* p_heap, size_t index )
+{
+	void* element = p_heap->array[ index ];
+
+	while( index > 0 )
+	{
+		size_t parent = indexed_heap_parent( index );
+
+		if( p_heap->compare( element, p_heap->array[ parent ] ) <= 0 )
+		{
+			break;
+		}
+
+		indexed_heap_place( p_heap, index, p_heap->array[ parent ] );
+		index = parent;
+	}
+
+	indexed_heap_place( p_heap, index, element );
+}
+
+static void indexed_heap_sift_down( indexed_heap_t* p_heap, size_t index )
+{
+	void* element = p_heap->array[ index ];
+
+	for( ;; )
+	{
+		size_t left  = indexed_heap_left( index );
+		size_t right = indexed_heap_right( index );
+		size_t best  = left;
+
+		if( left >= p_heap->size )
+		{
+			break;
+		}
+
+		if( right < p_heap->size && p_heap->compare( p_heap->array[ right ], p_heap->array[ left ] ) > 0 )
+		{
+			best = right;
+		}
+
+		if( p_heap->compare( p_heap->array[ best ], element ) <= 0 )
+		{
+			break;
+		}
+
+		indexed_heap_place( p_heap, index, p_heap->array[ best ] );
+		index = best;
+	}
+
+	indexed_heap_place( p_heap, index, element );
+}
+
+bool indexed_heap_create( indexed_heap_t* p_heap, size_t capacity, size_t index_offset, indexed_heap_compare_fxn_t compare, alloc_fxn_t alloc, free_fxn_t free )
+{
+	assert( p_heap );
+	assert( compare );
+
+	p_heap->compare      = compare;
+	p_heap->index_offset = index_offset;
+	p_heap->capacity     = capacity > 0 ? capacity : 1;
+	p_heap->size         = 0;
+	p_heap->alloc        = alloc;
+	p_heap->free         = free;
+	p_heap->array        = p_heap->alloc( sizeof(void*) * p_heap->capacity );
+
+	assert( p_heap->array );
+	return p_heap->array != NULL;
+}
+
+void indexed_heap_destroy( indexed_heap_t* p_heap )
+{
+	assert( p_heap );
+	p_heap->free( p_heap->array );
+
+	#ifdef _DEBUG_INDEXED_HEAP
+	p_heap->array    = NULL;
+	p_heap->capacity = 0;
+	p_heap->size     = 0;
+	#endif
+}
+
+bool indexed_heap_push( indexed_heap_t* __restrict p_heap, void* __restrict element ) /* O(lg N) */
+{
+	assert( p_heap );
+
+	/* grow the array if needed */
+	if( p_heap->size >= p_heap->capacity )
+	{
+		size_t new_capacity = 2 * p_heap->capacity;
+		void** new_array    = p_heap->alloc( sizeof(void*) * new_capacity );
+
+		if( !new_array )
+		{
+			return false;
+		}
+
+		memcpy( new_array, p_heap->array, sizeof(void*) * p_heap->size );
+		p_heap->free( p_heap->array );
+		p_heap->array    = new_array;
+		p_heap->capacity = new_capacity;
+	}
+
+	p_heap->array[ p_heap->size ] = element;
+	indexed_heap_sift_up( p_heap, p_heap->size++ );
+
+	return true;
+}
+
+void* indexed_heap_pop( indexed_heap_t* p_heap ) /* O(lg N) */
+{
+	void* top;
+	assert( p_heap );
+	assert( indexed_heap_size(p_heap) > 0 );
+
+	top = p_heap->array[ 0 ];
+
+	if( --p_heap->size > 0 )
+	{
+		p_heap->array[ 0 ] = p_heap->array[ p_heap->size ];
+		indexed_heap_sift_down( p_heap, 0 );
+	}
+
+	return top;
+}
+
+/*
+ * Restore the heap property after the priority of an element
+ * that is already in the heap has improved.
+ */
+void indexed_heap_promote( indexed_heap_t* __restrict p_heap, void* __restrict element ) /* O(lg N) */
+{
+	size_t index;
+	assert( p_heap );
+
+	index = *indexed_heap_slot( p_heap, element );
+	assert( index < p_heap->size && p_heap->array[ index ] == element );
+
+	indexed_heap_sift_up( p_heap, index );
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _INDEXED_HEAP_H_
+#define _INDEXED_HEAP_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include "csearch.h"
+
+/*
+ * An indexed binary heap of pointers. Every element reserves a
+ * size_t field that the heap keeps up to date with the element's
+ * position in the array. This lets an element whose priority
+ * improved be sifted up in O(lg N) instead of reheapifying
+ * everything.
+ *
+ * The compare function returns a positive number when the first
+ * element has a higher priority than the second.
+ */
+typedef int (*indexed_heap_compare_fxn_t)( const void* __restrict e1, const void* __restrict e2 );
+
+typedef struct indexed_heap {
+	indexed_heap_compare_fxn_t compare;
+	size_t index_offset; /* offset of the size_t position field in an element */
+	size_t capacity;
+	size_t size;
+	void** array;
+
+	alloc_fxn_t alloc;
+	free_fxn_t  free;
+} indexed_heap_t;
+
+bool  indexed_heap_create  ( indexed_heap_t* p_heap, size_t capacity, size_t index_offset, indexed_heap_compare_fxn_t compare, alloc_fxn_t alloc, free_fxn_t free );
+void  indexed_heap_destroy ( indexed_heap_t* p_heap );
+bool  indexed_heap_push    ( indexed_heap_t* __restrict p_heap, void* __restrict element ); /* O(lg N) */
+void* indexed_heap_pop     ( indexed_heap_t* p_heap ); /* O(lg N) */
+void  indexed_heap_promote ( indexed_heap_t* __restrict p_heap, void* __restrict element ); /* O(lg N) */
+
+#define indexed_heap_peek( p_heap )      ((p_heap)->array[ 0 ])
+#define indexed_heap_size( p_heap )      ((p_heap)->size)
+#define indexed_heap_is_empty( p_heap )  ((p_heap)->size <= 0)
+#define indexed_heap_clear( p_heap )     ((p_heap)->size = 0)
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _INDEXED_HEAP_H_ */
@@ -0,0 +1,649 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <collections/benchmark.h>
+#include "indexed-heap.h"
+#include "csearch.h"
+
+#define JPS_STRAIGHT_COST    10
+#define JPS_DIAGONAL_COST    14
+#define JPS_NONE             ((size_t) -1)
+
+/*
+ * The grid is kept as two bitmaps, one row-major and one
+ * column-major, so both horizontal and vertical scans can test
+ * 64 cells at a time. Every line starts with JPS_PAD blocked
+ * bits and there is a blocked line above and below the grid, so
+ * neighbors of any cell can be read without bounds checks.
+ */
+#define JPS_PAD              64
+#define jps_stride( length ) (((length) + JPS_PAD) / 64 + 2)
+
+#if defined(__GNUC__)
+#define jps_lowest_bit( x )  ((int) __builtin_ctzll( x ))
+#define jps_highest_bit( x ) (63 - (int) __builtin_clzll( x ))
+#else
+static __inline int jps_lowest_bit( uint64_t x )  { int i = 0; while( !((x >> i) & 1) ) i++; return i; }
+static __inline int jps_highest_bit( uint64_t x ) { int i = 63; while( !((x >> i) & 1) ) i--; return i; }
+#endif
+
+enum jps_status {
+	JPS_UNVISITED = 0,
+	JPS_OPEN,
+	JPS_CLOSED
+};
+
+struct jps_node {
+	struct jps_node* parent;
+	int g; /* cost */
+	int f; /* heuristic + cost */
+	int status; /* unvisited, open or closed */
+	unsigned int generation; /* search that last reached this node */
+	size_t open_index; /* position in the open list */
+	size_t cell; /* y * width + x */
+};
+
+struct jps_algorithm {
+	alloc_fxn_t alloc;
+	free_fxn_t  free;
+
+	size_t         width;
+	size_t         height;
+	size_t         row_stride; /* words per row */
+	size_t         column_stride; /* words per column */
+	uint64_t*      rows; /* row-major walkable bits */
+	uint64_t*      columns; /* column-major walkable bits */
+
+	size_t         goal;
+	jps_node_t*    node_path;
+	jps_node_t*    node_array; /* one node per cell */
+	unsigned int   generation; /* nodes stamped with an older generation are unvisited */
+	indexed_heap_t open_list; /* heap of jps_node_t* */
+
+	#ifdef DEBUG_JPS
+	size_t          expansions;
+	lc_bench_mark_t bm;
+	#endif
+};
+
+#define default_f_compare( f1, f2 )      ((f2) - (f1))
+
+static int best_f_compare( const void* __restrict p_n1, const void* __restrict p_n2 )
+{
+	return default_f_compare(((jps_node_t*)p_n1)->f,  ((jps_node_t*)p_n2)->f);
+}
+
+/*
+ * Read 64 bits of a line starting at bit position q.
+ */
+static __inline uint64_t jps_bits( const uint64_t* __restrict line, size_t q )
+{
+	size_t word     = q >> 6;
+	unsigned int sh = q & 63;
+
+	return sh ? (line[ word ] >> sh) | (line[ word + 1 ] << (64 - sh)) : line[ word ];
+}
+
+/*
+ * Cells just outside of the grid are always blocked.
+ */
+static __inline bool jps_walkable( const jps_t* __restrict p_jps, int x, int y )
+{
+	size_t q = (size_t) (x + JPS_PAD);
+	return (p_jps->rows[ (size_t) (y + 1) * p_jps->row_stride + (q >> 6) ] >> (q & 63)) & 1;
+}
+
+/*
+ * Octile distance. This is exact between two jump points since
+ * they are always connected by a straight or diagonal line.
+ */
+static __inline int jps_distance( const jps_t* __restrict p_jps, size_t c1, size_t c2 )
+{
+	int dx = abs( (int) (c1 % p_jps->width) - (int) (c2 % p_jps->width) );
+	int dy = abs( (int) (c1 / p_jps->width) - (int) (c2 / p_jps->width) );
+
+	return dx < dy ? JPS_DIAGONAL_COST * dx + JPS_STRAIGHT_COST * (dy - dx) :
+	                 JPS_DIAGONAL_COST * dy + JPS_STRAIGHT_COST * (dx - dy);
+}
+
+static bool jps_load_grid( jps_t* __restrict p_jps, const jps_grid_t* __restrict p_grid )
+{
+	size_t cells = p_grid->width * p_grid->height;
+	size_t x, y;
+
+	if( p_jps->width != p_grid->width || p_jps->height != p_grid->height )
+	{
+		if( p_jps->rows )       p_jps->free( p_jps->rows );
+		if( p_jps->columns )    p_jps->free( p_jps->columns );
+		if( p_jps->node_array ) p_jps->free( p_jps->node_array );
+
+		p_jps->width         = p_grid->width;
+		p_jps->height        = p_grid->height;
+		p_jps->row_stride    = jps_stride( p_grid->width );
+		p_jps->column_stride = jps_stride( p_grid->height );
+		p_jps->rows          = (uint64_t*) p_jps->alloc( sizeof(uint64_t) * p_jps->row_stride * (p_grid->height + 2) );
+		p_jps->columns       = (uint64_t*) p_jps->alloc( sizeof(uint64_t) * p_jps->column_stride * (p_grid->width + 2) );
+		p_jps->node_array    = (jps_node_t*) p_jps->alloc( sizeof(jps_node_t) * cells );
+
+		if( !p_jps->rows || !p_jps->columns || !p_jps->node_array )
+		{
+			return false;
+		}
+
+		memset( p_jps->node_array, 0, sizeof(jps_node_t) * cells );
+		p_jps->generation = 1;
+	}
+
+	memset( p_jps->rows, 0, sizeof(uint64_t) * p_jps->row_stride * (p_jps->height + 2) );
+	memset( p_jps->columns, 0, sizeof(uint64_t) * p_jps->column_stride * (p_jps->width + 2) );
+
+	for( y = 0; y < p_jps->height; y++ )
+	{
+		for( x = 0; x < p_jps->width; x++ )
+		{
+			size_t cell = y * p_jps->width + x;
+
+			if( (p_grid->walkable[ cell >> 3 ] >> (cell & 7)) & 1 )
+			{
+				size_t qx = x + JPS_PAD;
+				size_t qy = y + JPS_PAD;
+
+				p_jps->rows[ (y + 1) * p_jps->row_stride + (qx >> 6) ]       |= (uint64_t) 1 << (qx & 63);
+				p_jps->columns[ (x + 1) * p_jps->column_stride + (qy >> 6) ] |= (uint64_t) 1 << (qy & 63);
+			}
+		}
+	}
+
+	return true;
+}
+
+
+jps_t* jps_create( const jps_grid_t* p_grid, alloc_fxn_t alloc, free_fxn_t free )
+{
+	jps_t* p_jps;
+	assert( p_grid );
+	assert( p_grid->width > 0 && p_grid->height > 0 );
+	assert( p_grid->walkable );
+
+	p_jps = (jps_t*) alloc( sizeof(jps_t) );
+
+	if( p_jps )
+	{
+		p_jps->alloc         = alloc;
+		p_jps->free          = free;
+		p_jps->width         = 0;
+		p_jps->height        = 0;
+		p_jps->row_stride    = 0;
+		p_jps->column_stride = 0;
+		p_jps->rows          = NULL;
+		p_jps->columns       = NULL;
+		p_jps->goal          = JPS_NONE;
+		p_jps->node_path     = NULL;
+		p_jps->node_array    = NULL;
+		p_jps->generation    = 1;
+		#ifdef DEBUG_JPS
+		p_jps->expansions    = 0;
+		p_jps->bm            = bench_mark_create( "Jump Point Search" );
+		#endif
+
+		if( !indexed_heap_create( &p_jps->open_list, 128, offsetof(jps_node_t, open_index), best_f_compare, alloc, free ) )
+		{
+			#ifdef DEBUG_JPS
+			bench_mark_destroy( p_jps->bm );
+			#endif
+			free( p_jps );
+			return NULL;
+		}
+
+		if( !jps_load_grid( p_jps, p_grid ) )
+		{
+			jps_destroy( &p_jps );
+		}
+	}
+
+	return p_jps;
+}
+
+void jps_destroy( jps_t** p_jps )
+{
+	if( p_jps && *p_jps )
+	{
+		#ifdef DEBUG_JPS
+		bench_mark_destroy( (*p_jps)->bm );
+		#endif
+
+		indexed_heap_destroy( &(*p_jps)->open_list );
+		if( (*p_jps)->rows )       (*p_jps)->free( (*p_jps)->rows );
+		if( (*p_jps)->columns )    (*p_jps)->free( (*p_jps)->columns );
+		if( (*p_jps)->node_array ) (*p_jps)->free( (*p_jps)->node_array );
+
+		free_fxn_t _free = (*p_jps)->free;
+		_free( *p_jps );
+		*p_jps = NULL;
+	}
+}
+
+/*
+ * Re-read the walkable bitmap, for example after the map
+ * changed. The grid may also have a different size.
+ */
+bool jps_set_grid( jps_t* __restrict p_jps, const jps_grid_t* __restrict p_grid )
+{
+	assert( p_jps );
+	assert( p_grid );
+	assert( p_grid->width > 0 && p_grid->height > 0 );
+	assert( p_grid->walkable );
+
+	jps_cleanup( p_jps );
+	return jps_load_grid( p_jps, p_grid );
+}
+
+static __inline jps_node_t* jps_lookup( jps_t* __restrict p_jps, size_t cell )
+{
+	jps_node_t* p_node = &p_jps->node_array[ cell ];
+	return p_node->generation == p_jps->generation ? p_node : NULL;
+}
+
+static __inline void jps_open( jps_t* __restrict p_jps, jps_node_t* __restrict parent, size_t cell, int g )
+{
+	jps_node_t* p_node = &p_jps->node_array[ cell ];
+
+	p_node->parent     = parent;
+	p_node->g          = g;
+	p_node->f          = g + jps_distance( p_jps, cell, p_jps->goal );
+	p_node->status     = JPS_OPEN;
+	p_node->generation = p_jps->generation;
+	p_node->cell       = cell;
+
+	indexed_heap_push( &p_jps->open_list, p_node );
+}
+
+/*
+ * Scan along one line of the grid, 64 cells at a time, from
+ * position pos in direction dir. The lines before and after it
+ * are its neighbors. Returns the position of the first jump
+ * point, or JPS_NONE if the scan runs into an obstacle first.
+ * goal is the goal's position on this line, or JPS_NONE.
+ */
+static size_t jps_scan( const uint64_t* __restrict line, const uint64_t* __restrict before, const uint64_t* __restrict after, int pos, int dir, size_t goal )
+{
+	size_t q      = (size_t) (pos + JPS_PAD);
+	size_t goal_q = goal == JPS_NONE ? JPS_NONE : goal + JPS_PAD;
+
+	if( dir > 0 )
+	{
+		for( ;; q += 64 )
+		{
+			uint64_t stop   = ~jps_bits( line, q );
+			uint64_t forced = (jps_bits( before, q ) & ~jps_bits( before, q - 1 )) |
+			                  (jps_bits( after, q ) & ~jps_bits( after, q - 1 ));
+
+			if( goal_q != JPS_NONE && goal_q >= q && goal_q - q < 64 )
+			{
+				forced |= (uint64_t) 1 << (goal_q - q);
+			}
+
+			if( stop | forced )
+			{
+				int s = stop ? jps_lowest_bit( stop ) : 64;
+				int f = forced ? jps_lowest_bit( forced ) : 64;
+
+				return f < s ? q + f - JPS_PAD : JPS_NONE;
+			}
+		}
+	}
+	else
+	{
+		for( ;; q -= 64 )
+		{
+			size_t base     = q - 63;
+			uint64_t stop   = ~jps_bits( line, base );
+			uint64_t forced = (jps_bits( before, base ) & ~jps_bits( before, base + 1 )) |
+			                  (jps_bits( after, base ) & ~jps_bits( after, base + 1 ));
+
+			if( goal_q != JPS_NONE && goal_q <= q && q - goal_q < 64 )
+			{
+				forced |= (uint64_t) 1 << (goal_q - base);
+			}
+
+			if( stop | forced )
+			{
+				int s = stop ? jps_highest_bit( stop ) : -1;
+				int f = forced ? jps_highest_bit( forced ) : -1;
+
+				return f > s ? base + f - JPS_PAD : JPS_NONE;
+			}
+		}
+	}
+}
+
+/*
+ * Scan from (x, y) in the direction (dx, dy) until a jump point
+ * is found. Returns the jump point's cell, or JPS_NONE if the
+ * scan runs into an obstacle or the edge of the grid.
+ *
+ * A cell is a jump point if it is the goal, if it has a forced
+ * neighbor (one that cannot be reached optimally without going
+ * through this cell), or, for diagonal moves, if a straight scan
+ * from it finds a jump point.
+ */
+static size_t jps_jump( const jps_t* __restrict p_jps, int x, int y, int dx, int dy )
+{
+	size_t jump_point;
+
+	if( dx && dy )
+	{
+		for( ;; )
+		{
+			size_t cell;
+
+			if( !jps_walkable( p_jps, x, y ) )
+			{
+				return JPS_NONE;
+			}
+
+			cell = (size_t) y * p_jps->width + x;
+
+			if( cell == p_jps->goal ||
+			    jps_jump( p_jps, x + dx, y, dx, 0 ) != JPS_NONE ||
+			    jps_jump( p_jps, x, y + dy, 0, dy ) != JPS_NONE )
+			{
+				return cell;
+			}
+
+			/* diagonal moves may not cut corners */
+			if( !jps_walkable( p_jps, x + dx, y ) || !jps_walkable( p_jps, x, y + dy ) )
+			{
+				return JPS_NONE;
+			}
+
+			x += dx;
+			y += dy;
+		}
+	}
+	else if( dx )
+	{
+		const uint64_t* row = p_jps->rows + (size_t) (y + 1) * p_jps->row_stride;
+		size_t goal         = p_jps->goal / p_jps->width == (size_t) y ? p_jps->goal % p_jps->width : JPS_NONE;
+
+		jump_point = jps_scan( row, row - p_jps->row_stride, row + p_jps->row_stride, x, dx, goal );
+		return jump_point == JPS_NONE ? JPS_NONE : (size_t) y * p_jps->width + jump_point;
+	}
+	else
+	{
+		const uint64_t* column = p_jps->columns + (size_t) (x + 1) * p_jps->column_stride;
+		size_t goal            = p_jps->goal % p_jps->width == (size_t) x ? p_jps->goal / p_jps->width : JPS_NONE;
+
+		jump_point = jps_scan( column, column - p_jps->column_stride, column + p_jps->column_stride, y, dy, goal );
+		return jump_point == JPS_NONE ? JPS_NONE : jump_point * p_jps->width + x;
+	}
+}
+
+/*
+ * Collect the directions worth searching from a node. The start
+ * node has no parent so every legal move is searched; otherwise
+ * moves that are reached at least as cheaply through the parent
+ * are pruned.
+ */
+static size_t jps_directions( const jps_t* __restrict p_jps, const jps_node_t* __restrict p_node, int directions[ 8 ][ 2 ] )
+{
+	size_t count = 0;
+	int x        = (int) (p_node->cell % p_jps->width);
+	int y        = (int) (p_node->cell / p_jps->width);
+
+	#define jps_add_direction( DX, DY )  do { directions[ count ][ 0 ] = (DX); directions[ count ][ 1 ] = (DY); count++; } while(0)
+
+	if( !p_node->parent )
+	{
+		int dx, dy;
+
+		for( dy = -1; dy <= 1; dy++ )
+		{
+			for( dx = -1; dx <= 1; dx++ )
+			{
+				if( !dx && !dy ) continue;
+				if( !jps_walkable( p_jps, x + dx, y + dy ) ) continue;
+				if( dx && dy && (!jps_walkable( p_jps, x + dx, y ) || !jps_walkable( p_jps, x, y + dy )) ) continue;
+
+				jps_add_direction( dx, dy );
+			}
+		}
+	}
+	else
+	{
+		int px = (int) (p_node->parent->cell % p_jps->width);
+		int py = (int) (p_node->parent->cell / p_jps->width);
+		int dx = (x > px) - (x < px);
+		int dy = (y > py) - (y < py);
+
+		if( dx && dy )
+		{
+			bool vertical   = jps_walkable( p_jps, x, y + dy );
+			bool horizontal = jps_walkable( p_jps, x + dx, y );
+
+			if( vertical )                jps_add_direction( 0, dy );
+			if( horizontal )              jps_add_direction( dx, 0 );
+			if( vertical && horizontal )  jps_add_direction( dx, dy );
+		}
+		else if( dx )
+		{
+			bool next = jps_walkable( p_jps, x + dx, y );
+			bool up   = jps_walkable( p_jps, x, y - 1 );
+			bool down = jps_walkable( p_jps, x, y + 1 );
+
+			if( next )
+			{
+				jps_add_direction( dx, 0 );
+				if( up )   jps_add_direction( dx, -1 );
+				if( down ) jps_add_direction( dx, 1 );
+			}
+			if( up )   jps_add_direction( 0, -1 );
+			if( down ) jps_add_direction( 0, 1 );
+		}
+		else
+		{
+			bool next  = jps_walkable( p_jps, x, y + dy );
+			bool left  = jps_walkable( p_jps, x - 1, y );
+			bool right = jps_walkable( p_jps, x + 1, y );
+
+			if( next )
+			{
+				jps_add_direction( 0, dy );
+				if( left )  jps_add_direction( -1, dy );
+				if( right ) jps_add_direction( 1, dy );
+			}
+			if( left )  jps_add_direction( -1, 0 );
+			if( right ) jps_add_direction( 1, 0 );
+		}
+	}
+
+	#undef jps_add_direction
+	return count;
+}
+
+static void jps_start( jps_t* __restrict p_jps, size_t start, size_t end )
+{
+	assert( start < p_jps->width * p_jps->height );
+	assert( end < p_jps->width * p_jps->height );
+
+	jps_cleanup( p_jps );
+	p_jps->goal = end;
+	jps_open( p_jps, NULL, start, 0 );
+}
+
+/*
+ * Expand the best open node. Returns true when the goal node
+ * was found.
+ */
+static bool jps_step( jps_t* __restrict p_jps )
+{
+	int directions[ 8 ][ 2 ];
+	size_t count;
+	size_t i;
+	jps_node_t* p_current_node = indexed_heap_pop( &p_jps->open_list );
+	int x = (int) (p_current_node->cell % p_jps->width);
+	int y = (int) (p_current_node->cell / p_jps->width);
+
+	p_current_node->status = JPS_CLOSED;
+
+	if( p_current_node->cell == p_jps->goal )
+	{
+		p_jps->node_path = p_current_node;
+		return true;
+	}
+
+	#ifdef DEBUG_JPS
+	p_jps->expansions++;
+	#endif
+
+	count = jps_directions( p_jps, p_current_node, directions );
+
+	for( i = 0; i < count; i++ )
+	{
+		size_t jump_point = jps_jump( p_jps, x + directions[ i ][ 0 ], y + directions[ i ][ 1 ], directions[ i ][ 0 ], directions[ i ][ 1 ] );
+		jps_node_t* p_found_node;
+		int g;
+
+		if( jump_point == JPS_NONE )
+		{
+			continue;
+		}
+
+		p_found_node = jps_lookup( p_jps, jump_point );
+		g            = p_current_node->g + jps_distance( p_jps, p_current_node->cell, jump_point );
+
+		if( !p_found_node )
+		{
+			jps_open( p_jps, p_current_node, jump_point, g );
+		}
+		else if( p_found_node->status == JPS_OPEN && g < p_found_node->g )
+		{
+			p_found_node->f      -= p_found_node->g - g;
+			p_found_node->g       = g;
+			p_found_node->parent  = p_current_node;
+
+			indexed_heap_promote( &p_jps->open_list, p_found_node );
+		}
+	}
+
+	return false;
+}
+
+bool jps_find( jps_t* __restrict p_jps, size_t start, size_t end )
+{
+	bool found = false;
+
+	#ifdef DEBUG_JPS
+	bench_mark_start( p_jps->bm );
+	#endif
+	assert( p_jps );
+
+	jps_start( p_jps, start, end );
+
+	while( !found && indexed_heap_size(&p_jps->open_list) > 0 )
+	{
+		found = jps_step( p_jps );
+	}
+
+	#ifdef DEBUG_JPS
+	bench_mark_end( p_jps->bm );
+	bench_mark_report( p_jps->bm );
+	printf( "[JPS] Expanded %zu nodes.\n", p_jps->expansions );
+	#endif
+
+	return found;
+}
+
+void jps_cleanup( jps_t* p_jps )
+{
+	assert( p_jps );
+
+	p_jps->node_path = NULL;
+	p_jps->goal      = JPS_NONE;
+	indexed_heap_clear( &p_jps->open_list );
+
+	/* a new generation unvisits every node; clear the array only on wrap around */
+	if( ++p_jps->generation == 0 )
+	{
+		memset( p_jps->node_array, 0, sizeof(jps_node_t) * p_jps->width * p_jps->height );
+		p_jps->generation = 1;
+	}
+
+	#ifdef DEBUG_JPS
+	p_jps->expansions = 0;
+	#endif
+}
+
+jps_node_t* jps_first_node( const jps_t* p_jps )
+{
+	assert( p_jps );
+	return p_jps->node_path;
+}
+
+size_t jps_state( const jps_node_t* p_node )
+{
+	assert( p_node );
+	return p_node->cell;
+}
+
+jps_node_t* jps_next_node( const jps_node_t* p_node )
+{
+	assert( p_node );
+	return p_node->parent;
+}
+
+void jps_iterative_init( jps_t* __restrict p_jps, size_t start, size_t end, bool* found )
+{
+	#ifdef DEBUG_JPS
+	bench_mark_start( p_jps->bm );
+	#endif
+	assert( p_jps );
+	*found = false;
+
+	jps_start( p_jps, start, end );
+}
+
+void jps_iterative_find( jps_t* __restrict p_jps, size_t start, size_t end, bool* found )
+{
+	if( !*found && indexed_heap_size(&p_jps->open_list) > 0 )
+	{
+		*found = jps_step( p_jps );
+	}
+
+	#ifdef DEBUG_JPS
+	if( *found )
+	{
+		bench_mark_end( p_jps->bm );
+		bench_mark_report( p_jps->bm );
+	}
+	#endif
+}
+
+bool jps_iterative_is_done( jps_t* __restrict p_jps, bool* found )
+{
+	return *found || indexed_heap_size(&p_jps->open_list) == 0;
+}
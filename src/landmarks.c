@@ -0,0 +1,368 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <assert.h>
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+#include "dijkstra-private.h"
+#include "storage.h"
+#include "heuristics.h"
+
+#define ALT_MAX_LANDMARKS    64
+#define ALT_LANES            4 /* landmarks compared at once */
+#define ALT_UNREACHED        UINT_MAX
+
+/*
+ * A saved table holds the distances (see storage.h). Files are
+ * only read on machines with the same int size as the one that
+ * saved them.
+ */
+#define ALT_FILE_MAGIC       "CSALTTBL"
+#define ALT_FILE_VERSION     1
+
+typedef struct alt_file_header {
+	storage_file_header_t common;
+	uint64_t num_states;
+	uint64_t count;
+	uint64_t stride;
+	uint64_t landmarks[ ALT_MAX_LANDMARKS ];
+} alt_file_header_t;
+
+struct landmarks {
+	alloc_fxn_t alloc;
+	free_fxn_t  free;
+
+	state_index_fxn_t state_index;
+	size_t num_states;
+	size_t count; /* number of landmarks */
+	size_t stride; /* count rounded up to a multiple of ALT_LANES */
+	size_t landmarks[ ALT_MAX_LANDMARKS ]; /* state IDs of the landmarks */
+
+	/* distances[ id * stride + l ] is the cost from landmark l to
+	 * the state with that ID. The lanes past count are 0, so they
+	 * never raise the estimate.
+	 */
+	unsigned int* distances;
+	void*  mapping; /* the mapped file of a loaded table, or NULL */
+	size_t mapping_size;
+};
+
+
+/*
+ * The ID of the reachable state with the largest distance.
+ */
+static size_t alt_farthest( const unsigned int* distances, size_t num_states )
+{
+	size_t farthest = 0;
+	unsigned int best = 0;
+	size_t i;
+
+	for( i = 0; i < num_states; i++ )
+	{
+		if( distances[ i ] != ALT_UNREACHED && distances[ i ] >= best )
+		{
+			best     = distances[ i ];
+			farthest = i;
+		}
+	}
+
+	return farthest;
+}
+
+/*
+ * Shrink the stride to fit the landmarks that were chosen, when
+ * fewer states were reachable than landmarks were asked for, so
+ * the table is laid out like one built with the smaller count.
+ * Rows only move toward the front, and the lanes past count were
+ * never written, so they are still 0.
+ */
+static void alt_repack( alt_t* p_alt )
+{
+	size_t stride = (p_alt->count + ALT_LANES - 1) & ~((size_t) ALT_LANES - 1);
+	size_t i;
+
+	if( stride < p_alt->stride )
+	{
+		for( i = 1; i < p_alt->num_states; i++ )
+		{
+			memmove( &p_alt->distances[ i * stride ], &p_alt->distances[ i * p_alt->stride ], sizeof(unsigned int) * stride );
+		}
+
+		p_alt->stride = stride;
+	}
+}
+
+/*
+ * Farthest landmark selection. The first landmark is the state
+ * farthest from the seed, and every other landmark is the state
+ * farthest from the landmarks chosen so far. This spreads the
+ * landmarks out to the edges of the graph, where they give the
+ * best estimates.
+ */
+static bool alt_build( alt_t* __restrict p_alt, const void* __restrict seed, compare_fxn_t compare, nonnegative_cost_fxn_t cost, successors_fxn_t successors_of )
+{
+	dijkstra_t* p_dijkstra = dijkstra_create_indexed_ex( OPEN_LIST_RADIX_HEAP, p_alt->num_states, p_alt->state_index, compare, cost, successors_of, p_alt->alloc, p_alt->free );
+	unsigned int* nearest  = (unsigned int*) p_alt->alloc( sizeof(unsigned int) * p_alt->num_states ); /* distance to the nearest landmark */
+	size_t count           = p_alt->count;
+	size_t l;
+	size_t i;
+
+	if( !p_dijkstra || !nearest )
+	{
+		if( p_dijkstra ) dijkstra_destroy( &p_dijkstra );
+		if( nearest ) p_alt->free( nearest );
+		return false;
+	}
+
+	dijkstra_find( p_dijkstra, seed, NULL );
+	dijkstra_distances( p_dijkstra, nearest, 1 );
+
+	for( l = 0; l < count; l++ )
+	{
+		size_t farthest      = alt_farthest( nearest, p_alt->num_states );
+		const void* landmark = dijkstra_indexed_state( p_dijkstra, farthest );
+		unsigned int* column = &p_alt->distances[ l ];
+
+		/* every reachable state is a landmark already */
+		if( l > 0 && nearest[ farthest ] == 0 )
+		{
+			break;
+		}
+
+		/* the graph is undirected, so every search reaches the same states */
+		assert( landmark );
+
+		p_alt->landmarks[ l ] = farthest;
+		dijkstra_find( p_dijkstra, landmark, NULL );
+		dijkstra_distances( p_dijkstra, column, p_alt->stride );
+
+		for( i = 0; i < p_alt->num_states; i++ )
+		{
+			unsigned int d = column[ i * p_alt->stride ];
+
+			if( l == 0 || d < nearest[ i ] )
+			{
+				nearest[ i ] = d;
+			}
+		}
+	}
+
+	p_alt->count = l;
+	alt_repack( p_alt );
+
+	p_alt->free( nearest );
+	dijkstra_destroy( &p_dijkstra );
+	return true;
+}
+
+alt_t* alt_create( size_t count, const void* seed, size_t num_states, state_index_fxn_t state_index, compare_fxn_t compare, nonnegative_cost_fxn_t cost, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free )
+{
+	alt_t* p_alt;
+	assert( count > 0 && count <= ALT_MAX_LANDMARKS );
+	assert( seed );
+	assert( num_states > 0 );
+	assert( state_index );
+
+	p_alt = (alt_t*) alloc( sizeof(alt_t) );
+
+	if( p_alt )
+	{
+		p_alt->alloc       = alloc;
+		p_alt->free        = free;
+		p_alt->state_index = state_index;
+		p_alt->num_states  = num_states;
+		p_alt->count       = count;
+		p_alt->stride      = (count + ALT_LANES - 1) & ~((size_t) ALT_LANES - 1);
+		p_alt->mapping     = NULL;
+		p_alt->mapping_size = 0;
+		p_alt->distances   = (unsigned int*) alloc( sizeof(unsigned int) * num_states * p_alt->stride );
+
+		if( p_alt->distances )
+		{
+			memset( p_alt->distances, 0, sizeof(unsigned int) * num_states * p_alt->stride );
+		}
+
+		if( !p_alt->distances || !alt_build( p_alt, seed, compare, cost, successors_of ) )
+		{
+			alt_destroy( &p_alt );
+		}
+	}
+
+	return p_alt;
+}
+
+void alt_destroy( alt_t** p_alt )
+{
+	if( p_alt && *p_alt )
+	{
+		free_fxn_t _free = (*p_alt)->free;
+
+		if( (*p_alt)->mapping )
+		{
+			storage_unmap( (*p_alt)->mapping, (*p_alt)->mapping_size );
+		}
+		else if( (*p_alt)->distances )
+		{
+			_free( (*p_alt)->distances );
+		}
+
+		_free( *p_alt );
+		*p_alt = NULL;
+	}
+}
+
+bool alt_save( const alt_t* __restrict p_alt, const char* __restrict filename )
+{
+	alt_file_header_t header;
+	storage_section_t section;
+	size_t l;
+	assert( p_alt );
+	assert( filename );
+
+	memset( &header, 0, sizeof(header) );
+	storage_header_init( &header.common, ALT_FILE_MAGIC, ALT_FILE_VERSION );
+	header.num_states = p_alt->num_states;
+	header.count      = p_alt->count;
+	header.stride     = p_alt->stride;
+
+	for( l = 0; l < p_alt->count; l++ )
+	{
+		header.landmarks[ l ] = p_alt->landmarks[ l ];
+	}
+
+	section.data = p_alt->distances;
+	section.size = sizeof(unsigned int) * p_alt->num_states * p_alt->stride;
+
+	return storage_save( filename, &header, sizeof(header), &section, 1 );
+}
+
+alt_t* alt_load( const char* __restrict filename, size_t num_states, state_index_fxn_t state_index, alloc_fxn_t alloc, free_fxn_t free )
+{
+	const alt_file_header_t* header;
+	alt_t* p_alt;
+	void* mapping;
+	size_t size;
+	size_t l;
+	assert( filename );
+	assert( state_index );
+
+	if( sizeof(unsigned int) != sizeof(uint32_t) || !(mapping = storage_map( filename, &size )) )
+	{
+		return NULL;
+	}
+
+	header = (const alt_file_header_t*) mapping;
+
+	if( !storage_header_is_valid( &header->common, ALT_FILE_MAGIC, ALT_FILE_VERSION ) ||
+	    header->num_states != num_states ||
+	    header->count == 0 || header->count > ALT_MAX_LANDMARKS ||
+	    header->stride != ((header->count + ALT_LANES - 1) & ~((uint64_t) ALT_LANES - 1)) ||
+	    (uint64_t) size != STORAGE_FILE_DATA_OFFSET + sizeof(unsigned int) * header->num_states * header->stride ||
+	    !(p_alt = (alt_t*) alloc( sizeof(alt_t) )) )
+	{
+		storage_unmap( mapping, size );
+		return NULL;
+	}
+
+	p_alt->alloc        = alloc;
+	p_alt->free         = free;
+	p_alt->state_index  = state_index;
+	p_alt->num_states   = num_states;
+	p_alt->count        = (size_t) header->count;
+	p_alt->stride       = (size_t) header->stride;
+	p_alt->distances    = (unsigned int*) storage_data( mapping );
+	p_alt->mapping      = mapping;
+	p_alt->mapping_size = size;
+
+	for( l = 0; l < p_alt->count; l++ )
+	{
+		p_alt->landmarks[ l ] = (size_t) header->landmarks[ l ];
+	}
+
+	return p_alt;
+}
+
+size_t alt_count( const alt_t* p_alt )
+{
+	assert( p_alt );
+	return p_alt->count;
+}
+
+size_t alt_landmark( const alt_t* p_alt, size_t i )
+{
+	assert( p_alt );
+	assert( i < p_alt->count );
+	return p_alt->landmarks[ i ];
+}
+
+/*
+ * By the triangle inequality, the cost between two states is at
+ * least the difference of their costs to any landmark. A landmark
+ * that cannot reach one of the states tells nothing and is
+ * skipped.
+ */
+unsigned int alt_lookup( const alt_t* __restrict p_alt, const void* __restrict state, const void* __restrict goal )
+{
+	const unsigned int* a = &p_alt->distances[ p_alt->state_index( state ) * p_alt->stride ];
+	const unsigned int* b = &p_alt->distances[ p_alt->state_index( goal ) * p_alt->stride ];
+	unsigned int best     = 0;
+	size_t l;
+
+	#if defined(__SSE4_1__)
+	const __m128i unreached = _mm_set1_epi32( -1 );
+	__m128i best4           = _mm_setzero_si128( );
+
+	for( l = 0; l < p_alt->stride; l += ALT_LANES )
+	{
+		__m128i a4   = _mm_loadu_si128( (const __m128i*) &a[ l ] );
+		__m128i b4   = _mm_loadu_si128( (const __m128i*) &b[ l ] );
+		__m128i d4   = _mm_sub_epi32( _mm_max_epu32( a4, b4 ), _mm_min_epu32( a4, b4 ) );
+		__m128i skip = _mm_or_si128( _mm_cmpeq_epi32( a4, unreached ), _mm_cmpeq_epi32( b4, unreached ) );
+
+		best4 = _mm_max_epu32( best4, _mm_andnot_si128( skip, d4 ) );
+	}
+
+	best4 = _mm_max_epu32( best4, _mm_shuffle_epi32( best4, _MM_SHUFFLE(1, 0, 3, 2) ) );
+	best4 = _mm_max_epu32( best4, _mm_shuffle_epi32( best4, _MM_SHUFFLE(2, 3, 0, 1) ) );
+	best  = (unsigned int) _mm_cvtsi128_si32( best4 );
+	#else
+	for( l = 0; l < p_alt->count; l++ )
+	{
+		if( a[ l ] != ALT_UNREACHED && b[ l ] != ALT_UNREACHED )
+		{
+			unsigned int d = a[ l ] > b[ l ] ? a[ l ] - b[ l ] : b[ l ] - a[ l ];
+
+			if( d > best )
+			{
+				best = d;
+			}
+		}
+	}
+	#endif
+
+	return best;
+}
@@ -0,0 +1,773 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <pthread.h>
+#include <collections/benchmark.h>
+#include "successors-private.h"
+#include "arena.h"
+#include "storage.h"
+#include "csearch.h"
+
+#define PBFS_CHUNK   (64) /* frontier nodes claimed at a time */
+
+struct pbfs_node {
+	struct pbfs_node* parent;
+	size_t hash;
+	const void* state; /* vertex */
+};
+
+/*
+ * A successor found while expanding a level, before duplicates
+ * are removed.
+ */
+typedef struct pbfs_candidate {
+	const void*  state;
+	pbfs_node_t* parent;
+	size_t       hash;
+} pbfs_candidate_t;
+
+typedef struct pbfs_worker {
+	pbfs_t*           p_pbfs;
+	pthread_t         thread;
+	successors_t      successors;
+	arena_t           nodes; /* storage for pbfs_node_t */
+	pbfs_node_t*      spare; /* allocated but lost a race to insert */
+
+	pbfs_candidate_t* candidates;
+	size_t            candidates_size;
+	size_t            candidates_capacity;
+
+	pbfs_node_t**     next; /* this thread's part of the next frontier */
+	size_t            next_size;
+	size_t            next_capacity;
+	bool              failed; /* written by this thread, read after the next barrier */
+} pbfs_worker_t;
+
+/*
+ * Only the last thread to arrive at a barrier is told so, which
+ * lets it run the serial part between two levels.
+ */
+typedef struct pbfs_barrier {
+	pthread_mutex_t lock;
+	pthread_cond_t  cond;
+	size_t          count;
+	size_t          waiting;
+	size_t          generation;
+} pbfs_barrier_t;
+
+struct pbfs_algorithm {
+	alloc_fxn_t alloc;
+	free_fxn_t  free;
+
+	compare_fxn_t    compare;
+	state_hash_fxn_t state_hasher;
+	successors_fxn_t successors_of;
+	pbfs_node_t*     node_path;
+
+	const void*    end;
+	size_t         num_workers;
+	size_t         num_running; /* threads that started for this search */
+	pbfs_worker_t* workers;
+	pbfs_barrier_t barrier;
+	bool           done;
+
+	/* The visited set. Nodes are claimed with a compare and swap
+	 * on an empty slot, and the set only grows between levels,
+	 * when no thread is inserting.
+	 */
+	pbfs_node_t** visited;
+	size_t        visited_mask;
+	unsigned int  visited_shift;
+	size_t        visited_size;
+
+	pbfs_node_t** frontier;
+	size_t        frontier_size;
+	size_t        frontier_capacity;
+	size_t        frontier_next; /* next chunk to claim */
+
+	size_t*       level_sizes; /* states first reached at each level */
+	size_t        levels;
+	size_t        levels_capacity;
+
+	#ifdef DEBUG_PARALLEL_BREADTH_FIRST_SEARCH
+	lc_bench_mark_t bm;
+	#endif
+};
+
+#if SIZE_MAX > 0xFFFFFFFF
+#define pbfs_mix( hash )   ((hash) * (size_t) 0x9E3779B97F4A7C15ULL)
+#else
+#define pbfs_mix( hash )   ((hash) * (size_t) 0x9E3779B9UL)
+#endif
+
+static void pbfs_barrier_init( pbfs_barrier_t* p_barrier )
+{
+	pthread_mutex_init( &p_barrier->lock, NULL );
+	pthread_cond_init( &p_barrier->cond, NULL );
+	p_barrier->count      = 1;
+	p_barrier->waiting    = 0;
+	p_barrier->generation = 0;
+}
+
+static void pbfs_barrier_destroy( pbfs_barrier_t* p_barrier )
+{
+	pthread_mutex_destroy( &p_barrier->lock );
+	pthread_cond_destroy( &p_barrier->cond );
+}
+
+/*
+ * Returns true on exactly one thread, the last one to arrive.
+ */
+static bool pbfs_barrier_wait( pbfs_barrier_t* p_barrier )
+{
+	bool is_last = false;
+	size_t generation;
+
+	pthread_mutex_lock( &p_barrier->lock );
+	generation = p_barrier->generation;
+
+	if( ++p_barrier->waiting == p_barrier->count )
+	{
+		p_barrier->waiting = 0;
+		p_barrier->generation++;
+		pthread_cond_broadcast( &p_barrier->cond );
+		is_last = true;
+	}
+	else
+	{
+		while( generation == p_barrier->generation )
+		{
+			pthread_cond_wait( &p_barrier->cond, &p_barrier->lock );
+		}
+	}
+
+	pthread_mutex_unlock( &p_barrier->lock );
+	return is_last;
+}
+
+static __inline size_t pbfs_home( const pbfs_t* p_pbfs, size_t hash )
+{
+	return pbfs_mix( hash ) >> p_pbfs->visited_shift;
+}
+
+/*
+ * Called between levels only. Keeps the visited set at most half
+ * full after count more insertions.
+ */
+static bool pbfs_visited_reserve( pbfs_t* p_pbfs, size_t count )
+{
+	pbfs_node_t** old_visited = p_pbfs->visited;
+	size_t old_slots          = p_pbfs->visited_mask + 1;
+	size_t slots              = old_slots;
+	unsigned int shift        = p_pbfs->visited_shift;
+	size_t i;
+
+	while( 2 * (p_pbfs->visited_size + count) > slots )
+	{
+		slots *= 2;
+		shift--;
+	}
+
+	if( slots == old_slots )
+	{
+		return true;
+	}
+
+	p_pbfs->visited = (pbfs_node_t**) p_pbfs->alloc( sizeof(pbfs_node_t*) * slots );
+
+	if( !p_pbfs->visited )
+	{
+		p_pbfs->visited = old_visited;
+		return false;
+	}
+
+	memset( p_pbfs->visited, 0, sizeof(pbfs_node_t*) * slots );
+	p_pbfs->visited_mask  = slots - 1;
+	p_pbfs->visited_shift = shift;
+
+	for( i = 0; i < old_slots; i++ )
+	{
+		if( old_visited[ i ] )
+		{
+			size_t j = pbfs_home( p_pbfs, old_visited[ i ]->hash );
+
+			while( p_pbfs->visited[ j ] )
+			{
+				j = (j + 1) & p_pbfs->visited_mask;
+			}
+
+			p_pbfs->visited[ j ] = old_visited[ i ];
+		}
+	}
+
+	p_pbfs->free( old_visited );
+	return true;
+}
+
+/*
+ * Insert p_node unless its state has been visited. Safe to call
+ * from several threads at once. Returns true if p_node was
+ * inserted.
+ */
+static __inline bool pbfs_visit( pbfs_t* __restrict p_pbfs, pbfs_node_t* __restrict p_node )
+{
+	size_t i = pbfs_home( p_pbfs, p_node->hash );
+
+	for( ;; )
+	{
+		pbfs_node_t* p_found = __atomic_load_n( &p_pbfs->visited[ i ], __ATOMIC_ACQUIRE );
+
+		if( !p_found )
+		{
+			if( __atomic_compare_exchange_n( &p_pbfs->visited[ i ], &p_found, p_node, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE ) )
+			{
+				return true;
+			}
+
+			/* another thread took the slot; p_found is its node */
+		}
+
+		if( p_found->state == p_node->state ||
+		    (p_found->hash == p_node->hash && p_pbfs->compare && p_pbfs->compare( p_found->state, p_node->state ) == 0) )
+		{
+			return false;
+		}
+
+		i = (i + 1) & p_pbfs->visited_mask;
+	}
+}
+
+/*
+ * Like pbfs_visit(), fall back to pointer equality when there is no
+ * compare function.
+ */
+static __inline bool pbfs_is_end( const pbfs_t* __restrict p_pbfs, const void* __restrict state )
+{
+	return state == p_pbfs->end || (p_pbfs->compare && p_pbfs->compare( state, p_pbfs->end ) == 0);
+}
+
+static bool pbfs_worker_create( pbfs_worker_t* p_worker, pbfs_t* p_pbfs )
+{
+	p_worker->p_pbfs              = p_pbfs;
+	p_worker->spare               = NULL;
+	p_worker->candidates          = NULL;
+	p_worker->candidates_size     = 0;
+	p_worker->candidates_capacity = 0;
+	p_worker->next                = NULL;
+	p_worker->next_size           = 0;
+	p_worker->next_capacity       = 0;
+	p_worker->failed              = false;
+
+	if( !successors_create( &p_worker->successors, 8, p_pbfs->alloc, p_pbfs->free ) )
+	{
+		return false;
+	}
+
+	arena_create( &p_worker->nodes, sizeof(pbfs_node_t) * 1024, p_pbfs->alloc, p_pbfs->free );
+	return true;
+}
+
+static void pbfs_worker_destroy( pbfs_worker_t* p_worker )
+{
+	pbfs_t* p_pbfs = p_worker->p_pbfs;
+
+	arena_destroy( &p_worker->nodes );
+	successors_destroy( &p_worker->successors );
+
+	if( p_worker->candidates )
+	{
+		p_pbfs->free( p_worker->candidates );
+	}
+
+	if( p_worker->next )
+	{
+		p_pbfs->free( p_worker->next );
+	}
+}
+
+/*
+ * Create a parallel breadth first search that runs on threads
+ * threads. The callbacks must be safe to call from several threads
+ * at once, and equal states must have the same hash.
+ */
+pbfs_t* pbfs_create( size_t threads, compare_fxn_t compare, state_hash_fxn_t state_hasher, successors_fxn_t successors_of, alloc_fxn_t alloc, free_fxn_t free )
+{
+	pbfs_t* p_pbfs;
+	assert( state_hasher );
+
+	if( threads < 1 )
+	{
+		threads = 1;
+	}
+
+	p_pbfs = (pbfs_t*) alloc( sizeof(pbfs_t) );
+
+	if( p_pbfs )
+	{
+		size_t i;
+
+		p_pbfs->alloc             = alloc;
+		p_pbfs->free              = free;
+		p_pbfs->compare           = compare;
+		p_pbfs->state_hasher      = state_hasher;
+		p_pbfs->successors_of     = successors_of;
+		p_pbfs->node_path         = NULL;
+		p_pbfs->end               = NULL;
+		p_pbfs->num_workers       = 0;
+		p_pbfs->num_running       = 0;
+		p_pbfs->done              = false;
+		p_pbfs->visited_mask      = 1024 - 1;
+		p_pbfs->visited_shift     = 8 * sizeof(size_t) - 10;
+		p_pbfs->visited_size      = 0;
+		p_pbfs->frontier          = NULL;
+		p_pbfs->frontier_size     = 0;
+		p_pbfs->frontier_capacity = 0;
+		p_pbfs->frontier_next     = 0;
+		p_pbfs->level_sizes       = NULL;
+		p_pbfs->levels            = 0;
+		p_pbfs->levels_capacity   = 0;
+		p_pbfs->visited           = (pbfs_node_t**) alloc( sizeof(pbfs_node_t*) * (p_pbfs->visited_mask + 1) );
+		p_pbfs->workers           = (pbfs_worker_t*) alloc( sizeof(pbfs_worker_t) * threads );
+		#ifdef DEBUG_PARALLEL_BREADTH_FIRST_SEARCH
+		p_pbfs->bm                = bench_mark_create( "Parallel Breadth First Search Algorithm" );
+		#endif
+
+		pbfs_barrier_init( &p_pbfs->barrier );
+
+		if( p_pbfs->visited && p_pbfs->workers )
+		{
+			memset( p_pbfs->visited, 0, sizeof(pbfs_node_t*) * (p_pbfs->visited_mask + 1) );
+
+			for( i = 0; i < threads; i++ )
+			{
+				if( !pbfs_worker_create( &p_pbfs->workers[ i ], p_pbfs ) )
+				{
+					pbfs_destroy( &p_pbfs );
+					break;
+				}
+
+				p_pbfs->num_workers++;
+			}
+		}
+		else
+		{
+			pbfs_destroy( &p_pbfs );
+		}
+	}
+
+	return p_pbfs;
+}
+
+void pbfs_destroy( pbfs_t** p_pbfs )
+{
+	if( p_pbfs && *p_pbfs )
+	{
+		size_t i;
+
+		#ifdef DEBUG_PARALLEL_BREADTH_FIRST_SEARCH
+		bench_mark_destroy( (*p_pbfs)->bm );
+		#endif
+
+		for( i = 0; i < (*p_pbfs)->num_workers; i++ )
+		{
+			pbfs_worker_destroy( &(*p_pbfs)->workers[ i ] );
+		}
+
+		if( (*p_pbfs)->workers )     (*p_pbfs)->free( (*p_pbfs)->workers );
+		if( (*p_pbfs)->visited )     (*p_pbfs)->free( (*p_pbfs)->visited );
+		if( (*p_pbfs)->frontier )    (*p_pbfs)->free( (*p_pbfs)->frontier );
+		if( (*p_pbfs)->level_sizes ) (*p_pbfs)->free( (*p_pbfs)->level_sizes );
+
+		pbfs_barrier_destroy( &(*p_pbfs)->barrier );
+
+		free_fxn_t _free = (*p_pbfs)->free;
+		_free( *p_pbfs );
+		*p_pbfs = NULL;
+	}
+}
+
+/*
+ * Step a.) below. Threads claim chunks of the frontier, so a thread
+ * that draws states with few successors simply takes more chunks.
+ */
+static bool pbfs_expand( pbfs_worker_t* p_worker )
+{
+	pbfs_t* p_pbfs = p_worker->p_pbfs;
+	size_t first;
+
+	while( (first = __atomic_fetch_add( &p_pbfs->frontier_next, PBFS_CHUNK, __ATOMIC_RELAXED )) < p_pbfs->frontier_size )
+	{
+		size_t last = first + PBFS_CHUNK < p_pbfs->frontier_size ? first + PBFS_CHUNK : p_pbfs->frontier_size;
+		size_t n;
+
+		for( n = first; n < last; n++ )
+		{
+			pbfs_node_t* p_current_node = p_pbfs->frontier[ n ];
+			size_t i;
+
+			p_pbfs->successors_of( p_current_node->state, &p_worker->successors );
+
+			if( !storage_reserve( (void**) &p_worker->candidates, &p_worker->candidates_capacity, p_worker->candidates_size,
+			                      p_worker->candidates_size + successors_size(&p_worker->successors), sizeof(pbfs_candidate_t), p_pbfs->alloc, p_pbfs->free ) )
+			{
+				return false;
+			}
+
+			for( i = 0; i < successors_size(&p_worker->successors); i++ )
+			{
+				pbfs_candidate_t* p_candidate = &p_worker->candidates[ p_worker->candidates_size++ ];
+
+				p_candidate->state  = successors_get( &p_worker->successors, i );
+				p_candidate->parent = p_current_node;
+				p_candidate->hash   = p_pbfs->state_hasher( p_candidate->state );
+			}
+
+			successors_clear( &p_worker->successors );
+		}
+	}
+
+	return true;
+}
+
+/*
+ * Step c.) below. Every thread inserts its own candidates.
+ */
+static bool pbfs_insert( pbfs_worker_t* p_worker )
+{
+	pbfs_t* p_pbfs = p_worker->p_pbfs;
+	size_t i;
+
+	p_worker->next_size = 0;
+
+	if( !storage_reserve( (void**) &p_worker->next, &p_worker->next_capacity, 0, p_worker->candidates_size, sizeof(pbfs_node_t*), p_pbfs->alloc, p_pbfs->free ) )
+	{
+		return false;
+	}
+
+	for( i = 0; i < p_worker->candidates_size; i++ )
+	{
+		pbfs_candidate_t* p_candidate = &p_worker->candidates[ i ];
+		pbfs_node_t* p_node           = p_worker->spare ? p_worker->spare : (pbfs_node_t*) arena_alloc( &p_worker->nodes, sizeof(pbfs_node_t) );
+
+		if( !p_node )
+		{
+			return false;
+		}
+
+		p_node->parent = p_candidate->parent;
+		p_node->hash   = p_candidate->hash;
+		p_node->state  = p_candidate->state;
+
+		if( pbfs_visit( p_pbfs, p_node ) )
+		{
+			p_worker->spare = NULL;
+			p_worker->next[ p_worker->next_size++ ] = p_node;
+
+			if( p_pbfs->end && pbfs_is_end( p_pbfs, p_node->state ) )
+			{
+				/* only one node per state is ever inserted */
+				p_pbfs->node_path = p_node;
+			}
+		}
+		else
+		{
+			p_worker->spare = p_node;
+		}
+	}
+
+	p_worker->candidates_size = 0;
+	return true;
+}
+
+/*
+ * Start the next level with the nodes every thread inserted.
+ */
+static bool pbfs_next_level( pbfs_t* p_pbfs )
+{
+	size_t size = 0;
+	size_t i;
+
+	for( i = 0; i < p_pbfs->num_running; i++ )
+	{
+		size += p_pbfs->workers[ i ].next_size;
+	}
+
+	if( !storage_reserve( (void**) &p_pbfs->frontier, &p_pbfs->frontier_capacity, 0, size, sizeof(pbfs_node_t*), p_pbfs->alloc, p_pbfs->free ) ||
+	    !storage_reserve( (void**) &p_pbfs->level_sizes, &p_pbfs->levels_capacity, p_pbfs->levels, p_pbfs->levels + 1, sizeof(size_t), p_pbfs->alloc, p_pbfs->free ) )
+	{
+		return false;
+	}
+
+	p_pbfs->frontier_size = 0;
+	p_pbfs->frontier_next = 0;
+
+	for( i = 0; i < p_pbfs->num_running; i++ )
+	{
+		if( p_pbfs->workers[ i ].next_size > 0 )
+		{
+			memcpy( p_pbfs->frontier + p_pbfs->frontier_size, p_pbfs->workers[ i ].next, sizeof(pbfs_node_t*) * p_pbfs->workers[ i ].next_size );
+			p_pbfs->frontier_size += p_pbfs->workers[ i ].next_size;
+		}
+	}
+
+	if( size > 0 )
+	{
+		p_pbfs->visited_size += size;
+		p_pbfs->level_sizes[ p_pbfs->levels++ ] = size;
+	}
+
+	return true;
+}
+
+/*
+ * True if any thread failed to allocate since the last barrier.
+ * Only the last thread at a barrier calls this, and only it writes
+ * done, so every thread sees the same done after the next barrier.
+ */
+static bool pbfs_any_failed( const pbfs_t* p_pbfs )
+{
+	size_t i;
+
+	for( i = 0; i < p_pbfs->num_running; i++ )
+	{
+		if( p_pbfs->workers[ i ].failed )
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void* pbfs_run( void* p_arg )
+{
+	pbfs_worker_t* p_worker = (pbfs_worker_t*) p_arg;
+	pbfs_t* p_pbfs          = p_worker->p_pbfs;
+
+	for( ;; )
+	{
+		/* a.) Expand the frontier into per-thread candidates. */
+		p_worker->failed = !pbfs_expand( p_worker );
+
+		/* b.) Make room in the visited set for every candidate. */
+		if( pbfs_barrier_wait( &p_pbfs->barrier ) )
+		{
+			size_t count = 0;
+			size_t i;
+
+			for( i = 0; i < p_pbfs->num_running; i++ )
+			{
+				count += p_pbfs->workers[ i ].candidates_size;
+			}
+
+			p_pbfs->done = pbfs_any_failed( p_pbfs ) || !pbfs_visited_reserve( p_pbfs, count );
+		}
+		pbfs_barrier_wait( &p_pbfs->barrier );
+
+		/* c.) Insert the candidates that were not visited yet. */
+		if( !p_pbfs->done )
+		{
+			p_worker->failed = !pbfs_insert( p_worker );
+		}
+
+		/* d.) Stop at the goal or when no new state was reached. */
+		if( pbfs_barrier_wait( &p_pbfs->barrier ) && !p_pbfs->done )
+		{
+			p_pbfs->done = pbfs_any_failed( p_pbfs ) || !pbfs_next_level( p_pbfs ) || p_pbfs->node_path || p_pbfs->frontier_size == 0;
+		}
+		pbfs_barrier_wait( &p_pbfs->barrier );
+
+		if( p_pbfs->done )
+		{
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Parallel Breadth First Search Algorithm
+ * ------------------------------------------------------------------------
+ *   Input: The start node and goal nodes.
+ *  Output: True if goal node is found, false if goal node cannot be found
+ *          from the start node.
+ * ------------------------------------------------------------------------
+ * 1.) Set the visited set to hold only the start node, and make the
+ *     start node the frontier.
+ * 2.) While the frontier is not empty, do the following on every thread:
+ *        a.) Get the successors of the frontier nodes.
+ *        b.) Grow the visited set to fit all of them.
+ *        c.) Add each successor that was not visited to the visited
+ *            set and to the next frontier.
+ *        d.) If the goal node was added, return true. Otherwise the
+ *            next frontier becomes the frontier.
+ * 3.) Return false.
+ *
+ * With end set to NULL, every state reachable from start is visited
+ * and pbfs_level_size() tells how many states are at each depth.
+ */
+bool pbfs_find( pbfs_t* __restrict p_pbfs, const void* __restrict start, const void* __restrict end )
+{
+	pbfs_node_t* p_node;
+	size_t i;
+
+	#ifdef DEBUG_PARALLEL_BREADTH_FIRST_SEARCH
+	bench_mark_start( p_pbfs->bm );
+	#endif
+
+ 	/* 1.) Set the visited set to hold only the start node. */
+	pbfs_cleanup( p_pbfs );
+	p_pbfs->end = end;
+
+	p_node         = (pbfs_node_t*) arena_alloc( &p_pbfs->workers[ 0 ].nodes, sizeof(pbfs_node_t) );
+
+	if( !p_node )
+	{
+		return false;
+	}
+
+	p_node->parent = NULL;
+	p_node->hash   = p_pbfs->state_hasher( start );
+	p_node->state  = start;
+
+	if( !storage_reserve( (void**) &p_pbfs->workers[ 0 ].next, &p_pbfs->workers[ 0 ].next_capacity, 0, 1, sizeof(pbfs_node_t*), p_pbfs->alloc, p_pbfs->free ) )
+	{
+		return false;
+	}
+
+	pbfs_visit( p_pbfs, p_node );
+	p_pbfs->workers[ 0 ].next[ 0 ] = p_node;
+	p_pbfs->workers[ 0 ].next_size = 1;
+
+	if( !pbfs_next_level( p_pbfs ) )
+	{
+		return false;
+	}
+
+	if( end && pbfs_is_end( p_pbfs, start ) )
+	{
+		p_pbfs->node_path = p_node;
+	}
+	else
+	{
+		/* 2.) Expand one level at a time on every thread. */
+		p_pbfs->num_running = 1;
+
+		/* Threads that already started wait at the first barrier
+		 * until we know how many of them there are.
+		 */
+		pthread_mutex_lock( &p_pbfs->barrier.lock );
+		for( i = 1; i < p_pbfs->num_workers; i++ )
+		{
+			if( pthread_create( &p_pbfs->workers[ i ].thread, NULL, pbfs_run, &p_pbfs->workers[ i ] ) != 0 )
+			{
+				break;
+			}
+
+			p_pbfs->num_running++;
+		}
+		p_pbfs->barrier.count = p_pbfs->num_running;
+		pthread_mutex_unlock( &p_pbfs->barrier.lock );
+
+		pbfs_run( &p_pbfs->workers[ 0 ] );
+
+		for( i = 1; i < p_pbfs->num_running; i++ )
+		{
+			pthread_join( p_pbfs->workers[ i ].thread, NULL );
+		}
+	}
+
+	#ifdef DEBUG_PARALLEL_BREADTH_FIRST_SEARCH
+	bench_mark_end( p_pbfs->bm );
+	bench_mark_report( p_pbfs->bm );
+	#endif
+
+ 	/* 3.) Return false if the goal was not reached. */
+	return p_pbfs->node_path != NULL;
+}
+
+void pbfs_cleanup( pbfs_t* p_pbfs )
+{
+	size_t i;
+
+	for( i = 0; i < p_pbfs->num_workers; i++ )
+	{
+		pbfs_worker_t* p_worker = &p_pbfs->workers[ i ];
+
+		successors_release_states( &p_worker->successors );
+		p_worker->spare           = NULL;
+		p_worker->candidates_size = 0;
+		p_worker->next_size       = 0;
+		p_worker->failed          = false;
+
+		/* release every node at once */
+		arena_reset( &p_worker->nodes );
+	}
+
+	memset( p_pbfs->visited, 0, sizeof(pbfs_node_t*) * (p_pbfs->visited_mask + 1) );
+	p_pbfs->visited_size  = 0;
+	p_pbfs->frontier_size = 0;
+	p_pbfs->frontier_next = 0;
+	p_pbfs->levels        = 0;
+	p_pbfs->node_path     = NULL;
+	p_pbfs->end           = NULL;
+	p_pbfs->done          = false;
+	p_pbfs->num_running   = 1;
+	p_pbfs->barrier.count = 1;
+}
+
+pbfs_node_t* pbfs_first_node( const pbfs_t* p_pbfs )
+{
+	assert( p_pbfs );
+	return p_pbfs->node_path;
+}
+
+const void* pbfs_state( const pbfs_node_t* p_node )
+{
+	assert( p_node );
+	return p_node->state;
+}
+
+pbfs_node_t* pbfs_next_node( const pbfs_node_t* p_node )
+{
+	assert( p_node );
+	return p_node->parent;
+}
+
+size_t pbfs_levels( const pbfs_t* p_pbfs )
+{
+	assert( p_pbfs );
+	return p_pbfs->levels;
+}
+
+size_t pbfs_level_size( const pbfs_t* p_pbfs, size_t level )
+{
+	assert( p_pbfs );
+	return level < p_pbfs->levels ? p_pbfs->level_sizes[ level ] : 0;
+}
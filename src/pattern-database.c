@@ -0,0 +1,412 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include "heuristics.h"
+
+#define PDB_MAX_CELLS    64
+#define PDB_UNSET        0xFF
+#define pdb_bit( cell )  (((uint64_t) 1) << (cell))
+
+#if defined(__GNUC__)
+#define pdb_lowest_cell( mask )  ((size_t) __builtin_ctzll( mask ))
+#else
+static __inline size_t pdb_lowest_cell( uint64_t mask ) { size_t c = 0; while( !(mask & 1) ) { mask >>= 1; c++; } return c; }
+#endif
+
+struct pattern_database {
+	alloc_fxn_t alloc;
+	free_fxn_t  free;
+
+	size_t width;
+	size_t height;
+	size_t cells; /* width * height */
+	uint64_t board_mask; /* every cell */
+	uint64_t not_left; /* every cell but the first column */
+	uint64_t not_right; /* every cell but the last column */
+	size_t pattern_size; /* number of tiles in the pattern */
+	int    pattern[ PDB_MAX_CELLS ]; /* tile values in the pattern */
+	size_t entries; /* cells! / (cells - pattern_size)! */
+	unsigned char* table; /* moves to the goal, by pattern rank */
+};
+
+/*
+ * One breadth-first level of abstract puzzle states. A state is
+ * rank * cells + region: the rank of the pattern tile positions,
+ * and the lowest cell of the region the blank can reach without
+ * moving a pattern tile.
+ */
+typedef struct pdb_queue {
+	uint64_t* states;
+	size_t    size;
+	size_t    capacity;
+} pdb_queue_t;
+
+
+/*
+ * Perfect hash of the pattern tile positions. The positions are a
+ * k-permutation of the cells; each position is numbered among the
+ * cells not taken by the tiles before it, which gives a mixed
+ * radix number in [0, entries).
+ */
+static size_t pdb_rank( const pdb_t* __restrict p_pdb, const unsigned char* __restrict positions )
+{
+	size_t rank = 0;
+	size_t i, j;
+
+	for( i = 0; i < p_pdb->pattern_size; i++ )
+	{
+		size_t digit = positions[ i ];
+
+		for( j = 0; j < i; j++ )
+		{
+			digit -= positions[ j ] < positions[ i ];
+		}
+
+		rank = rank * (p_pdb->cells - i) + digit;
+	}
+
+	return rank;
+}
+
+static void pdb_unrank( const pdb_t* __restrict p_pdb, size_t rank, unsigned char* __restrict positions )
+{
+	size_t digits[ PDB_MAX_CELLS ];
+	uint64_t used = 0;
+	size_t i;
+
+	for( i = p_pdb->pattern_size; i > 0; i-- )
+	{
+		size_t radix   = p_pdb->cells - (i - 1);
+		digits[ i - 1 ] = rank % radix;
+		rank           /= radix;
+	}
+
+	for( i = 0; i < p_pdb->pattern_size; i++ )
+	{
+		uint64_t unused = p_pdb->board_mask & ~used;
+		size_t count    = digits[ i ];
+
+		/* drop the lowest digit unused cells */
+		while( count-- > 0 )
+		{
+			unused &= unused - 1;
+		}
+
+		positions[ i ] = (unsigned char) pdb_lowest_cell( unused );
+		used          |= pdb_bit( positions[ i ] );
+	}
+}
+
+/*
+ * Flood fill the free cells reachable from cell, a whole board
+ * at a time. Returns a bit mask of the region.
+ */
+static uint64_t pdb_region( const pdb_t* __restrict p_pdb, uint64_t occupied, size_t cell )
+{
+	uint64_t free_cells = p_pdb->board_mask & ~occupied;
+	uint64_t region     = pdb_bit( cell );
+	uint64_t grown;
+
+	for( ;; )
+	{
+		grown = region |
+		        ((region & p_pdb->not_right) << 1) |
+		        ((region & p_pdb->not_left) >> 1) |
+		        (region << p_pdb->width) |
+		        (region >> p_pdb->width);
+		grown &= free_cells;
+
+		if( grown == region )
+		{
+			return region;
+		}
+
+		region = grown;
+	}
+}
+
+static bool pdb_queue_push( pdb_t* __restrict p_pdb, pdb_queue_t* __restrict p_queue, uint64_t state )
+{
+	if( p_queue->size >= p_queue->capacity )
+	{
+		size_t capacity   = p_queue->capacity ? 2 * p_queue->capacity : 1024;
+		uint64_t* states  = (uint64_t*) p_pdb->alloc( sizeof(uint64_t) * capacity );
+
+		if( !states )
+		{
+			return false;
+		}
+
+		if( p_queue->states )
+		{
+			memcpy( states, p_queue->states, sizeof(uint64_t) * p_queue->size );
+			p_pdb->free( p_queue->states );
+		}
+
+		p_queue->states   = states;
+		p_queue->capacity = capacity;
+	}
+
+	p_queue->states[ p_queue->size++ ] = state;
+	return true;
+}
+
+/*
+ * Backward breadth-first search from the goal over the abstract
+ * puzzle, where every tile outside of the pattern is replaced by a
+ * blank. Only moves of pattern tiles are counted, so the distances
+ * of disjoint patterns can be added together.
+ */
+static bool pdb_build( pdb_t* __restrict p_pdb, const int* __restrict goal )
+{
+	unsigned char positions[ PDB_MAX_CELLS ];
+	pdb_queue_t levels[ 2 ] = { { NULL, 0, 0 }, { NULL, 0, 0 } };
+	uint64_t* visited; /* one bit per (rank, blank region) */
+	size_t visited_words = (p_pdb->entries * p_pdb->cells + 63) / 64;
+	uint64_t occupied    = 0;
+	size_t blank         = p_pdb->cells;
+	unsigned int depth   = 0;
+	bool result          = true;
+	size_t i, j;
+
+	for( i = 0; i < p_pdb->cells; i++ )
+	{
+		if( goal[ i ] == 0 )
+		{
+			blank = i;
+		}
+
+		for( j = 0; j < p_pdb->pattern_size; j++ )
+		{
+			if( goal[ i ] == p_pdb->pattern[ j ] )
+			{
+				positions[ j ] = (unsigned char) i;
+				occupied      |= pdb_bit( i );
+			}
+		}
+	}
+
+	assert( blank < p_pdb->cells );
+
+	visited = (uint64_t*) p_pdb->alloc( sizeof(uint64_t) * visited_words );
+	if( !visited )
+	{
+		return false;
+	}
+
+	memset( visited, 0, sizeof(uint64_t) * visited_words );
+	memset( p_pdb->table, PDB_UNSET, p_pdb->entries );
+
+	{
+		size_t rank   = pdb_rank( p_pdb, positions );
+		size_t region = pdb_lowest_cell( pdb_region( p_pdb, occupied, blank ) );
+		uint64_t s    = (uint64_t) rank * p_pdb->cells + region;
+
+		visited[ s >> 6 ] |= pdb_bit( s & 63 );
+		p_pdb->table[ rank ] = 0;
+		result = pdb_queue_push( p_pdb, &levels[ 0 ], s );
+	}
+
+	while( result && levels[ depth & 1 ].size > 0 )
+	{
+		pdb_queue_t* current = &levels[ depth & 1 ];
+		pdb_queue_t* next    = &levels[ (depth + 1) & 1 ];
+
+		for( i = 0; result && i < current->size; i++ )
+		{
+			uint64_t s      = current->states[ i ];
+			size_t rank     = (size_t) (s / p_pdb->cells);
+			size_t start    = (size_t) (s % p_pdb->cells);
+			uint64_t region;
+			size_t t;
+
+			pdb_unrank( p_pdb, rank, positions );
+
+			occupied = 0;
+			for( t = 0; t < p_pdb->pattern_size; t++ )
+			{
+				occupied |= pdb_bit( positions[ t ] );
+			}
+
+			region = pdb_region( p_pdb, occupied, start );
+
+			/* Move every pattern tile next to the blank region into it. */
+			for( t = 0; result && t < p_pdb->pattern_size; t++ )
+			{
+				size_t from = positions[ t ];
+				size_t x    = from % p_pdb->width;
+				size_t targets[ 4 ];
+				size_t count = 0;
+				size_t n;
+
+				if( x > 0 )                               targets[ count++ ] = from - 1;
+				if( x + 1 < p_pdb->width )                targets[ count++ ] = from + 1;
+				if( from >= p_pdb->width )                targets[ count++ ] = from - p_pdb->width;
+				if( from + p_pdb->width < p_pdb->cells )  targets[ count++ ] = from + p_pdb->width;
+
+				for( n = 0; result && n < count; n++ )
+				{
+					uint64_t moved;
+					size_t moved_rank;
+					uint64_t moved_s;
+
+					if( !(region & pdb_bit( targets[ n ] )) ) continue;
+
+					positions[ t ] = (unsigned char) targets[ n ];
+					moved          = (occupied & ~pdb_bit( from )) | pdb_bit( targets[ n ] );
+					moved_rank     = pdb_rank( p_pdb, positions );
+					moved_s        = (uint64_t) moved_rank * p_pdb->cells + pdb_lowest_cell( pdb_region( p_pdb, moved, from ) );
+					positions[ t ] = (unsigned char) from;
+
+					if( visited[ moved_s >> 6 ] & (pdb_bit( moved_s & 63 )) ) continue;
+					visited[ moved_s >> 6 ] |= pdb_bit( moved_s & 63 );
+
+					if( p_pdb->table[ moved_rank ] == PDB_UNSET )
+					{
+						p_pdb->table[ moved_rank ] = (unsigned char) (depth + 1);
+					}
+
+					result = pdb_queue_push( p_pdb, next, moved_s );
+				}
+			}
+		}
+
+		current->size = 0;
+		depth++;
+		assert( depth < PDB_UNSET );
+	}
+
+	if( levels[ 0 ].states ) p_pdb->free( levels[ 0 ].states );
+	if( levels[ 1 ].states ) p_pdb->free( levels[ 1 ].states );
+	p_pdb->free( visited );
+
+	return result;
+}
+
+pdb_t* pdb_create( size_t width, size_t height, const int* goal, const int* pattern, size_t pattern_size, alloc_fxn_t alloc, free_fxn_t free )
+{
+	pdb_t* p_pdb;
+	size_t i;
+	assert( width > 0 && height > 0 );
+	assert( width * height <= PDB_MAX_CELLS );
+	assert( goal );
+	assert( pattern && pattern_size > 0 && pattern_size < width * height );
+
+	p_pdb = (pdb_t*) alloc( sizeof(pdb_t) );
+
+	if( p_pdb )
+	{
+		p_pdb->alloc        = alloc;
+		p_pdb->free         = free;
+		p_pdb->width        = width;
+		p_pdb->height       = height;
+		p_pdb->cells        = width * height;
+		p_pdb->pattern_size = pattern_size;
+		p_pdb->entries      = 1;
+		p_pdb->board_mask   = p_pdb->cells == 64 ? ~(uint64_t) 0 : pdb_bit( p_pdb->cells ) - 1;
+		p_pdb->not_left     = p_pdb->board_mask;
+		p_pdb->not_right    = p_pdb->board_mask;
+
+		for( i = 0; i < height; i++ )
+		{
+			p_pdb->not_left  &= ~pdb_bit( i * width );
+			p_pdb->not_right &= ~pdb_bit( i * width + width - 1 );
+		}
+
+		for( i = 0; i < pattern_size; i++ )
+		{
+			assert( pattern[ i ] != 0 );
+			p_pdb->pattern[ i ] = pattern[ i ];
+			p_pdb->entries     *= p_pdb->cells - i;
+		}
+
+		p_pdb->table = (unsigned char*) alloc( p_pdb->entries );
+
+		if( !p_pdb->table || !pdb_build( p_pdb, goal ) )
+		{
+			pdb_destroy( &p_pdb );
+		}
+	}
+
+	return p_pdb;
+}
+
+void pdb_destroy( pdb_t** p_pdb )
+{
+	if( p_pdb && *p_pdb )
+	{
+		free_fxn_t _free = (*p_pdb)->free;
+
+		if( (*p_pdb)->table )
+		{
+			_free( (*p_pdb)->table );
+		}
+
+		_free( *p_pdb );
+		*p_pdb = NULL;
+	}
+}
+
+size_t pdb_size( const pdb_t* p_pdb )
+{
+	assert( p_pdb );
+	return p_pdb->entries;
+}
+
+unsigned int pdb_lookup( const pdb_t* __restrict p_pdb, const int* __restrict board )
+{
+	unsigned char where[ PDB_MAX_CELLS ];
+	unsigned char positions[ PDB_MAX_CELLS ];
+	size_t i;
+
+	assert( p_pdb );
+	assert( board );
+
+	for( i = 0; i < p_pdb->cells; i++ )
+	{
+		where[ board[ i ] ] = (unsigned char) i;
+	}
+
+	for( i = 0; i < p_pdb->pattern_size; i++ )
+	{
+		positions[ i ] = where[ p_pdb->pattern[ i ] ];
+	}
+
+	return p_pdb->table[ pdb_rank( p_pdb, positions ) ];
+}
+
+unsigned int pdb_additive_lookup( const pdb_t* const* __restrict p_pdbs, size_t count, const int* __restrict board )
+{
+	unsigned int sum = 0;
+	size_t i;
+
+	for( i = 0; i < count; i++ )
+	{
+		sum += pdb_lookup( p_pdbs[ i ], board );
+	}
+
+	return sum;
+}
@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "radix-heap.h"
+#include "storage.h"
+
+static __inline size_t* radix_heap_slot( const radix_heap_t* __restrict p_heap, void* __restrict element )
+{
+	return (size_t*) ((unsigned char*) element + p_heap->index_offset);
+}
+
+/*
+ * The bucket for a key is one more than the position of the
+ * highest bit where it differs from the last key popped.
+ */
+static __inline size_t radix_heap_bucket( const radix_heap_t* p_heap, unsigned int key )
+{
+	unsigned int diff = key ^ p_heap->last_key;
+	size_t bucket     = 0;
+
+	#if defined(__GNUC__)
+	if( diff )
+	{
+		bucket = sizeof(unsigned int) * CHAR_BIT - __builtin_clz( diff );
+	}
+	#else
+	while( diff )
+	{
+		diff >>= 1;
+		bucket++;
+	}
+	#endif
+
+	return bucket;
+}
+
+static __inline bool radix_bucket_reserve( radix_heap_t* __restrict p_heap, radix_bucket_t* __restrict p_bucket, size_t count )
+{
+	return storage_reserve( (void**) &p_bucket->array, &p_bucket->capacity, p_bucket->size, count, sizeof(radix_entry_t), p_heap->alloc, p_heap->free );
+}
+
+static bool radix_bucket_append( radix_heap_t* __restrict p_heap, radix_bucket_t* __restrict p_bucket, void* __restrict element, unsigned int key )
+{
+	if( !radix_bucket_reserve( p_heap, p_bucket, p_bucket->size + 1 ) )
+	{
+		return false;
+	}
+
+	*radix_heap_slot( p_heap, element ) = p_bucket->size;
+	p_bucket->array[ p_bucket->size ].key     = key;
+	p_bucket->array[ p_bucket->size ].element = element;
+	p_bucket->size++;
+	return true;
+}
+
+void radix_heap_create( radix_heap_t* p_heap, size_t index_offset, alloc_fxn_t alloc, free_fxn_t free )
+{
+	assert( p_heap );
+
+	p_heap->index_offset = index_offset;
+	p_heap->size         = 0;
+	p_heap->last_key     = 0;
+	p_heap->alloc        = alloc;
+	p_heap->free         = free;
+	memset( p_heap->buckets, 0, sizeof(p_heap->buckets) );
+}
+
+void radix_heap_destroy( radix_heap_t* p_heap )
+{
+	size_t i;
+	assert( p_heap );
+
+	for( i = 0; i < RADIX_HEAP_BUCKETS; i++ )
+	{
+		if( p_heap->buckets[ i ].array )
+		{
+			p_heap->free( p_heap->buckets[ i ].array );
+		}
+	}
+
+	#ifdef _DEBUG_RADIX_HEAP
+	memset( p_heap->buckets, 0, sizeof(p_heap->buckets) );
+	p_heap->size = 0;
+	#endif
+}
+
+bool radix_heap_push( radix_heap_t* __restrict p_heap, void* __restrict element, unsigned int key ) /* O(1) */
+{
+	assert( p_heap );
+	assert( key >= p_heap->last_key );
+
+	if( !radix_bucket_append( p_heap, &p_heap->buckets[ radix_heap_bucket( p_heap, key ) ], element, key ) )
+	{
+		return false;
+	}
+
+	p_heap->size++;
+	return true;
+}
+
+void* radix_heap_pop( radix_heap_t* p_heap ) /* O(lg C) amortized */
+{
+	radix_bucket_t* p_bucket = &p_heap->buckets[ 0 ];
+	assert( p_heap );
+	assert( radix_heap_size(p_heap) > 0 );
+
+	if( p_bucket->size == 0 )
+	{
+		radix_bucket_t* p_source;
+		size_t counts[ RADIX_HEAP_BUCKETS ];
+		unsigned int last_key = p_heap->last_key;
+		unsigned int min_key;
+		size_t source;
+		size_t i;
+
+		/* find the first non-empty bucket and its smallest key */
+		for( source = 1; p_heap->buckets[ source ].size == 0; source++ )
+		{
+			assert( source + 1 < RADIX_HEAP_BUCKETS );
+		}
+
+		p_source = &p_heap->buckets[ source ];
+		min_key  = p_source->array[ 0 ].key;
+
+		for( i = 1; i < p_source->size; i++ )
+		{
+			if( p_source->array[ i ].key < min_key )
+			{
+				min_key = p_source->array[ i ].key;
+			}
+		}
+
+		/* every key in the source bucket moves to a lower bucket */
+		p_heap->last_key = min_key;
+
+		/* make room in those buckets first, so running out of
+		 * memory leaves the heap as it was
+		 */
+		memset( counts, 0, sizeof(size_t) * source );
+
+		for( i = 0; i < p_source->size; i++ )
+		{
+			counts[ radix_heap_bucket( p_heap, p_source->array[ i ].key ) ]++;
+		}
+
+		for( i = 0; i < source; i++ )
+		{
+			if( counts[ i ] > 0 && !radix_bucket_reserve( p_heap, &p_heap->buckets[ i ], p_heap->buckets[ i ].size + counts[ i ] ) )
+			{
+				p_heap->last_key = last_key;
+				return NULL;
+			}
+		}
+
+		for( i = 0; i < p_source->size; i++ )
+		{
+			radix_entry_t* p_entry = &p_source->array[ i ];
+			radix_bucket_append( p_heap, &p_heap->buckets[ radix_heap_bucket( p_heap, p_entry->key ) ], p_entry->element, p_entry->key );
+		}
+
+		p_source->size = 0;
+	}
+
+	p_heap->size--;
+	return p_bucket->array[ --p_bucket->size ].element;
+}
+
+/*
+ * Move an element that is already in the heap from the bucket
+ * for old_key to the bucket for new_key.
+ */
+bool radix_heap_update( radix_heap_t* __restrict p_heap, void* __restrict element, unsigned int old_key, unsigned int new_key ) /* O(1) */
+{
+	radix_bucket_t* p_bucket;
+	size_t index;
+	assert( p_heap );
+
+	p_bucket = &p_heap->buckets[ radix_heap_bucket( p_heap, old_key ) ];
+	index    = *radix_heap_slot( p_heap, element );
+	assert( index < p_bucket->size && p_bucket->array[ index ].element == element );
+
+	/* fill the hole with the last entry of the bucket */
+	if( index < --p_bucket->size )
+	{
+		p_bucket->array[ index ] = p_bucket->array[ p_bucket->size ];
+		*radix_heap_slot( p_heap, p_bucket->array[ index ].element ) = index;
+	}
+
+	p_heap->size--;
+	return radix_heap_push( p_heap, element, new_key );
+}
+
+void radix_heap_clear( radix_heap_t* p_heap )
+{
+	size_t i;
+	assert( p_heap );
+
+	for( i = 0; i < RADIX_HEAP_BUCKETS; i++ )
+	{
+		p_heap->buckets[ i ].size = 0;
+	}
+
+	p_heap->size     = 0;
+	p_heap->last_key = 0;
+}
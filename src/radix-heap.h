@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _RADIX_HEAP_H_
+#define _RADIX_HEAP_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <limits.h>
+#include <stddef.h>
+#include "csearch.h"
+
+/*
+ * A radix heap of pointers keyed by unsigned integers. It only
+ * works when keys never go below the last key popped, which is
+ * always the case in Dijkstra's algorithm because edge costs are
+ * nonnegative.
+ *
+ * Bucket 0 holds the keys equal to the last key popped and bucket
+ * i holds the keys whose highest bit that differs from it is bit
+ * i - 1. When bucket 0 runs out, the smallest key of the first
+ * non-empty bucket becomes the last key popped and that bucket is
+ * spread over the buckets below it. An element can only move down
+ * a bucket at a time, so operations are O(lg C) amortized, where
+ * C is the largest key, and no compare function is called.
+ *
+ * Like the indexed heap, every element reserves a size_t field
+ * that the heap keeps up to date with the element's position in
+ * its bucket.
+ *
+ * radix_heap_pop() returns NULL, and leaves the heap as it was,
+ * when the buckets it spreads elements over cannot grow.
+ */
+#define RADIX_HEAP_BUCKETS   (sizeof(unsigned int) * CHAR_BIT + 1)
+
+typedef struct radix_entry {
+	unsigned int key;
+	void* element;
+} radix_entry_t;
+
+typedef struct radix_bucket {
+	radix_entry_t* array;
+	size_t size;
+	size_t capacity;
+} radix_bucket_t;
+
+typedef struct radix_heap {
+	size_t index_offset; /* offset of the size_t position field in an element */
+	size_t size;
+	unsigned int last_key; /* the last key popped */
+	radix_bucket_t buckets[ RADIX_HEAP_BUCKETS ];
+
+	alloc_fxn_t alloc;
+	free_fxn_t  free;
+} radix_heap_t;
+
+void  radix_heap_create  ( radix_heap_t* p_heap, size_t index_offset, alloc_fxn_t alloc, free_fxn_t free );
+void  radix_heap_destroy ( radix_heap_t* p_heap );
+bool  radix_heap_push    ( radix_heap_t* __restrict p_heap, void* __restrict element, unsigned int key ); /* O(1) */
+void* radix_heap_pop     ( radix_heap_t* p_heap ); /* O(lg C) amortized */
+bool  radix_heap_update  ( radix_heap_t* __restrict p_heap, void* __restrict element, unsigned int old_key, unsigned int new_key ); /* O(1) */
+void  radix_heap_clear   ( radix_heap_t* p_heap );
+
+#define radix_heap_size( p_heap )      ((p_heap)->size)
+#define radix_heap_is_empty( p_heap )  ((p_heap)->size <= 0)
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _RADIX_HEAP_H_ */
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "ring-buffer.h"
+
+bool ring_buffer_create( ring_buffer_t* p_ring, size_t capacity, alloc_fxn_t alloc, free_fxn_t free )
+{
+	size_t count = 1;
+	assert( p_ring );
+
+	/* round up to a power of two */
+	while( count < capacity )
+	{
+		count *= 2;
+	}
+
+	p_ring->array = alloc( sizeof(void*) * count );
+	p_ring->head  = 0;
+	p_ring->size  = 0;
+	p_ring->mask  = count - 1;
+	p_ring->alloc = alloc;
+	p_ring->free  = free;
+
+	return p_ring->array != NULL;
+}
+
+void ring_buffer_destroy( ring_buffer_t* p_ring )
+{
+	assert( p_ring );
+
+	if( p_ring->array )
+	{
+		p_ring->free( p_ring->array );
+		p_ring->array = NULL;
+	}
+
+	p_ring->head = 0;
+	p_ring->size = 0;
+	p_ring->mask = 0;
+}
+
+/*
+ * Double the capacity. The elements are copied to the start of
+ * the new array in order, so the front is at index 0 afterwards.
+ */
+static bool ring_buffer_grow( ring_buffer_t* p_ring )
+{
+	size_t capacity = p_ring->mask + 1;
+	size_t first    = capacity - p_ring->head; /* elements before the array wraps */
+	void** new_array = p_ring->alloc( sizeof(void*) * 2 * capacity );
+
+	if( !new_array )
+	{
+		return false;
+	}
+
+	if( first > p_ring->size )
+	{
+		first = p_ring->size;
+	}
+
+	memcpy( new_array, p_ring->array + p_ring->head, sizeof(void*) * first );
+	memcpy( new_array + first, p_ring->array, sizeof(void*) * (p_ring->size - first) );
+
+	p_ring->free( p_ring->array );
+	p_ring->array = new_array;
+	p_ring->head  = 0;
+	p_ring->mask  = 2 * capacity - 1;
+	return true;
+}
+
+bool ring_buffer_push_back( ring_buffer_t* __restrict p_ring, void* __restrict element )
+{
+	assert( p_ring );
+
+	if( p_ring->size > p_ring->mask && !ring_buffer_grow( p_ring ) )
+	{
+		return false;
+	}
+
+	p_ring->array[ (p_ring->head + p_ring->size) & p_ring->mask ] = element;
+	p_ring->size++;
+	return true;
+}
+
+void* ring_buffer_pop_front( ring_buffer_t* p_ring )
+{
+	void* element;
+	assert( p_ring );
+	assert( p_ring->size > 0 );
+
+	element      = p_ring->array[ p_ring->head ];
+	p_ring->head = (p_ring->head + 1) & p_ring->mask;
+	p_ring->size--;
+	return element;
+}
+
+void* ring_buffer_pop_back( ring_buffer_t* p_ring )
+{
+	assert( p_ring );
+	assert( p_ring->size > 0 );
+
+	p_ring->size--;
+	return p_ring->array[ (p_ring->head + p_ring->size) & p_ring->mask ];
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _RING_BUFFER_H_
+#define _RING_BUFFER_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include "csearch.h"
+
+/*
+ * A growable ring buffer of pointers in one contiguous array.
+ * Elements are pushed at the back and popped from the front, as a
+ * FIFO queue, or from the back, as a LIFO stack. The capacity is a
+ * power of two and doubles when the buffer is full. Clearing keeps
+ * the array, so a buffer that is reused across searches stops
+ * allocating once it has grown to the largest frontier.
+ */
+typedef struct ring_buffer {
+	void** array;
+	size_t head; /* index of the front element */
+	size_t size;
+	size_t mask; /* capacity - 1 */
+
+	alloc_fxn_t alloc;
+	free_fxn_t  free;
+} ring_buffer_t;
+
+bool  ring_buffer_create    ( ring_buffer_t* p_ring, size_t capacity, alloc_fxn_t alloc, free_fxn_t free );
+void  ring_buffer_destroy   ( ring_buffer_t* p_ring );
+bool  ring_buffer_push_back ( ring_buffer_t* __restrict p_ring, void* __restrict element ); /* O(1) amortized */
+void* ring_buffer_pop_front ( ring_buffer_t* p_ring ); /* O(1) */
+void* ring_buffer_pop_back  ( ring_buffer_t* p_ring ); /* O(1) */
+
+#define ring_buffer_clear( p_ring )      ((p_ring)->head = 0, (p_ring)->size = 0)
+#define ring_buffer_size( p_ring )       ((p_ring)->size)
+#define ring_buffer_is_empty( p_ring )   ((p_ring)->size <= 0)
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _RING_BUFFER_H_ */
@@ -0,0 +1,307 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "csearch.h"
+#include "arena.h"
+
+#define STATE_POOL_BLOCK_SIZE        (64 * 1024)
+#define STATE_POOL_INITIAL_BITS      (10) /* 1024 entries */
+
+/*
+ * The hash of a state's bytes is built a word at a time, and the
+ * home entry is taken from the high bits of the hash times the
+ * golden ratio, like in the state table.
+ */
+#if SIZE_MAX > 0xFFFFFFFF
+#define state_pool_multiplier        ((size_t) 0x517CC1B727220A95ULL)
+#define state_pool_mix( hash )       ((hash) * (size_t) 0x9E3779B97F4A7C15ULL)
+#else
+#define state_pool_multiplier        ((size_t) 0x27220A95UL)
+#define state_pool_mix( hash )       ((hash) * (size_t) 0x9E3779B9UL)
+#endif
+#define state_pool_rotate( hash )    (((hash) << 5) | ((hash) >> (8 * sizeof(size_t) - 5)))
+
+typedef struct state_pool_entry {
+	size_t hash;
+	const void* state; /* NULL when the entry is empty */
+} state_pool_entry_t;
+
+struct state_pool {
+	alloc_fxn_t alloc;
+	free_fxn_t  free;
+
+	size_t state_size;
+	arena_t blocks; /* states are packed back to back in blocks */
+	unsigned char* top; /* next free state in the current block */
+	unsigned char* limit; /* end of the current block */
+
+	size_t size;
+	size_t mask; /* number of entries - 1 */
+	unsigned int shift; /* bits of a mixed hash that are not part of an entry's index */
+	state_pool_entry_t* entries;
+};
+
+
+static __inline size_t state_pool_hash( const state_pool_t* __restrict p_pool, const void* __restrict state )
+{
+	const unsigned char* bytes = state;
+	size_t remaining           = p_pool->state_size;
+	size_t hash                = 0;
+	size_t word;
+
+	while( remaining >= sizeof(size_t) )
+	{
+		memcpy( &word, bytes, sizeof(size_t) );
+		hash = (state_pool_rotate( hash ) ^ word) * state_pool_multiplier;
+		bytes     += sizeof(size_t);
+		remaining -= sizeof(size_t);
+	}
+
+	if( remaining > 0 )
+	{
+		word = 0;
+		memcpy( &word, bytes, remaining );
+		hash = (state_pool_rotate( hash ) ^ word) * state_pool_multiplier;
+	}
+
+	return hash;
+}
+
+static __inline size_t state_pool_home( const state_pool_t* p_pool, size_t hash )
+{
+	return state_pool_mix( hash ) >> p_pool->shift;
+}
+
+/*
+ * The entry holding an equal state, or the empty entry where the
+ * state would go.
+ */
+static __inline size_t state_pool_slot( const state_pool_t* __restrict p_pool, const void* __restrict state, size_t hash )
+{
+	size_t i = state_pool_home( p_pool, hash );
+
+	while( p_pool->entries[ i ].state )
+	{
+		if( p_pool->entries[ i ].state == state ||
+		    (p_pool->entries[ i ].hash == hash && memcmp( p_pool->entries[ i ].state, state, p_pool->state_size ) == 0) )
+		{
+			break;
+		}
+
+		i = (i + 1) & p_pool->mask;
+	}
+
+	return i;
+}
+
+static bool state_pool_grow( state_pool_t* p_pool )
+{
+	state_pool_entry_t* old_entries = p_pool->entries;
+	size_t old_count                = p_pool->mask + 1;
+	size_t new_count                = 2 * old_count;
+	size_t i;
+
+	p_pool->entries = p_pool->alloc( sizeof(state_pool_entry_t) * new_count );
+
+	if( !p_pool->entries )
+	{
+		p_pool->entries = old_entries;
+		return false;
+	}
+
+	memset( p_pool->entries, 0, sizeof(state_pool_entry_t) * new_count );
+	p_pool->mask = new_count - 1;
+	p_pool->shift--;
+
+	for( i = 0; i < old_count; i++ )
+	{
+		if( old_entries[ i ].state )
+		{
+			size_t j = state_pool_home( p_pool, old_entries[ i ].hash );
+
+			while( p_pool->entries[ j ].state )
+			{
+				j = (j + 1) & p_pool->mask;
+			}
+
+			p_pool->entries[ j ] = old_entries[ i ];
+		}
+	}
+
+	p_pool->free( old_entries );
+	return true;
+}
+
+/*
+ * Copy a state to the end of the current block. States are not
+ * padded, so a pool of N states uses N * state_size bytes plus
+ * its entries.
+ */
+static __inline void* state_pool_store( state_pool_t* __restrict p_pool, const void* __restrict state )
+{
+	void* copy;
+
+	if( (size_t) (p_pool->limit - p_pool->top) < p_pool->state_size )
+	{
+		size_t block_size = p_pool->state_size > STATE_POOL_BLOCK_SIZE ? p_pool->state_size : STATE_POOL_BLOCK_SIZE;
+
+		/* the tail of the previous block is too small and is skipped */
+		p_pool->top = arena_alloc( &p_pool->blocks, block_size );
+
+		if( !p_pool->top )
+		{
+			p_pool->limit = NULL;
+			return NULL;
+		}
+
+		p_pool->limit = p_pool->top + block_size;
+	}
+
+	copy = p_pool->top;
+	memcpy( copy, state, p_pool->state_size );
+	p_pool->top += p_pool->state_size;
+	return copy;
+}
+
+state_pool_t* state_pool_create( size_t state_size, alloc_fxn_t alloc, free_fxn_t free )
+{
+	size_t count = ((size_t) 1) << STATE_POOL_INITIAL_BITS;
+	state_pool_t* p_pool;
+	assert( state_size > 0 );
+
+	p_pool = alloc( sizeof(state_pool_t) );
+
+	if( p_pool )
+	{
+		p_pool->alloc      = alloc;
+		p_pool->free       = free;
+		p_pool->state_size = state_size;
+		p_pool->top        = NULL;
+		p_pool->limit      = NULL;
+		p_pool->size       = 0;
+		p_pool->mask       = count - 1;
+		p_pool->shift      = 8 * sizeof(size_t) - STATE_POOL_INITIAL_BITS;
+		p_pool->entries    = alloc( sizeof(state_pool_entry_t) * count );
+
+		if( !p_pool->entries )
+		{
+			free( p_pool );
+			return NULL;
+		}
+
+		memset( p_pool->entries, 0, sizeof(state_pool_entry_t) * count );
+		arena_create( &p_pool->blocks, STATE_POOL_BLOCK_SIZE, alloc, free );
+	}
+
+	return p_pool;
+}
+
+void state_pool_destroy( state_pool_t** p_pool )
+{
+	if( p_pool && *p_pool )
+	{
+		free_fxn_t _free = (*p_pool)->free;
+
+		arena_destroy( &(*p_pool)->blocks );
+		_free( (*p_pool)->entries );
+		_free( *p_pool );
+		*p_pool = NULL;
+	}
+}
+
+const void* state_pool_intern( state_pool_t* __restrict p_pool, const void* __restrict state ) /* O(1) expected */
+{
+	size_t hash;
+	size_t i;
+	const void* copy;
+	assert( p_pool );
+	assert( state );
+
+	/* keep the entries at most half full */
+	if( 2 * (p_pool->size + 1) > p_pool->mask + 1 && !state_pool_grow( p_pool ) )
+	{
+		return NULL;
+	}
+
+	hash = state_pool_hash( p_pool, state );
+	i    = state_pool_slot( p_pool, state, hash );
+
+	if( p_pool->entries[ i ].state )
+	{
+		return p_pool->entries[ i ].state;
+	}
+
+	copy = state_pool_store( p_pool, state );
+
+	if( copy )
+	{
+		p_pool->entries[ i ].hash  = hash;
+		p_pool->entries[ i ].state = copy;
+		p_pool->size++;
+	}
+
+	return copy;
+}
+
+const void* state_pool_find( const state_pool_t* __restrict p_pool, const void* __restrict state ) /* O(1) expected */
+{
+	size_t i;
+	assert( p_pool );
+	assert( state );
+
+	i = state_pool_slot( p_pool, state, state_pool_hash( p_pool, state ) );
+	return p_pool->entries[ i ].state;
+}
+
+size_t state_pool_size( const state_pool_t* p_pool )
+{
+	assert( p_pool );
+	return p_pool->size;
+}
+
+size_t state_pool_state_size( const state_pool_t* p_pool )
+{
+	assert( p_pool );
+	return p_pool->state_size;
+}
+
+/*
+ * Forget every state at once. The blocks and entries are kept, so
+ * interning the same number of states again does not allocate.
+ */
+void state_pool_clear( state_pool_t* p_pool )
+{
+	assert( p_pool );
+
+	if( p_pool->size > 0 )
+	{
+		memset( p_pool->entries, 0, sizeof(state_pool_entry_t) * (p_pool->mask + 1) );
+		p_pool->size = 0;
+	}
+
+	arena_reset( &p_pool->blocks );
+	p_pool->top   = NULL;
+	p_pool->limit = NULL;
+}
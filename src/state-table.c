@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "state-table.h"
+
+/*
+ * Fibonacci hashing spreads out the low quality hashes that are
+ * common for states, like pointers divided by the state size.
+ */
+#if SIZE_MAX > 0xFFFFFFFF
+#define state_table_mix( hash )   ((hash) * (size_t) 0x9E3779B97F4A7C15ULL)
+#else
+#define state_table_mix( hash )   ((hash) * (size_t) 0x9E3779B9UL)
+#endif
+
+static __inline const void* state_table_state( const state_table_t* __restrict p_table, const void* __restrict node )
+{
+	return *(const void* const*) ((const unsigned char*) node + p_table->state_offset);
+}
+
+static __inline bool state_table_equal( const state_table_t* __restrict p_table, const void* __restrict node, const void* __restrict state )
+{
+	const void* node_state = state_table_state( p_table, node );
+	return node_state == state || (p_table->compare && p_table->compare( node_state, state ) == 0);
+}
+
+static __inline size_t state_table_home( const state_table_t* p_table, size_t hash )
+{
+	/* the high bits of the mixed hash are the best ones */
+	return state_table_mix( hash ) >> p_table->shift;
+}
+
+/*
+ * Put a node that is known not to be in the table into the first
+ * empty entry of its probe sequence.
+ */
+static __inline void state_table_place( state_table_t* __restrict p_table, size_t hash, void* __restrict node )
+{
+	size_t i = state_table_home( p_table, hash );
+
+	while( p_table->entries[ i ].node )
+	{
+		i = (i + 1) & p_table->mask;
+	}
+
+	p_table->entries[ i ].hash = hash;
+	p_table->entries[ i ].node = node;
+}
+
+static bool state_table_grow( state_table_t* p_table )
+{
+	state_table_entry_t* old_entries = p_table->entries;
+	size_t old_count                 = p_table->mask + 1;
+	size_t new_count                 = 2 * old_count;
+	size_t i;
+
+	p_table->entries = p_table->alloc( sizeof(state_table_entry_t) * new_count );
+
+	if( !p_table->entries )
+	{
+		p_table->entries = old_entries;
+		return false;
+	}
+
+	memset( p_table->entries, 0, sizeof(state_table_entry_t) * new_count );
+	p_table->mask = new_count - 1;
+	p_table->shift--;
+
+	for( i = 0; i < old_count; i++ )
+	{
+		if( old_entries[ i ].node )
+		{
+			state_table_place( p_table, old_entries[ i ].hash, old_entries[ i ].node );
+		}
+	}
+
+	p_table->free( old_entries );
+	return true;
+}
+
+bool state_table_create( state_table_t* p_table, size_t capacity, size_t state_offset, state_hash_fxn_t hash, compare_fxn_t compare, alloc_fxn_t alloc, free_fxn_t free )
+{
+	size_t count = 16;
+	unsigned int shift = 8 * sizeof(size_t) - 4;
+	assert( p_table );
+	assert( hash );
+
+	/* room for capacity nodes at half load, rounded up to a power of two */
+	while( count < 2 * capacity )
+	{
+		count *= 2;
+		shift--;
+	}
+
+	p_table->hash         = hash;
+	p_table->compare      = compare;
+	p_table->state_offset = state_offset;
+	p_table->mask         = count - 1;
+	p_table->shift        = shift;
+	p_table->size         = 0;
+	p_table->alloc        = alloc;
+	p_table->free         = free;
+	p_table->entries      = p_table->alloc( sizeof(state_table_entry_t) * count );
+
+	assert( p_table->entries );
+	if( p_table->entries )
+	{
+		memset( p_table->entries, 0, sizeof(state_table_entry_t) * count );
+	}
+
+	return p_table->entries != NULL;
+}
+
+void state_table_destroy( state_table_t* p_table )
+{
+	assert( p_table );
+	p_table->free( p_table->entries );
+
+	#ifdef _DEBUG_STATE_TABLE
+	p_table->entries = NULL;
+	p_table->mask    = 0;
+	p_table->size    = 0;
+	#endif
+}
+
+void* state_table_find( const state_table_t* __restrict p_table, const void* __restrict state ) /* O(1) expected */
+{
+	size_t hash = p_table->hash( state );
+	size_t i    = state_table_home( p_table, hash );
+
+	while( p_table->entries[ i ].node )
+	{
+		if( p_table->entries[ i ].hash == hash &&
+		    state_table_equal( p_table, p_table->entries[ i ].node, state ) )
+		{
+			return p_table->entries[ i ].node;
+		}
+
+		i = (i + 1) & p_table->mask;
+	}
+
+	return NULL;
+}
+
+bool state_table_insert( state_table_t* __restrict p_table, void* __restrict node ) /* O(1) amortized */
+{
+	assert( p_table );
+	assert( node );
+	assert( !state_table_find( p_table, state_table_state( p_table, node ) ) );
+
+	/* keep the table at most half full */
+	if( 2 * (p_table->size + 1) > p_table->mask + 1 && !state_table_grow( p_table ) )
+	{
+		return false;
+	}
+
+	state_table_place( p_table, p_table->hash( state_table_state( p_table, node ) ), node );
+	p_table->size++;
+	return true;
+}
+
+state_table_entry_t* state_table_probe( state_table_t* __restrict p_table, const void* __restrict state ) /* O(1) amortized */
+{
+	size_t hash;
+	size_t i;
+	assert( p_table );
+
+	/* keep room for the node that may be filled in */
+	if( 2 * (p_table->size + 1) > p_table->mask + 1 && !state_table_grow( p_table ) )
+	{
+		return NULL;
+	}
+
+	hash = p_table->hash( state );
+	i    = state_table_home( p_table, hash );
+
+	while( p_table->entries[ i ].node )
+	{
+		if( p_table->entries[ i ].hash == hash &&
+		    state_table_equal( p_table, p_table->entries[ i ].node, state ) )
+		{
+			break;
+		}
+
+		i = (i + 1) & p_table->mask;
+	}
+
+	/* an empty entry keeps the hash for state_table_fill() */
+	p_table->entries[ i ].hash = hash;
+	return &p_table->entries[ i ];
+}
+
+void state_table_clear( state_table_t* p_table )
+{
+	assert( p_table );
+
+	if( p_table->size > 0 )
+	{
+		memset( p_table->entries, 0, sizeof(state_table_entry_t) * (p_table->mask + 1) );
+		p_table->size = 0;
+	}
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _STATE_TABLE_H_
+#define _STATE_TABLE_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include "csearch.h"
+
+/*
+ * An open-addressing hash table from states to search nodes with
+ * linear probing. Each entry caches the state's hash next to the
+ * node pointer, so most probes that miss never touch the node.
+ * The state is read out of the node at state_offset. States are
+ * equal when their pointers are equal or, with the same hash,
+ * when the compare function returns 0. Comparing contents is what
+ * lets a search find a state it reached before through a copy,
+ * like a state made with successors_emplace().
+ *
+ * Nodes are never removed during a search; the whole table is
+ * cleared at once between searches. The table doubles when it is
+ * half full.
+ */
+typedef struct state_table_entry {
+	size_t hash;
+	void*  node; /* NULL when the entry is empty */
+} state_table_entry_t;
+
+typedef struct state_table {
+	state_hash_fxn_t hash;
+	compare_fxn_t compare; /* NULL to compare pointers only */
+	size_t state_offset; /* offset of the const void* state field in a node */
+	size_t mask; /* number of entries - 1 */
+	unsigned int shift; /* bits of a mixed hash that are not part of an entry's index */
+	size_t size;
+	state_table_entry_t* entries;
+
+	alloc_fxn_t alloc;
+	free_fxn_t  free;
+} state_table_t;
+
+#define STATE_TABLE_DEFAULT_CAPACITY   (1024)
+
+bool  state_table_create  ( state_table_t* p_table, size_t capacity, size_t state_offset, state_hash_fxn_t hash, compare_fxn_t compare, alloc_fxn_t alloc, free_fxn_t free );
+void  state_table_destroy ( state_table_t* p_table );
+void* state_table_find    ( const state_table_t* __restrict p_table, const void* __restrict state ); /* O(1) expected */
+bool  state_table_insert  ( state_table_t* __restrict p_table, void* __restrict node ); /* O(1) amortized */
+state_table_entry_t* state_table_probe ( state_table_t* __restrict p_table, const void* __restrict state ); /* O(1) amortized */
+void  state_table_clear   ( state_table_t* p_table );
+
+#define state_table_size( p_table )   ((p_table)->size)
+
+/*
+ * state_table_probe() finds a state and the place it would be
+ * inserted with one hash and one probe sequence. It returns the
+ * state's entry, or an empty entry when the state is not in the
+ * table (NULL if the table could not grow). Fill an empty entry
+ * before the next call on the same table.
+ */
+#define state_table_fill( p_table, p_entry, p_node )   ((p_entry)->node = (p_node), (p_table)->size++)
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _STATE_TABLE_H_ */
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "storage.h"
+
+bool storage_reserve( void** p_array, size_t* p_capacity, size_t size, size_t count, size_t element_size, alloc_fxn_t alloc, free_fxn_t free )
+{
+	assert( size <= *p_capacity );
+
+	if( count > *p_capacity )
+	{
+		size_t new_capacity = *p_capacity < 16 ? 16 : *p_capacity;
+		void* new_array;
+
+		while( new_capacity < count )
+		{
+			new_capacity *= 2;
+		}
+
+		new_array = alloc( element_size * new_capacity );
+
+		if( !new_array )
+		{
+			return false;
+		}
+
+		if( *p_array )
+		{
+			memcpy( new_array, *p_array, element_size * size );
+			free( *p_array );
+		}
+
+		*p_array    = new_array;
+		*p_capacity = new_capacity;
+	}
+
+	return true;
+}
+
+void storage_header_init( storage_file_header_t* p_header, const char* magic, uint32_t version )
+{
+	assert( p_header );
+	assert( strlen( magic ) == sizeof(p_header->magic) );
+
+	memcpy( p_header->magic, magic, sizeof(p_header->magic) );
+	p_header->version    = version;
+	p_header->byte_order = STORAGE_FILE_BYTE_ORDER;
+}
+
+bool storage_header_is_valid( const storage_file_header_t* p_header, const char* magic, uint32_t version )
+{
+	assert( p_header );
+
+	return memcmp( p_header->magic, magic, sizeof(p_header->magic) ) == 0 &&
+	       p_header->version == version &&
+	       p_header->byte_order == STORAGE_FILE_BYTE_ORDER;
+}
+
+bool storage_save( const char* __restrict filename, const void* __restrict header, size_t header_size, const storage_section_t* __restrict sections, size_t count )
+{
+	static const unsigned char padding[ STORAGE_FILE_DATA_OFFSET ];
+	bool result;
+	size_t i;
+	FILE* file;
+	assert( filename );
+	assert( header_size >= sizeof(storage_file_header_t) && header_size <= STORAGE_FILE_DATA_OFFSET );
+
+	file = fopen( filename, "wb" );
+
+	if( !file )
+	{
+		return false;
+	}
+
+	result = fwrite( header, header_size, 1, file ) == 1 &&
+	         fwrite( padding, STORAGE_FILE_DATA_OFFSET - header_size, 1, file ) == 1;
+
+	for( i = 0; result && i < count; i++ )
+	{
+		result = sections[ i ].size == 0 || fwrite( sections[ i ].data, sections[ i ].size, 1, file ) == 1;
+	}
+
+	return fclose( file ) == 0 && result;
+}
+
+/*
+ * Map a whole file that is at least large enough for its header.
+ * Returns NULL if the file cannot be opened or mapped.
+ */
+void* storage_map( const char* __restrict filename, size_t* __restrict p_size )
+{
+	struct stat info;
+	void* mapping;
+	int fd;
+	assert( filename );
+	assert( p_size );
+
+	fd = open( filename, O_RDONLY );
+
+	if( fd < 0 )
+	{
+		return NULL;
+	}
+
+	if( fstat( fd, &info ) != 0 || (size_t) info.st_size < STORAGE_FILE_DATA_OFFSET )
+	{
+		close( fd );
+		return NULL;
+	}
+
+	mapping = mmap( NULL, (size_t) info.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+	close( fd );
+
+	if( mapping == MAP_FAILED )
+	{
+		return NULL;
+	}
+
+	*p_size = (size_t) info.st_size;
+	return mapping;
+}
+
+void storage_unmap( void* mapping, size_t size )
+{
+	munmap( mapping, size );
+}
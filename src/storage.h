@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2012 Joseph A. Marrero.  http://www.manvscode.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _STORAGE_H_
+#define _STORAGE_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "csearch.h"
+
+/*
+ * Growable arrays. storage_reserve() makes room for at least count
+ * elements of element_size bytes in *p_array, keeping the first
+ * size of them. The capacity at least doubles each time, so
+ * appending one element at a time is O(1) amortized.
+ */
+bool storage_reserve ( void** p_array, size_t* p_capacity, size_t size, size_t count, size_t element_size, alloc_fxn_t alloc, free_fxn_t free );
+
+/*
+ * Precomputed tables saved to files. A file starts with a header
+ * whose first member is a storage_file_header_t, padded to
+ * STORAGE_FILE_DATA_OFFSET, followed by the table's arrays exactly
+ * as they are laid out in memory. The arrays start on a page
+ * boundary, so a loaded table is used in place: the file is mapped
+ * read-only and shared, processes that load the same file share
+ * its pages, and a page is only read from disk when a lookup first
+ * touches it. Files are only read on machines with the same byte
+ * order as the one that saved them.
+ */
+#define STORAGE_FILE_DATA_OFFSET   4096
+#define STORAGE_FILE_BYTE_ORDER    0x01020304
+
+typedef struct storage_file_header {
+	char     magic[ 8 ];
+	uint32_t version;
+	uint32_t byte_order; /* STORAGE_FILE_BYTE_ORDER as the saving machine stores it */
+} storage_file_header_t;
+
+typedef struct storage_section {
+	const void* data;
+	size_t      size; /* bytes */
+} storage_section_t;
+
+void  storage_header_init     ( storage_file_header_t* p_header, const char* magic, uint32_t version );
+bool  storage_header_is_valid ( const storage_file_header_t* p_header, const char* magic, uint32_t version );
+bool  storage_save            ( const char* __restrict filename, const void* __restrict header, size_t header_size, const storage_section_t* __restrict sections, size_t count );
+void* storage_map             ( const char* __restrict filename, size_t* __restrict p_size );
+void  storage_unmap           ( void* mapping, size_t size );
+
+#define storage_data( mapping )   ((unsigned char*) (mapping) + STORAGE_FILE_DATA_OFFSET)
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _STORAGE_H_ */
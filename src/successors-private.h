@@ -29,11 +29,15 @@ extern "C" {
 #include <stddef.h>
 #include <string.h>
 #include <collections/alloc.h>
+#include "arena.h"
 #include "csearch.h"
 
 /*
  * successors - A growable array of states.
- * successors does not own the states.
+ * successors does not own the states, except for the ones made
+ * with successors_emplace(). Those live in an arena until the
+ * search releases them, and a state that turned out to be a
+ * duplicate can be reclaimed and reused by the next emplace.
  */
 struct successors {
 	alloc_fxn_t alloc;
@@ -42,10 +46,17 @@ struct successors {
 	size_t size;
 
 	void** array;
+	unsigned char* emplaced; /* emplaced[ i ] is set when array[ i ] came from successors_emplace() */
+
+	arena_t states; /* storage for emplaced states */
+	void*   free_states; /* reclaimed states, linked through their first bytes */
+	size_t  state_size; /* size of every emplaced state */
 };
 
-bool successors_create  ( successors_t *p_successors, size_t size, alloc_fxn_t alloc, free_fxn_t free );
-void successors_destroy ( successors_t *p_successors );
+bool successors_create         ( successors_t *p_successors, size_t size, alloc_fxn_t alloc, free_fxn_t free );
+void successors_destroy        ( successors_t *p_successors );
+void successors_reclaim        ( successors_t *p_successors, size_t index ); /* O(1) */
+void successors_release_states ( successors_t *p_successors ); /* O(1) */
 
 #define successors_array( p_successors )       ((p_successors)->array)
 #define successors_array_size( p_successors )  ((p_successors)->array_size)
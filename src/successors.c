@@ -28,21 +28,38 @@
 
 /*
  * successors - A growable array of states.
- * successors does not own the states.
+ * successors does not own the states, except for emplaced ones.
  */
 bool successors_create( successors_t* p_successors, size_t size, alloc_fxn_t alloc, free_fxn_t free )
 {
 	assert( p_successors );
 
-	p_successors->array_size = size;
-	p_successors->size       = 0L;
-	p_successors->alloc      = alloc;
-	p_successors->free       = free;
-	p_successors->array      = p_successors->alloc( sizeof(void *) * successors_array_size(p_successors) );
+	if( size < 1 )
+	{
+		size = 1;
+	}
 
-	assert( p_successors->array );
+	p_successors->array_size  = size;
+	p_successors->size        = 0L;
+	p_successors->alloc       = alloc;
+	p_successors->free        = free;
+	p_successors->array       = p_successors->alloc( sizeof(void *) * successors_array_size(p_successors) );
+	p_successors->emplaced    = p_successors->alloc( sizeof(unsigned char) * successors_array_size(p_successors) );
+	p_successors->free_states = NULL;
+	p_successors->state_size  = 0;
+	arena_create( &p_successors->states, 4096, alloc, free );
+
+	if( !p_successors->array || !p_successors->emplaced )
+	{
+		if( p_successors->array )    p_successors->free( p_successors->array );
+		if( p_successors->emplaced ) p_successors->free( p_successors->emplaced );
+		p_successors->array      = NULL;
+		p_successors->emplaced   = NULL;
+		p_successors->array_size = 0L;
+		return false;
+	}
 
-	return p_successors->array != NULL;
+	return true;
 }
 
 void successors_destroy( successors_t* p_successors )
@@ -54,7 +71,9 @@ void successors_destroy( successors_t* p_successors )
 		successors_pop( p_successors );
 	}
 
-	p_successors->free( p_successors->array );
+	if( p_successors->array )    p_successors->free( p_successors->array );
+	if( p_successors->emplaced ) p_successors->free( p_successors->emplaced );
+	arena_destroy( &p_successors->states );
 
 	#ifdef _DEBUG_VECTOR
 	p_successors->array      = NULL;
@@ -63,22 +82,131 @@ void successors_destroy( successors_t* p_successors )
 	#endif
 }
 
+/*
+ * Move the states and their emplaced flags to arrays of new_size
+ * elements, using the allocator the successors were created with.
+ */
+static bool successors_reallocate( successors_t* p_successors, size_t new_size )
+{
+	void** new_array             = p_successors->alloc( sizeof(void*) * new_size );
+	unsigned char* new_emplaced  = p_successors->alloc( sizeof(unsigned char) * new_size );
+
+	if( !new_array || !new_emplaced )
+	{
+		if( new_array )    p_successors->free( new_array );
+		if( new_emplaced ) p_successors->free( new_emplaced );
+		return false;
+	}
+
+	/* the arrays are NULL if successors_create() failed */
+	if( p_successors->array )
+	{
+		memcpy( new_array, p_successors->array, sizeof(void*) * successors_size(p_successors) );
+		memcpy( new_emplaced, p_successors->emplaced, sizeof(unsigned char) * successors_size(p_successors) );
+		p_successors->free( p_successors->array );
+		p_successors->free( p_successors->emplaced );
+	}
+
+	p_successors->array      = new_array;
+	p_successors->emplaced   = new_emplaced;
+	p_successors->array_size = new_size;
+	return true;
+}
+
 bool successors_push( successors_t* __restrict p_successors, const void* __restrict state )
 {
 	assert( p_successors );
 
 	/* grow the array if needed */
-	if( successors_size(p_successors) >= successors_array_size(p_successors) )
+	if( successors_size(p_successors) >= successors_array_size(p_successors) &&
+	    !successors_reallocate( p_successors, 1.5 * p_successors->array_size + 1 ) )
+	{
+		return false;
+	}
+
+	p_successors->emplaced[ p_successors->size ] = 0;
+	p_successors->array[ p_successors->size++ ]  = (void*) state;
+
+	return true;
+}
+
+/*
+ * Add a successor whose state is stored by the successors. The
+ * returned buffer of size bytes is the new successor's state and
+ * is filled in by the caller. It stays valid until the search is
+ * cleaned up, or until the search reclaims it because an equal
+ * state had already been reached. Every emplaced state in a search
+ * must have the same size. Returns NULL when out of memory.
+ */
+void* successors_emplace( successors_t* __restrict p_successors, size_t size )
+{
+	void* state;
+	assert( p_successors );
+	assert( size > 0 );
+	assert( p_successors->state_size == 0 || p_successors->state_size == size );
+
+	p_successors->state_size = size;
+
+	if( p_successors->free_states )
+	{
+		state = p_successors->free_states;
+		p_successors->free_states = *(void**) state;
+	}
+	else
 	{
-		size_t new_size          = 1.5 * p_successors->array_size + 1;
-		p_successors->array_size = new_size;
-		p_successors->array      = realloc( p_successors->array, sizeof(void*) * successors_array_size(p_successors) );
-		assert( p_successors->array );
+		/* a reclaimed state has to hold the free list link */
+		state = arena_alloc( &p_successors->states, size < sizeof(void*) ? sizeof(void*) : size );
+
+		if( !state )
+		{
+			return NULL;
+		}
 	}
 
-	p_successors->array[ p_successors->size++ ] = (void*) state;
+	if( !successors_push( p_successors, state ) )
+	{
+		*(void**) state = p_successors->free_states;
+		p_successors->free_states = state;
+		return NULL;
+	}
 
-	return p_successors->array != NULL;
+	p_successors->emplaced[ p_successors->size - 1 ] = 1;
+	return state;
+}
+
+/*
+ * Give an emplaced state back for reuse. Searches call this for
+ * successors that were already reached, after their last use of
+ * the state. Other states are left alone.
+ */
+void successors_reclaim( successors_t* p_successors, size_t index )
+{
+	assert( p_successors );
+	assert( index < successors_size(p_successors) );
+
+	if( p_successors->emplaced[ index ] )
+	{
+		void* state = p_successors->array[ index ];
+
+		*(void**) state = p_successors->free_states;
+		p_successors->free_states = state;
+		p_successors->emplaced[ index ] = 0;
+	}
+}
+
+/*
+ * Clear the successors and release every emplaced state at once.
+ * Searches call this when they are cleaned up, once no node refers
+ * to the states anymore.
+ */
+void successors_release_states( successors_t* p_successors )
+{
+	assert( p_successors );
+
+	successors_clear( p_successors );
+	p_successors->free_states = NULL;
+	p_successors->state_size  = 0;
+	arena_reset( &p_successors->states );
 }
 
 bool successors_pop( successors_t* p_successors )
@@ -89,6 +217,8 @@ bool successors_pop( successors_t* p_successors )
 
 	if( p_successors->size > 0 )
 	{
+		/* a popped state is no longer needed */
+		successors_reclaim( p_successors, p_successors->size - 1 );
 		p_successors->size--;
 		result = true;
 	}
@@ -107,11 +237,7 @@ bool successors_resize( successors_t* p_successors, size_t new_size )
 			successors_pop( p_successors );
 		}
 
-		p_successors->array_size = new_size;
-		p_successors->array      = realloc( p_successors->array, sizeof(void*) * successors_array_size(p_successors) );
-		assert( p_successors->array );
-
-		result = p_successors->array != NULL;
+		result = successors_reallocate( p_successors, new_size > 0 ? new_size : 1 );
 	}
 
 	return result;